@@ -0,0 +1,162 @@
+
+/**
+ * Created by K. Suwatchai (Mobizt)
+ *
+ * Email: suwatchai@outlook.com
+ *
+ * Github: https://github.com/mobizt
+ *
+ * Copyright (c) 2025 mobizt
+ *
+ */
+
+// This example shows how to measure the library response reading and JSON processing
+// on device without network by replaying the recorded HTTP responses with the mock client (ReplayClient).
+
+// The recorded responses are in Recorded.h, replace them with the responses that captured from your application
+// to get the numbers that matched your workload.
+
+#include <Arduino.h>
+
+#include <ESP_Google_Sheet_Client.h>
+#include <GS_Helper.h>
+
+#include "ReplayClient.h"
+#include "Recorded.h"
+
+#define BENCHMARK_ITERATIONS 100
+
+ReplayClient client;
+
+MB_FS mbfs;
+
+MB_String payload;
+
+MB_String batchGetBody;
+
+// Read the response from client in the same way as GAuthManager::handleResponse.
+int readResponse(const char *data, size_t len, MB_String &payload)
+{
+    client.setResponse(data, len);
+    payload.clear();
+
+    esp_google_sheet_server_response_data_t response;
+    esp_google_sheet_tcp_response_handler_t tcpHandler;
+
+    tcpHandler.client = &client;
+    tcpHandler.defaultChunkSize = 2048;
+    tcpHandler.chunkBufSize = tcpHandler.defaultChunkSize;
+    tcpHandler.error.code = -1;
+    tcpHandler.dataTime = millis();
+
+    char *pChunk = MemoryHelper::createBuffer<char *>(&mbfs, tcpHandler.chunkBufSize + 1);
+
+    bool complete = false;
+
+    while (tcpHandler.available() > 0 && !complete)
+    {
+        if (!HttpHelper::readStatusLine(&mbfs, &client, tcpHandler, response))
+        {
+            if (tcpHandler.isHeader)
+            {
+                if (HttpHelper::readHeader(&mbfs, &client, tcpHandler, response) && Utils::isNoContent(&response))
+                    break;
+            }
+            else
+            {
+                memset(pChunk, 0, tcpHandler.chunkBufSize + 1);
+
+                if (response.isChunkedEnc)
+                    tcpHandler.bufferAvailable = HttpHelper::readChunkedData(&mbfs, &client, pChunk, nullptr, tcpHandler);
+                else
+                    tcpHandler.bufferAvailable = HttpHelper::readLine(&client, pChunk, tcpHandler.chunkBufSize);
+
+                if (tcpHandler.bufferAvailable > 0)
+                {
+                    tcpHandler.payloadRead += tcpHandler.bufferAvailable;
+                    payload += pChunk;
+                }
+
+                if (Utils::isChunkComplete(&tcpHandler, &response, complete) ||
+                    Utils::isResponseComplete(&tcpHandler, &response, complete))
+                    break;
+            }
+        }
+    }
+
+    MemoryHelper::freeBuffer(&mbfs, pChunk);
+
+    return response.httpCode;
+}
+
+void benchReadChunked()
+{
+    readResponse(recorded_batch_get_response, strlen_P(recorded_batch_get_response), payload);
+}
+
+void benchReadContentLength()
+{
+    readResponse(recorded_token_response, strlen_P(recorded_token_response), payload);
+}
+
+void benchJsonParse()
+{
+    FirebaseJson json;
+    FirebaseJsonData result;
+    json.setJsonData(batchGetBody.c_str());
+    json.get(result, "valueRanges/[0]/values/[19]/[4]");
+}
+
+void benchJsonSerialize()
+{
+    static FirebaseJson json;
+    if (json.size() == 0)
+        json.setJsonData(batchGetBody.c_str());
+
+    MB_String out;
+    json.toString(out);
+}
+
+void runBenchmark(const char *name, void (*func)(void), int iterations)
+{
+    // Warm up
+    func();
+
+    int heap = GSheet.getFreeHeap();
+    unsigned long total = 0, best = 0xFFFFFFFF;
+
+    for (int i = 0; i < iterations; i++)
+    {
+        unsigned long us = micros();
+        func();
+        us = micros() - us;
+        total += us;
+        if (us < best)
+            best = us;
+    }
+
+    GSheet.printf("%-24s avg %8lu us, min %8lu us, heap diff %6d bytes\n", name, total / iterations, best, heap - GSheet.getFreeHeap());
+}
+
+void setup()
+{
+
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println();
+
+    GSheet.printf("ESP Google Sheet Client v%s\n\n", ESP_GOOGLE_SHEET_CLIENT_VERSION);
+
+    int code = readResponse(recorded_batch_get_response, strlen_P(recorded_batch_get_response), batchGetBody);
+
+    GSheet.printf("Recorded response: HTTP %d, %d bytes payload\n\n", code, (int)batchGetBody.length());
+
+    runBenchmark("Read chunked response", benchReadChunked, BENCHMARK_ITERATIONS);
+    runBenchmark("Read sized response", benchReadContentLength, BENCHMARK_ITERATIONS);
+    runBenchmark("JSON parse", benchJsonParse, BENCHMARK_ITERATIONS);
+    runBenchmark("JSON serialize", benchJsonSerialize, BENCHMARK_ITERATIONS);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,269 @@
+/**
+ * Recorded HTTP responses that are replayed by ReplayClient.
+ *
+ * The values:batchGet response (chunked transfer encoding) and the OAuth2.0 token response (content length).
+ */
+
+#ifndef RECORDED_RESPONSES_H
+#define RECORDED_RESPONSES_H
+
+#include <Arduino.h>
+
+static const char recorded_batch_get_response[] PROGMEM =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: application/json; charset=UTF-8\r\n"
+    "Vary: Origin\r\n"
+    "Vary: X-Origin\r\n"
+    "Vary: Referer\r\n"
+    "Date: Sat, 17 Oct 2026 09:00:00 GMT\r\n"
+    "Server: ESF\r\n"
+    "Cache-Control: private\r\n"
+    "X-XSS-Protection: 0\r\n"
+    "X-Frame-Options: SAMEORIGIN\r\n"
+    "X-Content-Type-Options: nosniff\r\n"
+    "Alt-Svc: h3=\":443\"; ma=2592000\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "200\r\n"
+    "{\n"
+    "  \"spreadsheetId\": \"1aBcDeFgHiJkLmNoPqRsTuVwXyZ0123456789abcdef\",\n"
+    "  \"valueRanges\": [\n"
+    "    {\n"
+    "      \"range\": \"Sheet1!A1:E20\",\n"
+    "      \"majorDimension\": \"ROWS\",\n"
+    "      \"values\": [\n"
+    "        [\n"
+    "          \"3\",\n"
+    "          \"Item 0-1\",\n"
+    "          \"5\",\n"
+    "          \"Item 0-3\",\n"
+    "          \"7\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"6\",\n"
+    "          \"Item 1-1\",\n"
+    "          \"10\",\n"
+    "          \"Item 1-3\",\n"
+    "          \"14\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"9\",\n"
+    "          \"Item 2-1\",\n"
+    "          \"15\",\n"
+    "          \"Item 2-3\",\n"
+    "          \"21\"\n"
+    "        ],\n"
+    "      \r\n"
+    "200\r\n"
+    "  [\n"
+    "          \"12\",\n"
+    "          \"Item 3-1\",\n"
+    "          \"20\",\n"
+    "          \"Item 3-3\",\n"
+    "          \"28\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"15\",\n"
+    "          \"Item 4-1\",\n"
+    "          \"25\",\n"
+    "          \"Item 4-3\",\n"
+    "          \"35\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"18\",\n"
+    "          \"Item 5-1\",\n"
+    "          \"30\",\n"
+    "          \"Item 5-3\",\n"
+    "          \"42\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"21\",\n"
+    "          \"Item 6-1\",\n"
+    "          \"35\",\n"
+    "          \"Item 6-3\",\n"
+    "          \"49\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"24\",\n"
+    "          \"Item 7-1\",\n"
+    "          \"40\",\n"
+    "      \r\n"
+    "200\r\n"
+    "    \"Item 7-3\",\n"
+    "          \"56\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"27\",\n"
+    "          \"Item 8-1\",\n"
+    "          \"45\",\n"
+    "          \"Item 8-3\",\n"
+    "          \"63\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"30\",\n"
+    "          \"Item 9-1\",\n"
+    "          \"50\",\n"
+    "          \"Item 9-3\",\n"
+    "          \"70\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"33\",\n"
+    "          \"Item 10-1\",\n"
+    "          \"55\",\n"
+    "          \"Item 10-3\",\n"
+    "          \"77\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"36\",\n"
+    "          \"Item 11-1\",\n"
+    "          \"60\",\n"
+    "          \"Item 11-3\",\n"
+    "          \"84\"\n"
+    "        ],\n"
+    "        [\n"
+    "        \r\n"
+    "200\r\n"
+    "  \"39\",\n"
+    "          \"Item 12-1\",\n"
+    "          \"65\",\n"
+    "          \"Item 12-3\",\n"
+    "          \"91\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"42\",\n"
+    "          \"Item 13-1\",\n"
+    "          \"70\",\n"
+    "          \"Item 13-3\",\n"
+    "          \"98\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"45\",\n"
+    "          \"Item 14-1\",\n"
+    "          \"75\",\n"
+    "          \"Item 14-3\",\n"
+    "          \"105\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"48\",\n"
+    "          \"Item 15-1\",\n"
+    "          \"80\",\n"
+    "          \"Item 15-3\",\n"
+    "          \"112\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"51\",\n"
+    "          \"Item 16-1\",\n"
+    "          \"85\",\n"
+    "       \r\n"
+    "200\r\n"
+    "   \"Item 16-3\",\n"
+    "          \"119\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"54\",\n"
+    "          \"Item 17-1\",\n"
+    "          \"90\",\n"
+    "          \"Item 17-3\",\n"
+    "          \"126\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"57\",\n"
+    "          \"Item 18-1\",\n"
+    "          \"95\",\n"
+    "          \"Item 18-3\",\n"
+    "          \"133\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"60\",\n"
+    "          \"Item 19-1\",\n"
+    "          \"100\",\n"
+    "          \"Item 19-3\",\n"
+    "          \"140\"\n"
+    "        ]\n"
+    "      ]\n"
+    "    },\n"
+    "    {\n"
+    "      \"range\": \"Sheet1!G1:I10\",\n"
+    "      \"majorDimension\": \"ROWS\",\n"
+    "      \"values\": [\n"
+    "        [\n"
+    "          \"\r\n"
+    "200\r\n"
+    "3\",\n"
+    "          \"Item 0-1\",\n"
+    "          \"5\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"6\",\n"
+    "          \"Item 1-1\",\n"
+    "          \"10\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"9\",\n"
+    "          \"Item 2-1\",\n"
+    "          \"15\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"12\",\n"
+    "          \"Item 3-1\",\n"
+    "          \"20\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"15\",\n"
+    "          \"Item 4-1\",\n"
+    "          \"25\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"18\",\n"
+    "          \"Item 5-1\",\n"
+    "          \"30\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"21\",\n"
+    "          \"Item 6-1\",\n"
+    "          \"35\"\n"
+    "        ],\n"
+    "        [\n"
+    "         \r\n"
+    "dd\r\n"
+    " \"24\",\n"
+    "          \"Item 7-1\",\n"
+    "          \"40\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"27\",\n"
+    "          \"Item 8-1\",\n"
+    "          \"45\"\n"
+    "        ],\n"
+    "        [\n"
+    "          \"30\",\n"
+    "          \"Item 9-1\",\n"
+    "          \"50\"\n"
+    "        ]\n"
+    "      ]\n"
+    "    }\n"
+    "  ]\n"
+    "}\r\n"
+    "0\r\n"
+    "\r\n";
+
+static const char recorded_token_response[] PROGMEM =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: application/json; charset=utf-8\r\n"
+    "Date: Sat, 17 Oct 2026 09:00:00 GMT\r\n"
+    "Cache-Control: no-cache, no-store, max-age=0, must-revalidate\r\n"
+    "Content-Length: 980\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"
+    "{\"access_token\": \"ya29.c.b0Aaekm1Kxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\", \"expires_in\": 3599, \"token_type\": \"Bearer\"}";
+
+#endif
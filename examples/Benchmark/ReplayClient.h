@@ -0,0 +1,112 @@
+/**
+ * The Arduino Client that replays the recorded HTTP response without network.
+ *
+ * The data that written to this client is discarded and counted.
+ * The response data can be in flash (PROGMEM) or in RAM.
+ */
+
+#ifndef REPLAY_CLIENT_H
+#define REPLAY_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+class ReplayClient : public Client
+{
+public:
+    ReplayClient() {}
+    ~ReplayClient() {}
+
+    /**
+     * Set the response to replay.
+     * @param data The recorded response.
+     * @param len The length of response.
+     * @param progmem The response data is in flash (PROGMEM).
+     */
+    void setResponse(const char *data, size_t len, bool progmem = true)
+    {
+        _data = data;
+        _len = len;
+        _progmem = progmem;
+        rewind();
+    }
+
+    /**
+     * Replay the response from the beginning.
+     */
+    void rewind()
+    {
+        _pos = 0;
+        _written = 0;
+        _connected = true;
+    }
+
+    /**
+     * Get the number of bytes that were written (the request size).
+     */
+    size_t written() { return _written; }
+
+    int connect(IPAddress ip, uint16_t port)
+    {
+        rewind();
+        return 1;
+    }
+
+    int connect(const char *host, uint16_t port)
+    {
+        rewind();
+        return 1;
+    }
+
+    size_t write(uint8_t b) { return write(&b, 1); }
+
+    size_t write(const uint8_t *buf, size_t size)
+    {
+        _written += size;
+        return size;
+    }
+
+    int available() { return _connected ? _len - _pos : 0; }
+
+    int read()
+    {
+        if (available() == 0)
+            return -1;
+
+        return _progmem ? pgm_read_byte(_data + _pos++) : _data[_pos++];
+    }
+
+    int read(uint8_t *buf, size_t size)
+    {
+        size_t n = 0;
+        while (n < size && available() > 0)
+            buf[n++] = read();
+        return n;
+    }
+
+    int peek()
+    {
+        if (available() == 0)
+            return -1;
+
+        return _progmem ? pgm_read_byte(_data + _pos) : _data[_pos];
+    }
+
+    void flush() {}
+
+    void stop() { _connected = false; }
+
+    uint8_t connected() { return _connected; }
+
+    operator bool() { return _connected; }
+
+private:
+    const char *_data = nullptr;
+    size_t _len = 0;
+    size_t _pos = 0;
+    size_t _written = 0;
+    bool _progmem = true;
+    bool _connected = false;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef JSON_BENCHMARK_BASELINE_H
+#define JSON_BENCHMARK_BASELINE_H
+
+// The stored baseline in nanoseconds and allocations per iteration of each benchmark on your device.
+// The benchmark will be failed when the measured time is slower than the baseline by BASELINE_TOLERANCE_PERCENT
+// or when it allocates more than the baseline (the allocations are counted with MB_HEAP_ACCOUNTING build flag).
+// The benchmark that has no baseline (0 ns, -1 allocs) is not checked.
+
+// To update the baseline, copy the "{...}," lines from the benchmark output and paste them here.
+
+#include "Suite.h"
+
+#define BASELINE_TOLERANCE_PERCENT 20
+
+static const baseline_item_t baselines[] = {
+    {"values_get_1x1/parse", 0, -1},
+    {"values_get_1x1/print", 0, -1},
+    {"values_get_1x1/get", 0, -1},
+    {"values_get_1x1/iterate", 0, -1},
+    {"values_get_10x10/parse", 0, -1},
+    {"values_get_10x10/print", 0, -1},
+    {"values_get_10x10/get", 0, -1},
+    {"values_get_10x10/iterate", 0, -1},
+    {"values_get_50x8/parse", 0, -1},
+    {"values_get_50x8/print", 0, -1},
+    {"values_get_50x8/get", 0, -1},
+    {"values_get_50x8/iterate", 0, -1},
+    {"values_get_200x2/parse", 0, -1},
+    {"values_get_200x2/print", 0, -1},
+    {"values_get_200x2/get", 0, -1},
+    {"values_get_200x2/iterate", 0, -1},
+    {"spreadsheet_get_10x5/parse", 0, -1},
+    {"spreadsheet_get_10x5/print", 0, -1},
+    {"spreadsheet_get_10x5/get", 0, -1},
+    {"spreadsheet_get_10x5/iterate", 0, -1},
+    {"spreadsheet_get_40x5/parse", 0, -1},
+    {"spreadsheet_get_40x5/print", 0, -1},
+    {"spreadsheet_get_40x5/get", 0, -1},
+    {"spreadsheet_get_40x5/iterate", 0, -1},
+    {"list_files_20/parse", 0, -1},
+    {"list_files_20/print", 0, -1},
+    {"list_files_20/get", 0, -1},
+    {"list_files_20/iterate", 0, -1},
+    {"token/parse", 0, -1},
+    {"token/print", 0, -1},
+    {"token/get", 0, -1},
+    {"token/iterate", 0, -1},
+    {"array_add_100/add", 0, -1},
+    {"string/append_chunk", 0, -1},
+    {"string/append_char", 0, -1},
+    {"string/short_keys", 0, -1},
+    {"number/append_int", 0, -1},
+    {"number/append_double", 0, -1},
+    {"number/print", 0, -1},
+    {"base64/encode_url", 0, -1},
+    {"base64/decode", 0, -1},
+};
+
+#endif
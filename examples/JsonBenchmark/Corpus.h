@@ -0,0 +1,145 @@
+#ifndef JSON_BENCHMARK_CORPUS_H
+#define JSON_BENCHMARK_CORPUS_H
+
+// The deterministic payloads that have the same shapes as the Sheets and Drive API responses.
+// The same seed always generates the same payload on every device.
+
+#include <ESP_Google_Sheet_Client.h>
+
+static uint32_t corpus_seed = 1;
+
+static void corpusSeed(uint32_t seed)
+{
+    corpus_seed = seed;
+}
+
+static uint32_t corpusRandom(uint32_t max)
+{
+    // Linear congruential generator (Numerical Recipes)
+    corpus_seed = corpus_seed * 1664525UL + 1013904223UL;
+    return (corpus_seed >> 8) % max;
+}
+
+static void corpusCell(MB_String &out, uint32_t row, uint32_t col)
+{
+    switch (corpusRandom(4))
+    {
+    case 0:
+        out += '"';
+        out += corpusRandom(100000);
+        out += '"';
+        break;
+    case 1:
+        out += FPSTR("\"");
+        out += corpusRandom(1000);
+        out += '.';
+        out += corpusRandom(100);
+        out += '"';
+        break;
+    case 2:
+        out += FPSTR("\"2025-01-");
+        out += (int)(10 + corpusRandom(18));
+        out += FPSTR(" 12:00:00\"");
+        break;
+    default:
+        out += FPSTR("\"Item R");
+        out += row;
+        out += 'C';
+        out += col;
+        out += '"';
+        break;
+    }
+}
+
+static void corpusA1(MB_String &out, uint32_t rows, uint32_t cols)
+{
+    out += FPSTR("Sheet1!A1:");
+    out += (char)('A' + (cols - 1) % 26);
+    out += rows;
+}
+
+// values.get response of rows x cols grid
+static void corpusValuesGet(MB_String &out, uint32_t rows, uint32_t cols)
+{
+    corpusSeed(rows * 1000 + cols);
+    out = FPSTR("{\"range\":\"");
+    corpusA1(out, rows, cols);
+    out += FPSTR("\",\"majorDimension\":\"ROWS\",\"values\":[");
+    for (uint32_t r = 0; r < rows; r++)
+    {
+        if (r > 0)
+            out += ',';
+        out += '[';
+        for (uint32_t c = 0; c < cols; c++)
+        {
+            if (c > 0)
+                out += ',';
+            corpusCell(out, r, c);
+        }
+        out += ']';
+    }
+    out += FPSTR("]}");
+}
+
+// spreadsheets.get response with grid data (includeGridData=true)
+static void corpusSpreadsheetGet(MB_String &out, uint32_t rows, uint32_t cols)
+{
+    corpusSeed(rows * 2000 + cols);
+    out = FPSTR("{\"spreadsheetId\":\"1aBcDeFgHiJkLmNoPqRsTuVwXyZ0123456789abcdefg\",\"properties\":{\"title\":\"Benchmark\",\"locale\":\"en_US\",\"autoRecalc\":\"ON_CHANGE\",\"timeZone\":\"Etc/GMT\"},\"sheets\":[{\"properties\":{\"sheetId\":0,\"title\":\"Sheet1\",\"index\":0,\"sheetType\":\"GRID\",\"gridProperties\":{\"rowCount\":");
+    out += rows;
+    out += FPSTR(",\"columnCount\":");
+    out += cols;
+    out += FPSTR("}},\"data\":[{\"rowData\":[");
+    for (uint32_t r = 0; r < rows; r++)
+    {
+        if (r > 0)
+            out += ',';
+        out += FPSTR("{\"values\":[");
+        for (uint32_t c = 0; c < cols; c++)
+        {
+            if (c > 0)
+                out += ',';
+            uint32_t v = corpusRandom(10000);
+            out += FPSTR("{\"userEnteredValue\":{\"numberValue\":");
+            out += v;
+            out += FPSTR("},\"effectiveValue\":{\"numberValue\":");
+            out += v;
+            out += FPSTR("},\"formattedValue\":\"");
+            out += v;
+            out += FPSTR("\",\"effectiveFormat\":{\"horizontalAlignment\":\"RIGHT\",\"verticalAlignment\":\"BOTTOM\",\"wrapStrategy\":\"OVERFLOW_CELL\"}}");
+        }
+        out += FPSTR("]}");
+    }
+    out += FPSTR("]}]}],\"spreadsheetUrl\":\"https://docs.google.com/spreadsheets/d/1aBcDeFgHiJkLmNoPqRsTuVwXyZ0123456789abcdefg/edit\"}");
+}
+
+// Drive files.list page
+static void corpusListFiles(MB_String &out, uint32_t files)
+{
+    corpusSeed(files * 3000);
+    out = FPSTR("{\"kind\":\"drive#fileList\",\"nextPageToken\":\"~!!~AI9FV7Q\",\"incompleteSearch\":false,\"files\":[");
+    for (uint32_t i = 0; i < files; i++)
+    {
+        if (i > 0)
+            out += ',';
+        out += FPSTR("{\"kind\":\"drive#file\",\"mimeType\":\"application/vnd.google-apps.spreadsheet\",\"id\":\"1");
+        for (int j = 0; j < 43; j++)
+            out += (char)('a' + corpusRandom(26));
+        out += FPSTR("\",\"name\":\"Log ");
+        out += i;
+        out += FPSTR("\"}");
+    }
+    out += FPSTR("]}");
+}
+
+// OAuth2.0 token response
+static void corpusToken(MB_String &out)
+{
+    corpusSeed(4000);
+    out = FPSTR("{\"access_token\":\"ya29.c.");
+    for (int i = 0; i < 1000; i++)
+        out += (char)('A' + corpusRandom(26));
+    out += FPSTR("\",\"expires_in\":3599,\"token_type\":\"Bearer\"}");
+}
+
+#endif
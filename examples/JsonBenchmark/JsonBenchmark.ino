@@ -0,0 +1,53 @@
+
+/**
+ * Created by K. Suwatchai (Mobizt)
+ *
+ * Email: suwatchai@outlook.com
+ *
+ * Github: https://github.com/mobizt
+ *
+ * Copyright (c) 2025 mobizt
+ *
+ */
+
+// This example shows how to measure the JSON parse, print, get by path, iteration and array add
+// over the deterministic corpus of the Sheets and Drive API responses (Corpus.h),
+// and to check the results against the stored baseline (Baseline.h).
+
+// The same suite (Suite.h) is run on the Linux host by extras/host/json_benchmark.cpp with the baseline of the host.
+
+// The string benchmarks show the allocations of the response payload appending (64 bytes chunks),
+// the header line reading (one char at a time) and the short keys.
+
+// The base64 benchmarks show the JWT signature encoding (256 bytes) and the service account private key decoding (PEM, 1218 bytes).
+
+// The allocation counts are available when MB_HEAP_ACCOUNTING was defined in the compiler build flags.
+
+#include <Arduino.h>
+
+#include <ESP_Google_Sheet_Client.h>
+
+#include "Suite.h"
+#include "Baseline.h"
+
+void setup()
+{
+
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println();
+
+    GSheet.printf("ESP Google Sheet Client v%s\n\n", ESP_GOOGLE_SHEET_CLIENT_VERSION);
+
+    int failed = runSuite(baselines, sizeof(baselines) / sizeof(baselines[0]), BASELINE_TOLERANCE_PERCENT);
+
+    Serial.println();
+    if (failed > 0)
+        GSheet.printf("FAILED, %d regressions\n", failed);
+    else
+        Serial.println("PASSED");
+}
+
+void loop()
+{
+}
\ No newline at end of file
@@ -0,0 +1,248 @@
+/**
+ * The Client that replays the recorded HTTP exchanges from files without network.
+ *
+ * Each exchange is the request line prefix and its recorded response file e.g. "POST /token" and "token.http".
+ * The response of the exchange that matched the request line is replayed after the request line was written,
+ * and the connection is kept alive as the server does. The request that matched no exchange gets 404.
+ * The queued responses (addResponse) are replayed once, in order, before the recorded exchanges.
+ */
+
+#ifndef FILE_REPLAY_CLIENT_H
+#define FILE_REPLAY_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+class FileReplayClient : public Client
+{
+public:
+    /**
+     * Add the exchange.
+     * @param request The request line prefix e.g. "GET /v4/spreadsheets/".
+     * @param file The recorded response file.
+     * @return false when the file could not be read.
+     */
+    bool addExchange(const char *request, const char *file)
+    {
+        std::ifstream in(file, std::ios::binary);
+        if (!in)
+            return false;
+
+        std::stringstream ss;
+        ss << in.rdbuf();
+        _exchanges.push_back({request, ss.str()});
+        return true;
+    }
+
+    /**
+     * Queue the response that is replayed once.
+     * @param request The request line prefix e.g. "POST /token".
+     * @param response The response status line, headers and payload.
+     */
+    void addResponse(const char *request, const std::string &response)
+    {
+        _queued.push_back({request, response});
+    }
+
+    /**
+     * Get the number of queued responses that were not replayed yet.
+     */
+    size_t queued() { return _queued.size(); }
+
+    /**
+     * Remove the queued responses that were not replayed.
+     */
+    void clearResponses() { _queued.clear(); }
+
+    /**
+     * Get the bytes of the last request that were written.
+     */
+    const std::string &lastRequest() { return _request; }
+
+    /**
+     * Get the number of bytes that were written (the request size).
+     */
+    size_t written() { return _written; }
+
+    /**
+     * Get the number of connections that were made.
+     */
+    size_t connects() { return _connects; }
+
+    /**
+     * Get the number of write calls (the TCP segments or TLS records that would be sent).
+     */
+    size_t writes() { return _writes; }
+
+    /**
+     * Get the bytes that were written on each connection in order.
+     */
+    const std::vector<std::string> &streams() { return _streams; }
+
+    /**
+     * Close the connection by the server after the number of writes were received, the next write is failed.
+     */
+    void closeAfterWrites(int writes) { _closeAfter = writes; }
+
+    /**
+     * Half-close the connection by the server, the bytes (the TLS close_notify alert) are left to read
+     * and the requests that are written after are never answered.
+     * @param bytes The bytes that were sent by the server before it closed.
+     */
+    void halfClose(const std::string &bytes)
+    {
+        _replayed = bytes;
+        _response = &_replayed;
+        _pos = 0;
+        _halfClosed = true;
+    }
+
+    int connect(IPAddress ip, uint16_t port)
+    {
+        (void)ip;
+        (void)port;
+        return open();
+    }
+
+    int connect(const char *host, uint16_t port)
+    {
+        (void)host;
+        (void)port;
+        return open();
+    }
+
+    size_t write(uint8_t b) { return write(&b, 1); }
+
+    size_t write(const uint8_t *buf, size_t size)
+    {
+        if (!_connected)
+            return 0;
+
+        _written += size;
+        _writes++;
+        _streams.back().append((const char *)buf, size);
+
+        if (_halfClosed)
+            return size;
+
+        if (_closeAfter > 0 && --_closeAfter == 0)
+        {
+            _closeAfter = -1;
+            stop();
+            return size;
+        }
+
+        // The next request on the kept alive connection
+        if (_response && _pos >= _response->size())
+        {
+            _response = nullptr;
+            _request.clear();
+        }
+
+        _request.append((const char *)buf, size);
+
+        if (!_response && _request.find("\r\n") != std::string::npos)
+            match();
+
+        return size;
+    }
+
+    int available() { return _connected && _response ? _response->size() - _pos : 0; }
+
+    int read()
+    {
+        if (available() == 0)
+            return -1;
+
+        return (uint8_t)(*_response)[_pos++];
+    }
+
+    int read(uint8_t *buf, size_t size)
+    {
+        size_t n = std::min<size_t>(size, available());
+        if (n > 0)
+            memcpy(buf, _response->data() + _pos, n);
+        _pos += n;
+        return n;
+    }
+
+    int peek() { return available() > 0 ? (uint8_t)(*_response)[_pos] : -1; }
+
+    void flush() {}
+
+    void stop()
+    {
+        _connected = false;
+        _halfClosed = false;
+        _response = nullptr;
+    }
+
+    uint8_t connected() { return _connected; }
+
+    operator bool() { return _connected; }
+
+private:
+    struct exchange_t
+    {
+        std::string request;
+        std::string response;
+    };
+
+    std::vector<exchange_t> _exchanges;
+    std::vector<exchange_t> _queued;
+    // The queued response that is being replayed
+    std::string _replayed;
+    std::string _notFound = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+    std::string _request;
+    const std::string *_response = nullptr;
+    size_t _pos = 0;
+    size_t _written = 0;
+    size_t _connects = 0;
+    size_t _writes = 0;
+    std::vector<std::string> _streams;
+    int _closeAfter = -1;
+    bool _connected = false;
+    bool _halfClosed = false;
+
+    int open()
+    {
+        stop();
+        _request.clear();
+        _connected = true;
+        _connects++;
+        _streams.push_back("");
+        return 1;
+    }
+
+    void match()
+    {
+        _pos = 0;
+
+        for (size_t i = 0; i < _queued.size(); i++)
+        {
+            if (_request.compare(0, _queued[i].request.length(), _queued[i].request) == 0)
+            {
+                _replayed = _queued[i].response;
+                _queued.erase(_queued.begin() + i);
+                _response = &_replayed;
+                return;
+            }
+        }
+
+        _response = &_notFound;
+        for (size_t i = 0; i < _exchanges.size(); i++)
+        {
+            if (_request.compare(0, _exchanges[i].request.length(), _exchanges[i].request) == 0)
+            {
+                _response = &_exchanges[i].response;
+                break;
+            }
+        }
+    }
+};
+
+#endif
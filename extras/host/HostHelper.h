@@ -0,0 +1,103 @@
+/**
+ * The helpers of the host benchmarks and tests.
+ */
+
+#ifndef HOST_HELPER_H
+#define HOST_HELPER_H
+
+#include <ESP_Google_Sheet_Client.h>
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+
+#include <string>
+
+#include "FileReplayClient.h"
+
+namespace HostHelper
+{
+    inline std::string recorded(const char *file)
+    {
+        return std::string(RECORDED_DIR) + "/" + file;
+    }
+
+    // The PEM of the new RSA key for the service account, the JWT is signed but never verified on host
+    inline MB_String generateKey()
+    {
+        MB_String pem;
+        EVP_PKEY *key = EVP_RSA_gen(2048);
+        BIO *bio = BIO_new(BIO_s_mem());
+        if (key && PEM_write_bio_PrivateKey(bio, key, nullptr, nullptr, 0, nullptr, nullptr) > 0)
+        {
+            char *data = nullptr;
+            long len = BIO_get_mem_data(bio, &data);
+            // The BIO data is not NUL terminated
+            pem = std::string(data, len).c_str();
+        }
+        BIO_free(bio);
+        EVP_PKEY_free(key);
+        return pem;
+    }
+
+    // The OAuth2.0 token response with the access token
+    inline std::string tokenResponse(const char *accessToken)
+    {
+        std::string payload = std::string("{\"access_token\": \"") + accessToken + "\", \"expires_in\": 3599, \"token_type\": \"Bearer\"}";
+        return "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=utf-8\r\nContent-Length: " +
+               std::to_string(payload.length()) + "\r\nConnection: keep-alive\r\n\r\n" + payload;
+    }
+
+    // The JSON response with Content-Length
+    inline std::string jsonResponse(const std::string &payload, int code = 200, const char *status = "OK", const char *headers = "")
+    {
+        return "HTTP/1.1 " + std::to_string(code) + " " + status + "\r\nContent-Type: application/json; charset=UTF-8\r\n" + headers +
+               "Content-Length: " + std::to_string(payload.length()) + "\r\n\r\n" + payload;
+    }
+
+    inline void networkConnection() {}
+
+    inline void networkStatus() { GSheet.setNetworkStatus(true); }
+
+    // Begin with the replayed client and wait for the access token, the rate limiter is off
+    inline bool begin(FileReplayClient &replay, const char *accessToken = "host-token")
+    {
+        static MB_String key;
+        if (key.length() == 0)
+            key = generateKey();
+
+        replay.addResponse("POST /token", tokenResponse(accessToken));
+
+        GSheet.setExternalClient(&replay, networkConnection, networkStatus);
+        GSheet.setSystemTime(time(nullptr));
+        GSheet.begin("host@host.iam.gserviceaccount.com", "host", key.c_str());
+
+        // The token requests are at least 5 seconds apart
+        unsigned long ms = millis();
+        while (!GSheet.ready() && millis() - ms < 15000)
+            ;
+        return GSheet.ready();
+    }
+
+    // The query parameter values of the request line e.g. ranges
+    inline std::vector<std::string> params(const std::string &request, const char *name)
+    {
+        std::vector<std::string> out;
+        std::string line = request.substr(0, request.find(" HTTP/1.1"));
+        std::string key = std::string(name) + "=";
+        size_t p = 0;
+        while ((p = line.find(key, p)) != std::string::npos)
+        {
+            if (p > 0 && line[p - 1] != '?' && line[p - 1] != '&')
+            {
+                p += key.length();
+                continue;
+            }
+            p += key.length();
+            size_t e = line.find('&', p);
+            out.push_back(line.substr(p, e == std::string::npos ? std::string::npos : e - p));
+        }
+        return out;
+    }
+};
+
+#endif
@@ -0,0 +1,238 @@
+/**
+ * The host benchmarks of the request build, response read and JSON parse/serialize (Google Benchmark).
+ *
+ * The Sheets and OAuth2.0 exchanges are replayed from the recorded files (recorded/) by FileReplayClient,
+ * the service account key is generated at start, then no network and no credentials are needed.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <ESP_Google_Sheet_Client.h>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+#define SPREADSHEET_ID "1aBcDeFgHiJkLmNoPqRsTuVwXyZ0123456789abcdef"
+
+static MB_FS mbfs;
+
+// Read the response from client in the same way as GAuthManager::handleResponse.
+static int readResponse(Client *client, MB_String &payload)
+{
+    payload.clear();
+
+    esp_google_sheet_server_response_data_t response;
+    esp_google_sheet_tcp_response_handler_t tcpHandler;
+
+    tcpHandler.client = client;
+    tcpHandler.defaultChunkSize = 2048;
+    tcpHandler.chunkBufSize = tcpHandler.defaultChunkSize;
+    tcpHandler.error.code = -1;
+    tcpHandler.dataTime = millis();
+
+    char *pChunk = MemoryHelper::createBuffer<char *>(&mbfs, tcpHandler.chunkBufSize + 1);
+
+    bool complete = false;
+
+    while (tcpHandler.available() > 0 && !complete)
+    {
+        if (!HttpHelper::readStatusLine(&mbfs, client, tcpHandler, response))
+        {
+            if (tcpHandler.isHeader)
+            {
+                if (HttpHelper::readHeader(&mbfs, client, tcpHandler, response) && Utils::isNoContent(&response))
+                    break;
+            }
+            else
+            {
+                memset(pChunk, 0, tcpHandler.chunkBufSize + 1);
+
+                if (response.isChunkedEnc)
+                    tcpHandler.bufferAvailable = HttpHelper::readChunkedData(&mbfs, client, pChunk, nullptr, tcpHandler);
+                else
+                    tcpHandler.bufferAvailable = HttpHelper::readLine(client, pChunk, tcpHandler.chunkBufSize);
+
+                if (tcpHandler.bufferAvailable > 0)
+                {
+                    tcpHandler.payloadRead += tcpHandler.bufferAvailable;
+                    payload += pChunk;
+                }
+
+                if (Utils::isChunkComplete(&tcpHandler, &response, complete) ||
+                    Utils::isResponseComplete(&tcpHandler, &response, complete))
+                    break;
+            }
+        }
+    }
+
+    MemoryHelper::freeBuffer(&mbfs, pChunk);
+
+    return response.httpCode;
+}
+
+static void replayRead(benchmark::State &state, const char *file)
+{
+    FileReplayClient client;
+    if (!client.addExchange("GET", HostHelper::recorded(file).c_str()))
+    {
+        state.SkipWithError("The recorded response could not be read");
+        return;
+    }
+
+    MB_String payload;
+    for (auto _ : state)
+    {
+        client.connect("sheets.googleapis.com", 443);
+        client.write((const uint8_t *)"GET / HTTP/1.1\r\n", 16);
+        benchmark::DoNotOptimize(readResponse(&client, payload));
+    }
+
+    state.SetBytesProcessed(state.iterations() * payload.length());
+}
+
+static void BM_ResponseReadChunked(benchmark::State &state) { replayRead(state, "values_batch_get.http"); }
+BENCHMARK(BM_ResponseReadChunked);
+
+static void BM_ResponseReadContentLength(benchmark::State &state) { replayRead(state, "token.http"); }
+BENCHMARK(BM_ResponseReadContentLength);
+
+// The request line and headers of values:batchGet in the same way as GSheetClass::mGet
+static void BM_RequestBuild(benchmark::State &state)
+{
+    const char *ranges[] = {"Sheet1!A1:E20", "Sheet1!G1:G20", "'My Sheet'!B2:C8"};
+    MB_String req;
+
+    for (auto _ : state)
+    {
+        HttpHelper::RequestComposer rc(req);
+        do
+        {
+            rc += FPSTR("GET /v4/spreadsheets/");
+            rc += SPREADSHEET_ID;
+            rc += FPSTR("/values:batchGet");
+
+            for (size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++)
+            {
+                rc += i > 0 ? '&' : '?';
+                rc += FPSTR("ranges=");
+                rc += ranges[i];
+            }
+
+            rc += FPSTR("&majorDimension=ROWS");
+            rc += FPSTR(" HTTP/1.1\r\n");
+        } while (rc.next());
+
+        benchmark::DoNotOptimize(req.c_str());
+    }
+}
+BENCHMARK(BM_RequestBuild);
+
+static MB_String batchGetBody()
+{
+    FileReplayClient client;
+    MB_String payload;
+    if (client.addExchange("GET", HostHelper::recorded("values_batch_get.http").c_str()))
+    {
+        client.connect("sheets.googleapis.com", 443);
+        client.write((const uint8_t *)"GET / HTTP/1.1\r\n", 16);
+        readResponse(&client, payload);
+    }
+    return payload;
+}
+
+static void BM_JsonParse(benchmark::State &state)
+{
+    MB_String body = batchGetBody();
+
+    for (auto _ : state)
+    {
+        FirebaseJson json;
+        FirebaseJsonData result;
+        json.setJsonData(body.c_str());
+        json.get(result, "valueRanges/[0]/values/[19]/[4]");
+        benchmark::DoNotOptimize(result.success);
+    }
+
+    state.SetBytesProcessed(state.iterations() * body.length());
+}
+BENCHMARK(BM_JsonParse);
+
+static void BM_JsonSerialize(benchmark::State &state)
+{
+    MB_String body = batchGetBody();
+    FirebaseJson json;
+    json.setJsonData(body.c_str());
+    MB_String out;
+
+    for (auto _ : state)
+    {
+        json.toString(out);
+        benchmark::DoNotOptimize(out.c_str());
+    }
+
+    state.SetBytesProcessed(state.iterations() * out.length());
+}
+BENCHMARK(BM_JsonSerialize);
+
+static FileReplayClient replay;
+
+static void networkConnection() {}
+
+static void networkStatus() { GSheet.setNetworkStatus(true); }
+
+// Get the access token from the replayed OAuth2.0 exchange
+static bool beginGSheet()
+{
+    static bool ready = false;
+    static MB_String key;
+
+    if (ready)
+        return true;
+
+    key = HostHelper::generateKey();
+    if (key.length() == 0 ||
+        !replay.addExchange("POST /token", HostHelper::recorded("token.http").c_str()) ||
+        !replay.addExchange("GET /v4/spreadsheets/", HostHelper::recorded("values_batch_get.http").c_str()))
+        return false;
+
+    GSheet.setExternalClient(&replay, networkConnection, networkStatus);
+
+    // The JWT needs the valid time, no NTP server on host
+    GSheet.setSystemTime(time(nullptr));
+
+    GSheet.begin("benchmark@host.iam.gserviceaccount.com", "host", key.c_str());
+
+    unsigned long ms = millis();
+    while (!ready && millis() - ms < 10000)
+        ready = GSheet.ready();
+
+    return ready;
+}
+
+// The values:batchGet round trip: request build, send, GAuthManager::handleResponse and the JSON parse
+static void BM_ValuesBatchGet(benchmark::State &state)
+{
+    if (!beginGSheet())
+    {
+        state.SkipWithError("The access token could not be taken from the replayed exchange");
+        return;
+    }
+
+    FirebaseJson response;
+    size_t written = replay.written();
+
+    for (auto _ : state)
+    {
+        if (!GSheet.values.batchGet(&response, SPREADSHEET_ID, "Sheet1!A1:E20"))
+        {
+            state.SkipWithError(GSheet.errorReason().c_str());
+            break;
+        }
+    }
+
+    state.counters["request_bytes"] = benchmark::Counter((replay.written() - written) / (double)state.iterations());
+    state.counters["connects"] = replay.connects();
+}
+BENCHMARK(BM_ValuesBatchGet);
+
+BENCHMARK_MAIN();
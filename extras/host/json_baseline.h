@@ -0,0 +1,54 @@
+#ifndef JSON_BENCHMARK_HOST_BASELINE_H
+#define JSON_BENCHMARK_HOST_BASELINE_H
+
+// The stored baseline in nanoseconds and allocations per iteration of each benchmark on the Linux host
+// (Release build with MB_HEAP_ACCOUNTING). The times are checked only with GSHEET_BENCH_GATE.
+// The benchmark that has no baseline (0 ns, -1 allocs) is not checked.
+
+#define BASELINE_TOLERANCE_PERCENT 30
+
+static const baseline_item_t host_baselines[] = {
+    {"values_get_1x1/parse", 725, 12},
+    {"values_get_1x1/print", 425, 2},
+    {"values_get_1x1/get", 1435, 4},
+    {"values_get_1x1/iterate", 1195, 8},
+    {"values_get_10x10/parse", 14470, 219},
+    {"values_get_10x10/print", 5905, 5},
+    {"values_get_10x10/get", 1455, 4},
+    {"values_get_10x10/iterate", 29570, 209},
+    {"values_get_50x8/parse", 57755, 859},
+    {"values_get_50x8/print", 22540, 7},
+    {"values_get_50x8/get", 1565, 4},
+    {"values_get_50x8/iterate", 124260, 811},
+    {"values_get_200x2/parse", 67630, 1009},
+    {"values_get_200x2/print", 28175, 7},
+    {"values_get_200x2/get", 2165, 5},
+    {"values_get_200x2/iterate", 137745, 811},
+    {"spreadsheet_get_10x5/parse", 104200, 1227},
+    {"spreadsheet_get_10x5/print", 46495, 8},
+    {"spreadsheet_get_10x5/get", 3020, 5},
+    {"spreadsheet_get_10x5/iterate", 331930, 793},
+    {"spreadsheet_get_40x5/parse", 393705, 4767},
+    {"spreadsheet_get_40x5/print", 175585, 10},
+    {"spreadsheet_get_40x5/get", 2910, 5},
+    {"spreadsheet_get_40x5/iterate", 1242480, 3045},
+    {"list_files_20/parse", 18590, 271},
+    {"list_files_20/print", 9760, 6},
+    {"list_files_20/get", 1180, 4},
+    {"list_files_20/iterate", 35125, 172},
+    {"token/parse", 3065, 9},
+    {"token/print", 2000, 3},
+    {"token/get", 705, 4},
+    {"token/iterate", 2255, 5},
+    {"array_add_100/add", 11080, 251},
+    {"string/append_chunk", 5630, 11},
+    {"string/append_char", 3665, 6},
+    {"string/short_keys", 3055, 0},
+    {"number/append_int", 7350, 10},
+    {"number/append_double", 10555, 10},
+    {"number/print", 13920, 106},
+    {"base64/encode_url", 360, 0},
+    {"base64/decode", 3490, 3},
+};
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * The host run of the JSON benchmark suite (examples/JsonBenchmark/Suite.h), including the number formatting,
+ * the iterator and the base64 kernels.
+ *
+ * Exit with non-zero status when any benchmark allocates more than its baseline (json_baseline.h).
+ * The allocations are counted with MB_HEAP_ACCOUNTING and are the same on every machine.
+ *
+ * The times depend on the machine, they are compared only when built with -DGSHEET_BENCH_GATE=ON,
+ * the benchmark that is slower than its baseline by more than BASELINE_TOLERANCE_PERCENT is failed.
+ * The time baseline was recorded from the Release build of this target.
+ *
+ * To update the baseline, run json_benchmark and copy the "{...}," lines into json_baseline.h.
+ */
+
+#define BENCHMARK_ITERATIONS 200
+#define BENCHMARK_ROUNDS 5
+
+#include "Suite.h"
+
+#include "json_baseline.h"
+
+#if defined(GSHEET_BENCH_GATE)
+#define TIME_TOLERANCE_PERCENT BASELINE_TOLERANCE_PERCENT
+#else
+#define TIME_TOLERANCE_PERCENT -1
+#endif
+
+int main()
+{
+    GSheet.printf("ESP Google Sheet Client v%s\n\n", ESP_GOOGLE_SHEET_CLIENT_VERSION);
+
+    int failed = runSuite(host_baselines, sizeof(host_baselines) / sizeof(host_baselines[0]), TIME_TOLERANCE_PERCENT);
+
+    if (failed > 0)
+        GSheet.printf("\nFAILED, %d regressions\n", failed);
+    else
+        GSheet.printf("\nPASSED\n");
+
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,304 @@
+/**
+ * The minimal Arduino core API for building the library on Linux host (benchmarks only).
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+
+using std::nullptr_t;
+
+#define ARDUINO 10819
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char *
+#define PGM_VOID_P const void *
+#define strlen_P strlen
+#define strnlen_P strnlen
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+#define strcat_P strcat
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strncmp_P strncmp
+#define strcmp_P strcmp
+#define strcasecmp_P strcasecmp
+#define strstr_P strstr
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+#define vsnprintf_P vsnprintf
+#define pgm_read_byte(a) (*(const uint8_t *)(a))
+#define pgm_read_word(a) (*(const uint16_t *)(a))
+#define pgm_read_dword(a) (*(const uint32_t *)(a))
+#define pgm_read_ptr(a) (*(void *const *)(a))
+
+class __FlashStringHelper;
+#define FPSTR(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define F(s) FPSTR(s)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HEX 16
+#define DEC 10
+
+unsigned long millis();
+unsigned long micros();
+// Move the host clock forward, the idle timeouts expire without waiting
+void advanceMillis(unsigned long ms);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+class String
+{
+public:
+    String() {}
+    String(const char *s) : s(s ? s : "") {}
+    String(const __FlashStringHelper *s) : s(s ? (const char *)s : "") {}
+    String(const std::string &s) : s(s) {}
+    String(char c) : s(1, c) {}
+    String(int v, unsigned char base = 10) : s(format(v, base)) {}
+    String(unsigned int v, unsigned char base = 10) : s(format(v, base)) {}
+    String(long v, unsigned char base = 10) : s(format(v, base)) {}
+    String(unsigned long v, unsigned char base = 10) : s(format(v, base)) {}
+    String(long long v, unsigned char base = 10) : s(format(v, base)) {}
+    String(unsigned long long v, unsigned char base = 10) : s(format(v, base)) {}
+    String(float v, unsigned char decimals = 2) : s(format(v, decimals)) {}
+    String(double v, unsigned char decimals = 2) : s(format(v, decimals)) {}
+
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.length(); }
+    bool reserve(unsigned int size)
+    {
+        s.reserve(size);
+        return true;
+    }
+    void clear() { s.clear(); }
+
+    char operator[](unsigned int i) const { return i < s.length() ? s[i] : 0; }
+    char &operator[](unsigned int i) { return s[i]; }
+    char charAt(unsigned int i) const { return (*this)[i]; }
+
+    String &operator=(const char *c)
+    {
+        s = c ? c : "";
+        return *this;
+    }
+
+    bool concat(const char *c)
+    {
+        if (c)
+            s += c;
+        return true;
+    }
+    bool concat(const char *c, unsigned int len)
+    {
+        s.append(c, len);
+        return true;
+    }
+    bool concat(const String &c)
+    {
+        s += c.s;
+        return true;
+    }
+    bool concat(char c)
+    {
+        s += c;
+        return true;
+    }
+    template <typename T>
+    bool concat(T v)
+    {
+        s += String(v).s;
+        return true;
+    }
+
+    template <typename T>
+    String &operator+=(const T &v)
+    {
+        concat(v);
+        return *this;
+    }
+
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator==(const char *o) const { return s == (o ? o : ""); }
+    bool operator!=(const String &o) const { return s != o.s; }
+    bool operator!=(const char *o) const { return !(*this == o); }
+    bool operator<(const String &o) const { return s < o.s; }
+
+    int indexOf(char c, unsigned int from = 0) const { return pos(s.find(c, from)); }
+    int indexOf(const char *c, unsigned int from = 0) const { return pos(s.find(c, from)); }
+    int indexOf(const String &c, unsigned int from = 0) const { return pos(s.find(c.s, from)); }
+    int lastIndexOf(char c) const { return pos(s.rfind(c)); }
+    int lastIndexOf(const char *c) const { return pos(s.rfind(c)); }
+
+    String substring(unsigned int from) const { return from < s.length() ? String(s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to)
+            std::swap(from, to);
+        return from < s.length() ? String(s.substr(from, to - from)) : String();
+    }
+
+    void remove(unsigned int i) { s.erase(std::min<size_t>(i, s.length())); }
+    void remove(unsigned int i, unsigned int n)
+    {
+        if (i < s.length())
+            s.erase(i, n);
+    }
+    void trim()
+    {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        size_t e = s.find_last_not_of(" \t\r\n");
+        s = b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+    }
+    void toLowerCase() { std::transform(s.begin(), s.end(), s.begin(), ::tolower); }
+    void toUpperCase() { std::transform(s.begin(), s.end(), s.begin(), ::toupper); }
+    bool startsWith(const String &p) const { return s.compare(0, p.s.length(), p.s) == 0; }
+    bool endsWith(const String &p) const { return s.length() >= p.s.length() && s.compare(s.length() - p.s.length(), p.s.length(), p.s) == 0; }
+    bool equalsIgnoreCase(const String &o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+    void replace(const String &a, const String &b)
+    {
+        for (size_t p = 0; !a.s.empty() && (p = s.find(a.s, p)) != std::string::npos; p += b.s.length())
+            s.replace(p, a.s.length(), b.s);
+    }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+    double toDouble() const { return atof(s.c_str()); }
+
+private:
+    std::string s;
+
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+
+    template <typename T>
+    static std::string format(T v, unsigned char base)
+    {
+        if (base == 16)
+        {
+            char buf[24];
+            snprintf(buf, sizeof(buf), "%llx", (unsigned long long)v);
+            return buf;
+        }
+        return std::to_string(v);
+    }
+
+    static std::string format(double v, unsigned char decimals)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        return buf;
+    }
+};
+
+class StringSumHelper : public String
+{
+public:
+    StringSumHelper(const String &s) : String(s) {}
+};
+
+inline StringSumHelper operator+(const String &a, const String &b)
+{
+    String s = a;
+    s += b;
+    return s;
+}
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size)
+    {
+        size_t n = 0;
+        while (n < size && write(buf[n]))
+            n++;
+        return n;
+    }
+    size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+    virtual void flush() {}
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+    size_t print(const String &s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    template <typename T>
+    size_t print(T v) { return print(String(v)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(T v)
+    {
+        size_t n = print(v);
+        return n + println();
+    }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char buf[512];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        return len > 0 ? write((const uint8_t *)buf, std::min<size_t>(len, sizeof(buf) - 1)) : 0;
+    }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() { return _timeout; }
+    size_t readBytes(char *buf, size_t len) { return readBytes((uint8_t *)buf, len); }
+    size_t readBytes(uint8_t *buf, size_t len)
+    {
+        size_t n = 0;
+        int c;
+        while (n < len && (c = read()) >= 0)
+            buf[n++] = c;
+        return n;
+    }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t write(const uint8_t *buf, size_t size) { return fwrite(buf, 1, size, stdout); }
+    using Print::write;
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#include "IPAddress.h"
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * The ESP_SSLClient for Linux host (benchmarks only).
+ *
+ * The client is TLS-less, the data is passed through to the assigned Client e.g. the ReplayClient.
+ * The BearSSL SHA-256 and RSA PKCS#1 signing that are used for the JWT are implemented with OpenSSL.
+ */
+
+#ifndef HOST_ESP_SSLCLIENT_H
+#define HOST_ESP_SSLCLIENT_H
+
+#include "Arduino.h"
+#include "Client.h"
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#define ESP_SSLCLIENT_VALID_TIMESTAMP 1690168439
+
+#define br_sha256_SIZE 32
+#define BR_HASH_OID_SHA256 ((const unsigned char *)"\x09\x60\x86\x48\x01\x65\x03\x04\x02\x01")
+
+struct br_sha256_context
+{
+    EVP_MD_CTX *ctx = nullptr;
+    br_sha256_context() {}
+    br_sha256_context(const br_sha256_context &) = delete;
+    br_sha256_context &operator=(const br_sha256_context &) = delete;
+    ~br_sha256_context() { EVP_MD_CTX_free(ctx); }
+};
+
+inline void br_sha256_init(br_sha256_context *mc)
+{
+    if (!mc->ctx)
+        mc->ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(mc->ctx, EVP_sha256(), nullptr);
+}
+
+inline void br_sha256_update(br_sha256_context *mc, const void *data, size_t len)
+{
+    EVP_DigestUpdate(mc->ctx, data, len);
+}
+
+inline void br_sha256_out(const br_sha256_context *mc, void *out)
+{
+    // The BearSSL digest can be continued after the output
+    EVP_MD_CTX *copy = EVP_MD_CTX_new();
+    EVP_MD_CTX_copy_ex(copy, mc->ctx);
+    EVP_DigestFinal_ex(copy, (unsigned char *)out, nullptr);
+    EVP_MD_CTX_free(copy);
+}
+
+struct br_rsa_private_key
+{
+    EVP_PKEY *pkey = nullptr;
+};
+
+// Returns 1 on success, 0 on error
+inline uint32_t br_rsa_i15_pkcs1_sign(const unsigned char *, const unsigned char *hash, size_t hashLen,
+                                      const br_rsa_private_key *sk, unsigned char *x)
+{
+    EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new(sk->pkey, nullptr);
+    size_t len = EVP_PKEY_get_size(sk->pkey);
+    bool ok = ctx && EVP_PKEY_sign_init(ctx) > 0 &&
+              EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_PADDING) > 0 &&
+              EVP_PKEY_CTX_set_signature_md(ctx, EVP_sha256()) > 0 &&
+              EVP_PKEY_sign(ctx, x, &len, hash, hashLen) > 0;
+    EVP_PKEY_CTX_free(ctx);
+    return ok ? 1 : 0;
+}
+
+class PrivateKey
+{
+public:
+    PrivateKey(const char *pem)
+    {
+        BIO *bio = BIO_new_mem_buf(pem, -1);
+        _key.pkey = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
+        BIO_free(bio);
+    }
+
+    PrivateKey(const uint8_t *der, size_t len)
+    {
+        _key.pkey = d2i_AutoPrivateKey(nullptr, &der, len);
+    }
+
+    ~PrivateKey() { EVP_PKEY_free(_key.pkey); }
+
+    bool isRSA() const { return _key.pkey && EVP_PKEY_get_base_id(_key.pkey) == EVP_PKEY_RSA; }
+
+    const br_rsa_private_key *getRSA() const { return &_key; }
+
+private:
+    br_rsa_private_key _key;
+};
+
+class X509List
+{
+public:
+    X509List(const char *) {}
+    X509List(const uint8_t *, size_t) {}
+};
+
+class ESP_SSLClient : public Client
+{
+public:
+    void setClient(Client *client, bool enableSSL = true)
+    {
+        _client = client;
+        _secure = enableSSL;
+    }
+
+    void setInsecure() {}
+    void enableSSL(bool enable) { _secure = enable; }
+    void setX509Time(time_t) {}
+    void setTrustAnchors(X509List *) {}
+    void setBufferSizes(int, int) {}
+    void setSessionTimeout(uint32_t) {}
+    void setDebugLevel(int) {}
+    void setTimeout(unsigned long timeoutSec) { _timeout_sec = timeoutSec; }
+    unsigned long getTimeout() { return _timeout_sec; }
+
+    int connect(IPAddress ip, uint16_t port) { return _client && _client->connect(ip, port); }
+    int connect(const char *host, uint16_t port) { return _client && _client->connect(host, port); }
+
+    // Upgrade the connected client, nothing to do without TLS
+    int connectSSL(const char *, uint16_t) { return _client && _client->connected(); }
+
+    size_t write(uint8_t c) { return _client ? _client->write(c) : 0; }
+    size_t write(const uint8_t *buf, size_t size) { return _client ? _client->write(buf, size) : 0; }
+    using Print::write;
+    int available() { return _client ? _client->available() : 0; }
+    int read() { return _client ? _client->read() : -1; }
+    int read(uint8_t *buf, size_t size) { return _client ? _client->read(buf, size) : -1; }
+    int peek() { return _client ? _client->peek() : -1; }
+    void flush()
+    {
+        if (_client)
+            _client->flush();
+    }
+    void stop()
+    {
+        if (_client)
+            _client->stop();
+    }
+    uint8_t connected() { return _client && _client->connected(); }
+    operator bool() { return connected(); }
+
+private:
+    Client *_client = nullptr;
+    bool _secure = true;
+    unsigned long _timeout_sec = 120;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef HOST_IPADDRESS_H
+#define HOST_IPADDRESS_H
+
+#include <stdint.h>
+
+class IPAddress
+{
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _addr((uint32_t)a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24) {}
+    IPAddress(uint32_t addr) : _addr(addr) {}
+
+    operator uint32_t() const { return _addr; }
+    uint8_t operator[](int i) const { return (_addr >> (8 * i)) & 0xff; }
+    bool operator==(const IPAddress &o) const { return _addr == o._addr; }
+    bool operator!=(const IPAddress &o) const { return _addr != o._addr; }
+
+private:
+    uint32_t _addr = 0;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * The service account registry, the request is always sent with the token of the selected account.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+static FileReplayClient replay;
+
+static void networkConnection() {}
+
+static void networkStatus() { GSheet.setNetworkStatus(true); }
+
+static std::string bearer(const std::string &request)
+{
+    size_t p = request.find("Authorization: Bearer ");
+    if (p == std::string::npos)
+        return "";
+    p += 22;
+    return request.substr(p, request.find("\r\n", p) - p);
+}
+
+TEST(MB_String, SwapExchangesInlineAndHeapBuffers)
+{
+    MB_String a = "tokenA", b = "tokenB";
+    a.swap(b);
+    EXPECT_STREQ(a.c_str(), "tokenB");
+    EXPECT_STREQ(b.c_str(), "tokenA");
+
+    MB_String s = "short", l = "the string that is longer than the inline buffer";
+    s.swap(l);
+    EXPECT_STREQ(s.c_str(), "the string that is longer than the inline buffer");
+    EXPECT_STREQ(l.c_str(), "short");
+
+    // The moved strings are still usable
+    s += "!";
+    l += " string";
+    EXPECT_STREQ(s.c_str(), "the string that is longer than the inline buffer!");
+    EXPECT_STREQ(l.c_str(), "short string");
+
+    MB_String e;
+    e.swap(l);
+    EXPECT_STREQ(e.c_str(), "short string");
+    EXPECT_EQ(l.length(), 0u);
+}
+
+TEST(Accounts, TokenOfSelectedAccountOnly)
+{
+    MB_String key0 = HostHelper::generateKey();
+    MB_String key1 = HostHelper::generateKey();
+    ASSERT_GT(key0.length(), 0u);
+
+    // The selected account's token is requested first, then the other account's in background
+    replay.addResponse("POST /token", HostHelper::tokenResponse("token-of-account-0"));
+    replay.addResponse("POST /token", HostHelper::tokenResponse("token-of-account-1"));
+    ASSERT_TRUE(replay.addExchange("GET /v4/spreadsheets/", HostHelper::recorded("values_batch_get.http").c_str()));
+
+    GSheet.setExternalClient(&replay, networkConnection, networkStatus);
+    GSheet.setSystemTime(time(nullptr));
+    GSheet.begin("account0@host.iam.gserviceaccount.com", "host", key0.c_str());
+    ASSERT_EQ(GSheet.addAccount("account1@host.iam.gserviceaccount.com", "host", key1.c_str()), 1);
+
+    unsigned long ms = millis();
+    // The token requests are at least 5 seconds apart
+    while (replay.queued() > 0 && millis() - ms < 15000)
+        GSheet.ready();
+    ASSERT_EQ(replay.queued(), 0u);
+
+    FirebaseJson response;
+    const size_t order[] = {1, 0, 1, 1, 0, 0, 1};
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++)
+    {
+        ASSERT_TRUE(GSheet.selectAccount(order[i]));
+        ASSERT_TRUE(GSheet.values.get(&response, "spreadsheetId", "Sheet1!A1:E20")) << GSheet.errorReason().c_str();
+        EXPECT_EQ(bearer(replay.lastRequest()), "token-of-account-" + std::to_string(order[i])) << "request " << i;
+    }
+}
@@ -0,0 +1,126 @@
+/**
+ * The values get cache, the write invalidates every cached read that may contain its cells.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+static FileReplayClient replay;
+
+static std::string valueRange(const char *range, const char *value)
+{
+    return std::string("{\"range\":\"") + range + "\",\"majorDimension\":\"ROWS\",\"values\":[[\"" + value + "\"]]}";
+}
+
+// Read the range and get its first value, the response is served from the cache when no response was queued
+static std::string read(const char *range)
+{
+    String response;
+    if (!GSheet.values.get(&response, "id", range))
+        return "";
+
+    FirebaseJson json(response);
+    FirebaseJsonData result;
+    json.get(result, "values/[0]/[0]");
+    return result.stringValue.c_str();
+}
+
+static bool write(const char *range)
+{
+    replay.addResponse("PUT /v4/spreadsheets/", HostHelper::jsonResponse("{\"spreadsheetId\":\"id\",\"updatedCells\":1}"));
+
+    FirebaseJson valueRange, response;
+    valueRange.add("range", range);
+    valueRange.set("values/[0]/[0]", "x");
+    return GSheet.values.update(&response, "id", range, &valueRange);
+}
+
+// Cache the read, write the range and check whether the read was invalidated
+static bool invalidated(const char *readRange, const char *writeRange)
+{
+    GSheet.clearCache();
+
+    replay.addResponse("GET /v4/spreadsheets/", HostHelper::jsonResponse(valueRange(readRange, "old")));
+    if (read(readRange) != "old" || read(readRange) != "old")
+        return false;
+
+    if (!write(writeRange))
+        return false;
+
+    replay.addResponse("GET /v4/spreadsheets/", HostHelper::jsonResponse(valueRange(readRange, "new")));
+    std::string value = read(readRange);
+
+    // Drop the response that was not taken
+    while (replay.queued() > 0)
+        read("Sheet9!A1");
+
+    return value == "new";
+}
+
+class Cache : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        ASSERT_TRUE(HostHelper::begin(replay));
+        GSheet.setCache(8);
+    }
+};
+
+TEST_F(Cache, ReadIsCached)
+{
+    GSheet.clearCache();
+    replay.addResponse("GET /v4/spreadsheets/", HostHelper::jsonResponse(valueRange("Sheet1!A1:B2", "cached")));
+    EXPECT_EQ(read("Sheet1!A1:B2"), "cached");
+    EXPECT_EQ(replay.queued(), 0u);
+    EXPECT_EQ(read("Sheet1!A1:B2"), "cached");
+}
+
+TEST_F(Cache, WholeSheetReadIsInvalidated)
+{
+    EXPECT_TRUE(invalidated("Sheet1", "Sheet1!A1:B2"));
+    EXPECT_TRUE(invalidated("'Sheet1'", "Sheet1!C5"));
+    EXPECT_TRUE(invalidated("Sheet1!A1:B2", "Sheet1"));
+    EXPECT_TRUE(invalidated("Data2024", "Data2024!XFD10000000"));
+}
+
+TEST_F(Cache, UnboundedRangeIsWholeSheet)
+{
+    EXPECT_TRUE(invalidated("Sheet1!A:A", "Sheet1!Z99"));
+    EXPECT_TRUE(invalidated("Sheet1!C3:D4", "Sheet1!1:2"));
+    EXPECT_TRUE(invalidated("Sheet1!C3:D4", "A:A"));
+}
+
+TEST_F(Cache, BareCellMayBeAnySheet)
+{
+    EXPECT_TRUE(invalidated("A1", "Sheet1!A1"));
+    EXPECT_TRUE(invalidated("Sheet1!A1", "A1"));
+}
+
+TEST_F(Cache, OtherCellsAreKept)
+{
+    EXPECT_FALSE(invalidated("Sheet1", "Sheet2!A1:B2"));
+    EXPECT_FALSE(invalidated("Sheet1!A1:B2", "Sheet1!C3:D4"));
+    EXPECT_FALSE(invalidated("Sheet1!A:A", "Sheet2!A1"));
+}
+
+// The hit is served before the token check, it needs no token exchange and no network
+TEST_F(Cache, HitNeedsNoToken)
+{
+    GSheet.clearCache();
+    replay.addResponse("GET /v4/spreadsheets/", HostHelper::jsonResponse(valueRange("Sheet1!A1:B2", "cached")));
+    EXPECT_EQ(read("Sheet1!A1:B2"), "cached");
+
+    // The token is expired and the network is down
+    size_t written = replay.written();
+    GSheet.setSystemTime(time(nullptr) + 7200);
+    GSheet.setNetworkStatus(false);
+
+    EXPECT_EQ(read("Sheet1!A1:B2"), "cached");
+    EXPECT_EQ(replay.written(), written);
+
+    GSheet.setNetworkStatus(true);
+    GSheet.setSystemTime(time(nullptr));
+}
@@ -0,0 +1,169 @@
+/**
+ * The kept alive connection, the request is written at once on one connection and the chunked response is read
+ * to its end then the next request reuses the connection. The connection that the server closed or would close
+ * is replaced before sending, and it is kept warm from ready() before the server idle timeout.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+static FileReplayClient replay;
+
+class Connection : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite() { ASSERT_TRUE(HostHelper::begin(replay)); }
+
+    // Get the number of the connections that were opened by the requests
+    static size_t connects(int requests)
+    {
+        size_t connects = replay.connects();
+        for (int i = 0; i < requests; i++)
+        {
+            FirebaseJson response;
+            EXPECT_TRUE(GSheet.values.batchGet(&response, "id", "Sheet1!A1:B2"));
+        }
+        return replay.connects() - connects;
+    }
+};
+
+TEST_F(Connection, ChunkedResponseKeepsTheConnection)
+{
+    ASSERT_TRUE(replay.addExchange("GET /v4/spreadsheets/", HostHelper::recorded("values_batch_get.http").c_str()));
+
+    connects(1);
+    EXPECT_EQ(connects(5), 0u);
+}
+
+TEST_F(Connection, TrailerFieldsAreRead)
+{
+    std::string payload = "{\"spreadsheetId\":\"id\",\"valueRanges\":[{\"range\":\"Sheet1!A1:B2\",\"values\":[[\"1\"]]}]}";
+    std::string chunked = "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=UTF-8\r\nTransfer-Encoding: chunked\r\n\r\n";
+    char size[16];
+    snprintf(size, sizeof(size), "%zx\r\n", payload.length());
+    chunked += size + payload + "\r\n0\r\nServer-Timing: gfet4t7; dur=12\r\n\r\n";
+
+    for (int i = 0; i < 6; i++)
+        replay.addResponse("GET /v4/spreadsheets/", chunked);
+
+    connects(1);
+    EXPECT_EQ(connects(5), 0u);
+}
+
+static bool update(size_t cells)
+{
+    replay.addResponse("PUT /v4/spreadsheets/", HostHelper::jsonResponse("{\"spreadsheetId\":\"id\",\"updatedCells\":1}"));
+
+    FirebaseJson valueRange, response;
+    valueRange.add("range", "Sheet1!A1");
+    for (size_t i = 0; i < cells; i++)
+        valueRange.set("values/[" + String((int)i) + "]/[0]", "value");
+    return GSheet.values.update(&response, "id", "Sheet1!A1", &valueRange);
+}
+
+// The request line, the header block and the body are not the separate writes (TLS records)
+TEST_F(Connection, RequestIsWrittenAtOnce)
+{
+    ASSERT_TRUE(update(1));
+
+    size_t writes = replay.writes();
+    ASSERT_TRUE(update(1));
+    EXPECT_EQ(replay.writes() - writes, 1u);
+}
+
+// The request parts after the connection was dropped are never sent on the new connection
+TEST_F(Connection, DroppedRequestIsNotResumed)
+{
+    GSheet.setRetry(0);
+    size_t streams = replay.streams().size();
+
+    // The request that is larger than the chunk size is written in several writes
+    replay.closeAfterWrites(1);
+    EXPECT_FALSE(update(200));
+    replay.clearResponses();
+
+    EXPECT_TRUE(update(1));
+
+    for (size_t i = streams; i < replay.streams().size(); i++)
+    {
+        const std::string &stream = replay.streams()[i];
+        EXPECT_TRUE(stream.empty() || stream.compare(0, 4, "PUT ") == 0 || stream.compare(0, 4, "GET ") == 0 ||
+                    stream.compare(0, 5, "POST ") == 0)
+            << stream.substr(0, 40);
+    }
+}
+
+// The connection that the server half-closed is replaced before the request is written into it
+TEST_F(Connection, HalfClosedConnectionIsReconnected)
+{
+    GSheet.setRetry(0);
+    connects(1);
+
+    // The TLS close_notify alert record
+    replay.halfClose(std::string("\x15\x03\x03\x00\x02\x01\x00", 7));
+    size_t streams = replay.streams().size();
+    size_t written = replay.streams().back().size();
+
+    EXPECT_EQ(connects(1), 1u);
+    EXPECT_EQ(replay.streams()[streams - 1].size(), written);
+}
+
+// The connection that was idle for longer than the server idle timeout is replaced before sending
+TEST_F(Connection, IdleConnectionIsReconnected)
+{
+    GSheet.setKeepWarm(10 * 1000, 0);
+    connects(1);
+
+    advanceMillis(9 * 1000);
+    EXPECT_EQ(connects(1), 0u);
+
+    advanceMillis(10 * 1000);
+    EXPECT_EQ(connects(1), 1u);
+
+    GSheet.setKeepWarm(0, 0);
+}
+
+// The connection is renewed from ready() shortly before the server idle timeout
+TEST_F(Connection, KeepWarmRenewsBeforeIdleTimeout)
+{
+    GSheet.setKeepWarm(10 * 1000, 60 * 1000);
+    connects(1);
+
+    // Not within the margin yet
+    advanceMillis(5 * 1000);
+    size_t connects = replay.connects();
+    ASSERT_TRUE(GSheet.ready());
+    EXPECT_EQ(replay.connects() - connects, 0u);
+
+    advanceMillis(3 * 1000);
+    ASSERT_TRUE(GSheet.ready());
+    EXPECT_EQ(replay.connects() - connects, 1u);
+
+    // The renewed connection is not idle expired
+    advanceMillis(3 * 1000);
+    EXPECT_EQ(Connection::connects(1), 0u);
+
+    GSheet.setKeepWarm(0, 0);
+}
+
+// The ping request resets the server idle timer and keeps the connection
+TEST_F(Connection, KeepWarmPingsBeforeIdleTimeout)
+{
+    GSheet.setKeepWarm(10 * 1000, 60 * 1000, true);
+    connects(1);
+
+    replay.addResponse("GET / ", HostHelper::jsonResponse("", 404, "Not Found"));
+    advanceMillis(8 * 1000);
+    size_t connects = replay.connects();
+    ASSERT_TRUE(GSheet.ready());
+    EXPECT_EQ(replay.queued(), 0u);
+    EXPECT_EQ(replay.lastRequest().compare(0, 6, "GET / "), 0);
+
+    advanceMillis(3 * 1000);
+    EXPECT_EQ(Connection::connects(1), 0u);
+    EXPECT_EQ(replay.connects() - connects, 0u);
+
+    GSheet.setKeepWarm(0, 0);
+}
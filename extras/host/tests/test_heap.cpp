@@ -0,0 +1,49 @@
+/**
+ * The heap accounting, every counted block is untracked by the site that allocated it.
+ *
+ * Built with MB_HEAP_ACCOUNTING and AddressSanitizer, the block that was freed through the wrong
+ * allocator or the header that was read from a foreign block fails the test.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+static FileReplayClient replay;
+
+TEST(Heap, BufferIsCountedUntilFreed)
+{
+    MB_FS mbfs;
+    MB_Heap::scope() = mb_heap_scope_request;
+    uint32_t live = MB_Heap::stats()[mb_heap_scope_request].live;
+
+    uint8_t *buf = MemoryHelper::createBuffer<uint8_t *>(&mbfs, 100);
+    ASSERT_NE(buf, nullptr);
+    EXPECT_GE(MB_Heap::stats()[mb_heap_scope_request].live, live + 100);
+
+    MemoryHelper::freeBuffer(&mbfs, buf);
+    EXPECT_EQ(MB_Heap::stats()[mb_heap_scope_request].live, live);
+    MB_Heap::scope() = mb_heap_scope_other;
+}
+
+TEST(Heap, StringIsCountedUntilDestroyed)
+{
+    uint32_t live = MB_Heap::stats()[mb_heap_scope_total].live;
+    {
+        MB_String s;
+        s.reserve(256);
+        EXPECT_GE(MB_Heap::stats()[mb_heap_scope_total].live, live + 256);
+    }
+    EXPECT_EQ(MB_Heap::stats()[mb_heap_scope_total].live, live);
+}
+
+// The JWT signature is freed with the token buffers, its allocation must be counted with the header
+TEST(Heap, TokenExchangeFreesTheSignature)
+{
+    ASSERT_TRUE(HostHelper::begin(replay));
+
+    replay.addResponse("GET /v4/spreadsheets/", HostHelper::jsonResponse("{\"range\":\"Sheet1!A1\",\"values\":[[\"1\"]]}"));
+    String response;
+    EXPECT_TRUE(GSheet.values.get(&response, "id", "Sheet1!A1"));
+}
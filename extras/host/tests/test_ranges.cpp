@@ -0,0 +1,120 @@
+/**
+ * The range planner of batchGet and batchClear, only the bounded ranges of the same sheet are merged.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+static FileReplayClient replay;
+
+struct Plan
+{
+    bool merged = false;
+    std::vector<std::string> planned;
+    std::vector<size_t> owner;
+};
+
+static Plan plan(std::vector<const char *> ranges)
+{
+    std::vector<MB_String> rngs;
+    for (const char *r : ranges)
+        rngs.push_back(r);
+
+    std::vector<esp_google_sheet_a1_range_t> requested, planned;
+    Plan p;
+    p.merged = RangeHelper::plan(rngs, requested, planned, p.owner);
+    MB_String s;
+    for (size_t i = 0; i < planned.size(); i++)
+    {
+        RangeHelper::toString(planned[i], s);
+        p.planned.push_back(s.c_str());
+    }
+    return p;
+}
+
+TEST(RangeHelper, CellBounds)
+{
+    uint32_t col, row;
+    EXPECT_TRUE(RangeHelper::parseCell("A1", 2, col, row));
+    EXPECT_TRUE(RangeHelper::parseCell("XFD10000000", 11, col, row));
+    EXPECT_EQ(col, 16384u);
+    EXPECT_EQ(row, 10000000u);
+    EXPECT_FALSE(RangeHelper::parseCell("XFE1", 4, col, row));
+    EXPECT_FALSE(RangeHelper::parseCell("ABCD1", 5, col, row));
+    EXPECT_FALSE(RangeHelper::parseCell("A10000001", 9, col, row));
+    EXPECT_FALSE(RangeHelper::parseCell("A99999999999", 12, col, row));
+    EXPECT_FALSE(RangeHelper::parseCell("Sheet1", 6, col, row));
+    EXPECT_FALSE(RangeHelper::parseCell("Data2024", 8, col, row));
+}
+
+TEST(RangeHelper, BareSheetNameIsWholeSheet)
+{
+    esp_google_sheet_a1_range_t range;
+    ASSERT_TRUE(RangeHelper::parse("Sheet1", range));
+    EXPECT_TRUE(range.whole);
+    EXPECT_STREQ(range.sheet.c_str(), "Sheet1");
+
+    MB_String s;
+    RangeHelper::toString(range, s);
+    EXPECT_STREQ(s.c_str(), "Sheet1");
+}
+
+TEST(RangeHelper, PlanMergesAdjacentAndOverlapping)
+{
+    Plan p = plan({"Sheet1!A1:B2", "Sheet1!C1:D2", "Sheet1!A3:D5"});
+    ASSERT_TRUE(p.merged);
+    ASSERT_EQ(p.planned.size(), 1u);
+    EXPECT_EQ(p.planned[0], "Sheet1!A1:D5");
+    EXPECT_EQ(p.owner, (std::vector<size_t>{0, 0, 0}));
+
+    p = plan({"'My Sheet'!B2:C8", "My Sheet!B4:C6"});
+    ASSERT_TRUE(p.merged);
+    EXPECT_EQ(p.planned, (std::vector<std::string>{"'My Sheet'!B2:C8"}));
+
+    // The different sheets and the non-rectangular union are not merged
+    EXPECT_FALSE(plan({"Sheet1!A1:B2", "Sheet2!C1:D2"}).merged);
+    EXPECT_FALSE(plan({"Sheet1!A1:B2", "Sheet1!C3:D4"}).merged);
+}
+
+TEST(RangeHelper, PlanKeepsBareSheetNames)
+{
+    EXPECT_FALSE(plan({"Sheet1", "Sheet2"}).merged);
+    EXPECT_FALSE(plan({"Data2024", "Data2025"}).merged);
+    EXPECT_FALSE(plan({"Sheet1", "Sheet1"}).merged);
+    EXPECT_FALSE(plan({"Sheet1", "Sheet1!A1:B2"}).merged);
+    EXPECT_FALSE(plan({"A1", "B1"}).merged);
+
+    Plan p = plan({"Sheet1", "Sheet2!A1:B2", "Sheet2!C1:D2"});
+    ASSERT_TRUE(p.merged);
+    EXPECT_EQ(p.planned, (std::vector<std::string>{"Sheet1", "Sheet2!A1:D2"}));
+    EXPECT_EQ(p.owner, (std::vector<size_t>{0, 1, 1}));
+}
+
+TEST(Values, BatchGetWithBareSheetName)
+{
+    ASSERT_TRUE(HostHelper::begin(replay));
+
+    std::string payload =
+        "{\"spreadsheetId\":\"id\",\"valueRanges\":["
+        "{\"range\":\"Sheet1!A1:Z1000\",\"majorDimension\":\"ROWS\",\"values\":[[\"a\",\"b\"],[\"c\"]]},"
+        "{\"range\":\"Sheet2!A1:D2\",\"majorDimension\":\"ROWS\",\"values\":[[\"1\",\"2\",\"3\",\"4\"],[\"5\",\"6\",\"7\",\"8\"]]}]}";
+    replay.addResponse("GET /v4/spreadsheets/", HostHelper::jsonResponse(payload));
+
+    FirebaseJson response;
+    ASSERT_TRUE(GSheet.values.batchGet(&response, "id", "Sheet1,Sheet2!A1:B2,Sheet2!C1:D2")) << GSheet.errorReason().c_str();
+
+    EXPECT_EQ(HostHelper::params(replay.lastRequest(), "ranges"), (std::vector<std::string>{"Sheet1", "Sheet2!A1:D2"}));
+
+    FirebaseJsonData result;
+    ASSERT_TRUE(response.get(result, "valueRanges/[0]/range"));
+    EXPECT_STREQ(result.stringValue.c_str(), "Sheet1!A1:Z1000");
+    ASSERT_TRUE(response.get(result, "valueRanges/[0]/values/[1]/[0]"));
+    EXPECT_STREQ(result.stringValue.c_str(), "c");
+
+    ASSERT_TRUE(response.get(result, "valueRanges/[1]/range"));
+    EXPECT_STREQ(result.stringValue.c_str(), "Sheet2!A1:B2");
+    ASSERT_TRUE(response.get(result, "valueRanges/[2]/values/[1]/[1]"));
+    EXPECT_STREQ(result.stringValue.c_str(), "8");
+}
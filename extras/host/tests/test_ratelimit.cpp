@@ -0,0 +1,93 @@
+/**
+ * The client side rate limit, off by default, the queued reads are delayed to the later ready() calls
+ * and the read and write buckets are configured separately.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+static FileReplayClient replay;
+
+class RateLimit : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite() { ASSERT_TRUE(HostHelper::begin(replay)); }
+
+    void SetUp() override { GSheet.resetRateLimitStats(); }
+
+    void TearDown() override
+    {
+        GSheet.setRateLimit(0, 0);
+        replay.clearResponses();
+    }
+
+    static void queueRead()
+    {
+        replay.addResponse("GET /v4/spreadsheets/", HostHelper::jsonResponse("{\"spreadsheetId\":\"id\",\"valueRanges\":[{\"range\":\"Sheet1!A1\",\"values\":[[\"1\"]]}]}"));
+    }
+
+    static bool write()
+    {
+        replay.addResponse("PUT /v4/spreadsheets/", HostHelper::jsonResponse("{\"spreadsheetId\":\"id\",\"updatedCells\":1}"));
+
+        FirebaseJson valueRange, response;
+        valueRange.add("range", "Sheet1!A1");
+        valueRange.set("values/[0]/[0]", "x");
+        return GSheet.values.update(&response, "id", "Sheet1!A1", &valueRange);
+    }
+};
+
+TEST_F(RateLimit, OffByDefault)
+{
+    unsigned long ms = millis();
+    for (int i = 0; i < 80; i++)
+    {
+        queueRead();
+        FirebaseJson response;
+        ASSERT_TRUE(GSheet.values.get(&response, "id", "Sheet1!A1"));
+    }
+
+    EXPECT_LT(millis() - ms, 1000u);
+    EXPECT_EQ(GSheet.rateLimitStats().throttled, 0u);
+}
+
+TEST_F(RateLimit, QueuedReadsAreDelayed)
+{
+    GSheet.setRateLimit(60, 0, 1);
+    GSheet.values.setQueueWindow(0);
+
+    FirebaseJson first, second;
+    queueRead();
+    ASSERT_TRUE(GSheet.values.queueGet(&first, "id", "Sheet1!A1"));
+    GSheet.ready();
+    EXPECT_EQ(GSheet.values.queuedGet(), 0u);
+
+    // The next read has no quota for about a second, ready() returns without waiting for it
+    queueRead();
+    ASSERT_TRUE(GSheet.values.queueGet(&second, "id", "Sheet1!A1"));
+    unsigned long ms = millis();
+    GSheet.ready();
+    EXPECT_LT(millis() - ms, 100u);
+    EXPECT_EQ(GSheet.values.queuedGet(), 1u);
+
+    while (GSheet.values.queuedGet() > 0 && millis() - ms < 3000)
+        GSheet.ready();
+
+    EXPECT_EQ(GSheet.values.queuedGet(), 0u);
+    EXPECT_GE(millis() - ms, 900u);
+    EXPECT_EQ(GSheet.rateLimitStats().throttled, 0u);
+}
+
+TEST_F(RateLimit, WriteBurstIsSeparate)
+{
+    GSheet.setRateLimit(60, 60, 1, 5);
+
+    unsigned long ms = millis();
+    for (int i = 0; i < 5; i++)
+        ASSERT_TRUE(write());
+
+    EXPECT_LT(millis() - ms, 500u);
+    EXPECT_EQ(GSheet.rateLimitStats().throttled, 0u);
+}
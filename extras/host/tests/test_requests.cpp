@@ -0,0 +1,105 @@
+/**
+ * The request builders, the request is composed into one buffer that was reserved by the measure pass.
+ *
+ * Built with MB_HEAP_ACCOUNTING, the allocations of the request scope are counted from the token check
+ * to the sending of the request.
+ */
+
+#include <gtest/gtest.h>
+
+#include <functional>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+static FileReplayClient replay;
+
+class Requests : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite() { ASSERT_TRUE(HostHelper::begin(replay)); }
+
+    // Run the call with the queued response and get the number of the request scope allocations,
+    // the first call on the host is not counted as it includes the connection setup
+    static uint32_t allocs(const char *request, const std::function<bool()> &call)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            replay.addResponse(request, HostHelper::jsonResponse("{}"));
+            EXPECT_TRUE(call());
+        }
+        return GSheet.heapStats(mb_heap_scope_request).count;
+    }
+
+    static std::string fields()
+    {
+        std::vector<std::string> v = HostHelper::params(replay.lastRequest(), "fields");
+        return v.size() == 1 ? v[0] : "";
+    }
+};
+
+TEST_F(Requests, ValuesGet)
+{
+    FirebaseJson response;
+    uint32_t base = allocs("GET /v4/spreadsheets/", [&]
+                           { return GSheet.values.get(&response, "id", "Sheet1!A1:B2"); });
+    uint32_t masked = allocs("GET /v4/spreadsheets/", [&]
+                             { return GSheet.values.get(&response, "id", "Sheet1!A1:B2", GSHEET_FIELDS(range, majorDimension, values)); });
+
+    EXPECT_EQ(fields(), "range%2CmajorDimension%2Cvalues");
+    EXPECT_EQ(base, 1u);
+    EXPECT_EQ(masked, base);
+}
+
+TEST_F(Requests, ValuesBatchGet)
+{
+    FirebaseJson response;
+    uint32_t base = allocs("GET /v4/spreadsheets/", [&]
+                           { return GSheet.values.batchGet(&response, "id", "Sheet1!A1:B2,Sheet2!A1:B2"); });
+    uint32_t masked = allocs("GET /v4/spreadsheets/", [&]
+                             { return GSheet.values.batchGet(&response, "id", "Sheet1!A1:B2,Sheet2!A1:B2", "", "", "", GSHEET_FIELDS_VALUE_RANGES); });
+
+    EXPECT_EQ(fields(), "valueRanges(range%2Cvalues)");
+    // The request and the copy of the ranges that is split by the range planner
+    EXPECT_EQ(base, 2u);
+    EXPECT_EQ(masked, base);
+}
+
+TEST_F(Requests, SpreadsheetGet)
+{
+    FirebaseJson response;
+    uint32_t base = allocs("GET /v4/spreadsheets/", [&]
+                           { return GSheet.get(&response, "id"); });
+    uint32_t masked = allocs("GET /v4/spreadsheets/", [&]
+                             { return GSheet.get(&response, "id", "", "", GSHEET_FIELDS_SPREADSHEET_ID "," GSHEET_FIELDS_SHEETS_PROPERTIES); });
+
+    EXPECT_EQ(fields(), "spreadsheetId%2Csheets(properties(sheetId%2Ctitle%2Cindex%2CgridProperties))");
+    EXPECT_EQ(base, 1u);
+    EXPECT_EQ(masked, base);
+}
+
+TEST_F(Requests, DeveloperMetadataGet)
+{
+    FirebaseJson response;
+    uint32_t base = allocs("GET /v4/spreadsheets/", [&]
+                           { return GSheet.developerMetadata.get(&response, "id", 1); });
+    uint32_t masked = allocs("GET /v4/spreadsheets/", [&]
+                             { return GSheet.developerMetadata.get(&response, "id", 1, GSHEET_FIELDS_DEVELOPER_METADATA); });
+
+    EXPECT_EQ(fields(), "metadataId%2CmetadataKey%2CmetadataValue");
+    EXPECT_EQ(base, 1u);
+    EXPECT_EQ(masked, base);
+}
+
+TEST_F(Requests, ListFiles)
+{
+    FirebaseJson response;
+    uint32_t base = allocs("GET /drive/v3/files", [&]
+                           { return GSheet.listFiles(&response); });
+    uint32_t masked = allocs("GET /drive/v3/files", [&]
+                             { return GSheet.listFiles(&response, 5, "createdTime%20desc", "", GSHEET_FIELDS_FILES); });
+
+    EXPECT_EQ(fields(), "nextPageToken%2Cfiles(id%2Cname)");
+    EXPECT_EQ(base, 1u);
+    EXPECT_EQ(masked, base);
+}
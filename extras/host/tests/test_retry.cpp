@@ -0,0 +1,110 @@
+/**
+ * The retry of the rejected requests, the append and batchUpdate are never repeated after the 5xx error
+ * that the server may have sent after it committed them.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FileReplayClient.h"
+#include "HostHelper.h"
+
+static FileReplayClient replay;
+
+static const char *ok = "{\"spreadsheetId\":\"id\"}";
+static const char *error = "{\"error\":{\"code\":500,\"message\":\"Internal error encountered.\"}}";
+
+class Retry : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        ASSERT_TRUE(HostHelper::begin(replay));
+        GSheet.setRetry(3, 10, 20);
+    }
+
+    void SetUp() override { replay.clearResponses(); }
+
+    // Queue the error response and the success response, the request was retried when both were taken
+    static void queue(const char *request, int code, const char *status, const char *headers = "")
+    {
+        replay.addResponse(request, HostHelper::jsonResponse(error, code, status, headers));
+        replay.addResponse(request, HostHelper::jsonResponse(ok));
+    }
+
+    static bool append()
+    {
+        FirebaseJson valueRange, response;
+        valueRange.set("values/[0]/[0]", "x");
+        return GSheet.values.append(&response, "id", "Sheet1!A1", &valueRange);
+    }
+
+    static bool batchUpdate()
+    {
+        FirebaseJsonArray data;
+        FirebaseJson valueRange, response;
+        valueRange.add("range", "Sheet1!A1");
+        valueRange.set("values/[0]/[0]", "x");
+        data.add(valueRange);
+        return GSheet.values.batchUpdate(&response, "id", &data);
+    }
+
+    static bool update()
+    {
+        FirebaseJson valueRange, response;
+        valueRange.set("values/[0]/[0]", "x");
+        return GSheet.values.update(&response, "id", "Sheet1!A1", &valueRange);
+    }
+};
+
+TEST_F(Retry, AppendIsNotRepeatedAfterServerError)
+{
+    const int codes[] = {500, 502, 503, 504};
+    for (int code : codes)
+    {
+        replay.clearResponses();
+        queue("POST /v4/spreadsheets/", code, "Error");
+        EXPECT_FALSE(append()) << code;
+        EXPECT_EQ(replay.queued(), 1u) << code;
+
+        replay.clearResponses();
+        queue("POST /v4/spreadsheets/", code, "Error");
+        EXPECT_FALSE(batchUpdate()) << code;
+        EXPECT_EQ(replay.queued(), 1u) << code;
+    }
+}
+
+TEST_F(Retry, AppendIsRetriedWhenRejected)
+{
+    queue("POST /v4/spreadsheets/", 429, "Too Many Requests");
+    EXPECT_TRUE(append());
+    EXPECT_EQ(replay.queued(), 0u);
+
+    queue("POST /v4/spreadsheets/", 503, "Service Unavailable", "Retry-After: 1\r\n");
+    EXPECT_TRUE(batchUpdate());
+    EXPECT_EQ(replay.queued(), 0u);
+}
+
+TEST_F(Retry, UpdateIsRetriedAfterServerError)
+{
+    const int codes[] = {500, 502, 503, 504};
+    for (int code : codes)
+    {
+        replay.clearResponses();
+        queue("PUT /v4/spreadsheets/", code, "Error");
+        EXPECT_TRUE(update()) << code;
+        EXPECT_EQ(replay.queued(), 0u) << code;
+    }
+}
+
+TEST_F(Retry, ClearIsRetriedAfterServerError)
+{
+    FirebaseJson response;
+
+    queue("POST /v4/spreadsheets/", 500, "Internal Server Error");
+    EXPECT_TRUE(GSheet.values.clear(&response, "id", "Sheet1!A1:B2"));
+    EXPECT_EQ(replay.queued(), 0u);
+
+    queue("POST /v4/spreadsheets/", 502, "Bad Gateway");
+    EXPECT_TRUE(GSheet.values.batchClear(&response, "id", "Sheet1!A1:B2,Sheet2!A1"));
+    EXPECT_EQ(replay.queued(), 0u);
+}
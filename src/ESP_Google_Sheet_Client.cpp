@@ -13,15 +13,27 @@ GSheetClass::GSheetClass()
 {
     authMan.begin(&config, &mbfs, &mb_ts, &mb_ts_offset);
     authMan.newClient(&authMan.tcpClient);
+    config.rate_limit.read.perMinute = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_READ_REQUESTS_PER_MINUTE;
+    config.rate_limit.write.perMinute = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_WRITE_REQUESTS_PER_MINUTE;
 }
 
 GSheetClass::~GSheetClass()
 {
+    for (size_t i = 0; i < accounts.size(); i++)
+    {
+        if (accounts[i].der)
+            MemoryHelper::freeBuffer(&mbfs, accounts[i].der);
+    }
     authMan.end();
+    enableMetrics(false);
 }
 
 void GSheetClass::auth(const char *client_email, const char *project_id, const char *private_key, const char *sa_key_file, esp_google_sheet_file_storage_type storage_type, ESP8266_SPI_ETH_MODULE *eth)
 {
+    // The account of begin is the first account in the registry
+    activateAccount(0);
+    selected_account = 0;
+
     config.service_account.data.client_email = client_email;
     config.service_account.data.project_id = project_id;
     config.service_account.data.private_key = private_key;
@@ -68,9 +80,39 @@ void GSheetClass::clearAP()
     config.wifi.clearAP();
 }
 
-bool GSheetClass::checkToken()
+bool GSheetClass::checkToken(bool background)
 {
-    return authMan.tokenReady();
+    unsigned long ms = millis(), us = micros();
+
+    // The previous operation that was not completed by setResponse
+    commitTiming();
+
+    MB_Heap::reset();
+    MB_Heap::scope() = mb_heap_scope_auth;
+
+    // The requests use the selected account, the other accounts are refreshed in background
+    if (background)
+        accountTask();
+    else
+        activateAccount(selected_account);
+
+    bool ret = authMan.tokenReady(background);
+
+    if (config.signer.step != gauth_jwt_generation_step_begin)
+        signer_account = active_account;
+
+    if (active_account != selected_account)
+        ret = accountTokenValid(selected_account);
+
+    MB_Heap::scope() = mb_heap_scope_request;
+
+    // The token request phases are counted in the token time
+    config.timing = RequestTiming();
+    config.timing.startMillis = ms;
+    config.timing.token = micros() - us;
+    timing_micros = us;
+
+    return ret;
 }
 
 String GSheetClass::accessToken()
@@ -84,6 +126,257 @@ void GSheetClass::setPrerefreshSeconds(uint16_t seconds)
         config.signer.preRefreshSeconds = seconds;
 }
 
+void GSheetClass::setRateLimit(uint16_t readPerMinute, uint16_t writePerMinute, uint16_t readBurst, uint16_t writeBurst)
+{
+    config.rate_limit.read.perMinute = readPerMinute;
+    config.rate_limit.write.perMinute = writePerMinute;
+    config.rate_limit.read.burst = readBurst > 0 ? readBurst : 1;
+    config.rate_limit.write.burst = writeBurst > 0 ? writeBurst : 1;
+    config.rate_limit.read.lastRefillMillis = 0;
+    config.rate_limit.write.lastRefillMillis = 0;
+}
+
+void GSheetClass::setRetry(uint8_t maxRetry, unsigned long backoffBase, unsigned long backoffMax, unsigned long maxWait)
+{
+    config.rate_limit.maxRetry = maxRetry;
+    config.rate_limit.backoffBase = backoffBase;
+    config.rate_limit.backoffMax = backoffMax < backoffBase ? backoffBase : backoffMax;
+    config.rate_limit.maxWait = maxWait;
+}
+
+void GSheetClass::refillBucket(esp_google_sheet_rate_limit_bucket_t &bucket)
+{
+    unsigned long now = millis();
+
+    if (bucket.lastRefillMillis == 0)
+        bucket.tokens = bucket.burst;
+    else
+        bucket.tokens += (float)(now - bucket.lastRefillMillis) * bucket.perMinute / 60000.0f;
+
+    if (bucket.tokens > bucket.burst)
+        bucket.tokens = bucket.burst;
+
+    bucket.lastRefillMillis = now > 0 ? now : 1;
+}
+
+unsigned long GSheetClass::quotaWait(bool write)
+{
+    esp_google_sheet_rate_limit_t &rl = config.rate_limit;
+    esp_google_sheet_rate_limit_bucket_t &bucket = write ? rl.write : rl.read;
+
+    // The time to wait for the server hold off (Retry-After or backoff) and the next free bucket token
+    unsigned long hold = 0;
+    if (rl.holdMs > 0 && millis() - rl.holdMillis < rl.holdMs)
+        hold = rl.holdMs - (millis() - rl.holdMillis);
+
+    unsigned long wait = 0;
+    if (bucket.perMinute > 0)
+    {
+        refillBucket(bucket);
+        if (bucket.tokens < 1)
+            wait = (unsigned long)((1 - bucket.tokens) * 60000.0f / bucket.perMinute) + 1;
+    }
+
+    return hold > wait ? hold : wait;
+}
+
+bool GSheetClass::waitRequestQuota(bool write)
+{
+    esp_google_sheet_rate_limit_t &rl = config.rate_limit;
+    esp_google_sheet_rate_limit_bucket_t &bucket = write ? rl.write : rl.read;
+
+    unsigned long wait = quotaWait(write);
+
+    if (wait > rl.maxWait)
+    {
+        rl.stats.dropped++;
+        return false;
+    }
+
+    if (wait > 0)
+    {
+        rl.stats.throttled++;
+        unsigned long ms = millis();
+        while (millis() - ms < wait)
+        {
+            Utils::idle();
+        }
+    }
+
+    if (bucket.perMinute > 0)
+    {
+        refillBucket(bucket);
+        bucket.tokens -= 1;
+    }
+
+    return true;
+}
+
+void GSheetClass::setTimingBuffer(size_t size)
+{
+    timing_buf.clear();
+    timing_buf.reserve(size);
+    timing_buf_size = size;
+    timing_buf_idx = 0;
+}
+
+bool GSheetClass::getTiming(size_t index, RequestTiming &timing)
+{
+    if (index >= timing_buf.size())
+        return false;
+
+    // The oldest record is at timing_buf_idx when the buffer is full
+    timing = timing_buf[(timing_buf_idx + index) % timing_buf.size()];
+    return true;
+}
+
+void GSheetClass::commitTiming()
+{
+    if (!timing_pending)
+        return;
+
+    timing_pending = false;
+    config.timing.total = micros() - timing_micros;
+
+    for (int i = 0; i < mb_heap_scope_max; i++)
+        heap_stats[i] = MB_Heap::stats()[i];
+
+    config.timing.heapPeak = heap_stats[mb_heap_scope_total].peak;
+    config.timing.allocs = heap_stats[mb_heap_scope_total].count;
+    MB_Heap::scope() = mb_heap_scope_other;
+
+    if (timing_buf_size > 0)
+    {
+        if (timing_buf.size() < timing_buf_size)
+            timing_buf.push_back(config.timing);
+        else
+        {
+            timing_buf[timing_buf_idx] = config.timing;
+            timing_buf_idx = (timing_buf_idx + 1) % timing_buf_size;
+        }
+    }
+
+    if (timing_cb)
+        timing_cb(config.timing);
+}
+
+void GSheetClass::enableMetrics(bool enable)
+{
+    if (enable && !config.metrics)
+        config.metrics = new esp_google_sheet_metrics_t();
+    else if (!enable && config.metrics)
+    {
+        delete config.metrics;
+        config.metrics = nullptr;
+    }
+}
+
+void GSheetClass::resetMetrics()
+{
+    if (config.metrics)
+        *config.metrics = esp_google_sheet_metrics_t();
+}
+
+void GSheetClass::printMetrics(Print &out, esp_google_sheet_metrics_format format)
+{
+    if (!config.metrics)
+        return;
+
+    if (format == esp_google_sheet_metrics_format_json)
+        MetricsHelper::printJson(out, *config.metrics);
+    else
+        MetricsHelper::printPrometheus(out, *config.metrics);
+}
+
+bool GSheetClass::dumpTrace(const char *filename, esp_google_sheet_file_storage_type storage_type)
+{
+    return TraceHelper::dump(&mbfs, filename, mbfs_type storage_type);
+}
+
+void GSheetClass::setResponse(FirebaseJson *json, MB_String &response)
+{
+    unsigned long us = micros();
+    json->setJsonData(response);
+    config.timing.parse += micros() - us;
+    commitTiming();
+}
+
+void GSheetClass::setResponse(String *str, MB_String &response)
+{
+    *str = response.c_str();
+    commitTiming();
+}
+
+bool GSheetClass::idempotentRequest(const MB_String &req)
+{
+    // GET, PUT (values update) and DELETE
+    if (req[0] != 'P' || req[1] == 'U')
+        return true;
+
+    // The POST method e.g. values/Sheet1!A1:B2:clear and values:batchClear, the path ends with the method name
+    size_t end = req.find("?");
+    if (end == MB_String::npos)
+        end = req.find(" HTTP/1.1");
+    size_t pos = req.find_last_of(":", end);
+    if (pos == MB_String::npos)
+        return false;
+
+    MB_String method = req.substr(pos + 1, end - pos - 1);
+    return method == "clear" || method == "batchClear" || method == "batchClearByDataFilter" ||
+           method == "batchGetByDataFilter" || method == "getByDataFilter";
+}
+
+bool GSheetClass::retryRequest(int httpcode, uint8_t attempt, bool idempotent)
+{
+    esp_google_sheet_rate_limit_t &rl = config.rate_limit;
+
+    // The append and batchUpdate may have been committed before the 5xx error, they are only
+    // retried when the server rejected them without processing
+    bool retry = httpcode == ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_TOO_MANY_REQUESTS ||
+                 (httpcode == ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_SERVICE_UNAVAILABLE && authMan.retry_after > 0);
+
+    if (idempotent)
+        retry = retry || httpcode == ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_INTERNAL_SERVER_ERROR ||
+                httpcode == ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_BAD_GATEWAY ||
+                httpcode == ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_SERVICE_UNAVAILABLE ||
+                httpcode == ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_GATEWAY_TIMEOUT;
+
+    if (!retry)
+        return false;
+
+    unsigned long delayMs = 0;
+
+    if (authMan.retry_after > 0)
+        delayMs = (unsigned long)authMan.retry_after * 1000;
+    else
+    {
+        // Exponential backoff with the equal jitter, half of the delay is random
+        delayMs = rl.backoffBase;
+        for (uint8_t i = 0; i < attempt && delayMs < rl.backoffMax; i++)
+            delayMs <<= 1;
+
+        if (delayMs > rl.backoffMax)
+            delayMs = rl.backoffMax;
+
+        delayMs = delayMs / 2 + random(delayMs / 2 + 1);
+    }
+
+    // All requests (not only this one) should be held until the delay elapsed
+    rl.holdMillis = millis();
+    rl.holdMs = delayMs;
+
+    if (attempt >= rl.maxRetry)
+    {
+        rl.stats.dropped++;
+        return false;
+    }
+
+    rl.stats.retried++;
+    if (config.metrics)
+        config.metrics->retries++;
+    return true;
+}
+
 bool GSheetClass::setClock(float gmtOffset)
 {
     return TimeHelper::syncClock(&mb_ts, &mb_ts_offset, gmtOffset, &config);
@@ -108,52 +401,135 @@ bool GSheetClass::beginRequest(MB_String &req, host_type_t host_type)
     if (!setSecure())
         return false;
 
-    if (client && !client->connected())
+    // The kept alive connection that was closed by the server is reconnected before sending
+    if (client && client->stale())
     {
+        client->stop();
+        beginHost(host_type);
+    }
+
+    return true;
+}
+
+void GSheetClass::beginHost(host_type_t host_type)
+{
+    GS_TCP_Client *client = authMan.tcpClient;
 
 #if defined(ESP8266) || defined(MB_ARDUINO_PICO)
-        if (host_type == host_type_sheet)
-            client->ethDNSWorkAround(&config.spi_ethernet_module, (const char *)FPSTR("sheets.googleapis.com"), 443);
-        else if (host_type == host_type_drive)
-            client->ethDNSWorkAround(&config.spi_ethernet_module, (const char *)FPSTR("www.googleapis.com"), 443);
+    if (host_type == host_type_sheet)
+        client->ethDNSWorkAround(&config.spi_ethernet_module, (const char *)FPSTR("sheets.googleapis.com"), 443);
+    else if (host_type == host_type_drive)
+        client->ethDNSWorkAround(&config.spi_ethernet_module, (const char *)FPSTR("www.googleapis.com"), 443);
 #endif
 
-        if (host_type == host_type_sheet)
-            client->begin((const char *)FPSTR("sheets.googleapis.com"), 443, &response_code);
-        else if (host_type == host_type_drive)
-            client->begin((const char *)FPSTR("www.googleapis.com"), 443, &response_code);
-    }
+    if (host_type == host_type_sheet)
+        client->begin((const char *)FPSTR("sheets.googleapis.com"), 443, &response_code);
+    else if (host_type == host_type_drive)
+        client->begin((const char *)FPSTR("www.googleapis.com"), 443, &response_code);
 
-    return true;
+    conn_host = host_type;
 }
 
-void GSheetClass::addHeader(MB_String &req, host_type_t host_type, int len)
+void GSheetClass::setKeepWarm(unsigned long idleTimeout, unsigned long window, bool ping)
 {
-    req += FPSTR(" HTTP/1.1\r\n");
-    if (host_type == host_type_sheet)
+    config.timeout.serverIdle = idleTimeout;
+    keep_warm_window = window;
+    keep_warm_ping = ping;
+}
+
+void GSheetClass::keepWarmTask()
+{
+    GS_TCP_Client *client = authMan.tcpClient;
+
+    // Only while the next request is expected and the token request is not using the client
+    if (!client || config.timeout.serverIdle == 0 || last_request_millis == 0 ||
+        millis() - last_request_millis > keep_warm_window || config.internal.processing)
+        return;
+
+    unsigned long margin = config.timeout.serverIdle / 4;
+    if (margin > ESP_GOOGLE_SHEET_CLIENT_KEEP_WARM_MARGIN)
+        margin = ESP_GOOGLE_SHEET_CLIENT_KEEP_WARM_MARGIN;
+
+    if (client->idleMillis() + margin < config.timeout.serverIdle)
+        return;
+
+    if (keep_warm_ping && !client->stale() && pingConnection())
+        return;
+
+    beginHost(conn_host);
+    client->renew();
+}
+
+bool GSheetClass::pingConnection()
+{
+    GS_TCP_Client *client = authMan.tcpClient;
+
+    // The server root responds without the auth, the response resets the server idle timer
+    MB_String req = FPSTR("GET / HTTP/1.1\r\n");
+    if (conn_host == host_type_sheet)
         req += FPSTR("Host: sheets.googleapis.com\r\n");
-    else if (host_type == host_type_drive)
+    else
         req += FPSTR("Host: www.googleapis.com\r\n");
-    req += FPSTR("Authorization: Bearer ");
-    req += config.internal.auth_token;
-    req += FPSTR("\r\n");
+    req += FPSTR("Connection: keep-alive\r\n\r\n");
+
+    if (client->send(req.c_str()) <= 0)
+        return false;
+
+    int httpcode = 0;
+    MB_String payload;
+    authMan.handleResponse(client, httpcode, payload, false);
+
+    return httpcode > 0 && client->connected();
+}
+
+void GSheetClass::addHeader(HttpHelper::RequestComposer &rc, host_type_t host_type, int len)
+{
+    rc += FPSTR(" HTTP/1.1\r\n");
 
     if (len > -1)
     {
-        req += FPSTR("Content-Length: ");
-        req += len;
-        req += FPSTR("\r\n");
+        rc += FPSTR("Content-Length: ");
+        rc += len;
+        rc += FPSTR("\r\n");
 
-        req += FPSTR("Content-Type: application/json\r\n");
+        rc += FPSTR("Content-Type: application/json\r\n");
     }
 
-    req += FPSTR("Connection: keep-alive\r\n");
-    req += FPSTR("Keep-Alive: timeout=30, max=100\r\n");
-    req += FPSTR("Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n");
+    // The static headers are sent from the host header block
+    header_host = host_type;
+}
+
+const char *GSheetClass::headerBlock(host_type_t host_type)
+{
+    header_block_t &hb = header_blocks[host_type];
+
+    // Rebuild only when the block was not built or the access token was changed
+    if (hb.block.length() > 0 && hb.tokenVersion == config.internal.auth_token_version)
+        return hb.block.c_str();
+
+    hb.block.clear();
+    if (host_type == host_type_sheet)
+        hb.block += FPSTR("Host: sheets.googleapis.com\r\n");
+    else if (host_type == host_type_drive)
+        hb.block += FPSTR("Host: www.googleapis.com\r\n");
+    hb.block += FPSTR("Authorization: Bearer ");
+    hb.block += config.internal.auth_token;
+    hb.block += FPSTR("\r\n");
+    hb.block += FPSTR("Connection: keep-alive\r\n");
+    hb.block += FPSTR("Keep-Alive: timeout=30, max=100\r\n");
+    hb.block += FPSTR("Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n");
+    hb.block += FPSTR("\r\n");
+    hb.tokenVersion = config.internal.auth_token_version;
+
+    return hb.block.c_str();
 }
 
 bool GSheetClass::waitClockReady()
 {
+    // The time will be taken from the Date header of the server response
+    if (config.internal.http_date_time)
+        return setClock(config.internal.gmt_offset);
+
     unsigned long ms = millis();
     while (!setClock(config.internal.gmt_offset) && millis() - ms < 3000)
     {
@@ -164,7 +540,7 @@ bool GSheetClass::waitClockReady()
 
 void GSheetClass::setCert(const char *ca)
 {
-    int addr = reinterpret_cast<int>(ca);
+    uintptr_t addr = reinterpret_cast<uintptr_t>(ca);
     if (addr != cert_addr)
     {
         cert_updated = true;
@@ -173,229 +549,919 @@ void GSheetClass::setCert(const char *ca)
     }
 }
 
-void GSheetClass::setCertFile(const char *filename, esp_google_sheet_file_storage_type type)
+void GSheetClass::setCertFile(const char *filename, esp_google_sheet_file_storage_type type)
+{
+    config.cert.file = filename;
+    config.cert.file_storage = (mb_fs_mem_storage_type)type;
+    cert_addr = 0;
+    if (config.cert.file.length() > 0)
+    {
+        cert_updated = true;
+        waitClockReady();
+    }
+}
+
+void GSheetClass::setKeyCacheFile(const char *filename, esp_google_sheet_file_storage_type type)
+{
+    config.service_account.key_cache.path = filename;
+    config.service_account.key_cache.storage_type = (mb_fs_mem_storage_type)type;
+}
+
+void GSheetClass::setTimeFromHttpDate(bool enable)
+{
+    config.internal.http_date_time = enable;
+}
+
+int GSheetClass::addAccount(const char *client_email, const char *project_id, const char *private_key, const char *sa_key_file, esp_google_sheet_file_storage_type storage_type)
+{
+    // The account of begin is the first account
+    if (accounts.size() == 0)
+        accounts.push_back(esp_google_sheet_account_t());
+
+    // The accounts are keyed by client email or key file
+    for (size_t i = 0; i < accounts.size(); i++)
+    {
+        gauth_service_account_t &sa = i == active_account ? config.service_account : accounts[i].service_account;
+        if ((strlen(client_email) > 0 && strcmp(sa.data.client_email.c_str(), client_email) == 0) ||
+            (strlen(sa_key_file) > 0 && strcmp(sa.json.path.c_str(), sa_key_file) == 0))
+            return i;
+    }
+
+    esp_google_sheet_account_t account;
+    account.service_account.data.client_email = client_email;
+    account.service_account.data.project_id = project_id;
+    account.service_account.data.private_key = private_key;
+    account.service_account.json.path = sa_key_file;
+    account.service_account.json.storage_type = (mb_fs_mem_storage_type)storage_type;
+    account.tokens.token_type = token_type_oauth2_access_token;
+    accounts.push_back(account);
+
+    return accounts.size() - 1;
+}
+
+bool GSheetClass::selectAccount(size_t index)
+{
+    if (index > 0 && index >= accounts.size())
+        return false;
+
+    // The queued reads belong to the previous account
+    if (index != selected_account)
+        flushGet();
+
+    selected_account = index;
+    activateAccount(index);
+    return true;
+}
+
+void GSheetClass::activateAccount(size_t index)
+{
+    if (index == active_account || index >= accounts.size())
+        return;
+
+    swapAccount(accounts[active_account]);
+    swapAccount(accounts[index]);
+    active_account = index;
+
+    // The token task can't be continued when the signer buffers were used by the other account
+    if (config.signer.step != gauth_jwt_generation_step_begin && signer_account != index)
+    {
+        config.signer.step = gauth_jwt_generation_step_begin;
+        config.signer.tokens.jwt.clear();
+    }
+
+    // The header blocks are rebuilt with the token of this account
+    config.internal.auth_token_version++;
+}
+
+void GSheetClass::swapAccount(esp_google_sheet_account_t &account)
+{
+    std::swap(config.service_account, account.service_account);
+    std::swap(config.signer.tokens, account.tokens);
+    std::swap(config.signer.step, account.step);
+    std::swap(config.signer.der, account.der);
+    std::swap(config.signer.derLen, account.derLen);
+    config.signer.pk.swap(account.pk);
+    config.internal.auth_token.swap(account.auth_token);
+}
+
+bool GSheetClass::accountTokenValid(size_t index)
+{
+    if (index == active_account)
+        return authMan.tokenValid();
+
+    esp_google_sheet_account_t &account = accounts[index];
+    return account.auth_token.length() > 0 && account.tokens.expires > 0 &&
+           authMan.getTime() + 60 < (time_t)account.tokens.expires;
+}
+
+void GSheetClass::accountTask()
+{
+    // Wait for the token task of the active account
+    if (accounts.size() < 2 || config.signer.step != gauth_jwt_generation_step_begin)
+        return;
+
+    activateAccount(selected_account);
+
+    // The selected account is refreshed first
+    if (authMan.isExpired())
+        return;
+
+    time_t now = authMan.getTime();
+
+    // Start from the last refreshed account to resume its token task
+    for (size_t n = 0; n < accounts.size(); n++)
+    {
+        size_t i = (refresh_account + n) % accounts.size();
+        esp_google_sheet_account_t &account = accounts[i];
+
+        if (i == selected_account)
+            continue;
+
+        // The token task was interrupted by the requests of the selected account
+        bool resume = account.step != gauth_jwt_generation_step_begin;
+
+        bool due = account.tokens.expires == 0 ||
+                   now > (time_t)(account.tokens.expires - config.signer.preRefreshSeconds - account.tokens.jitter);
+
+        if (resume || (due && (account.refresh_millis == 0 ||
+                               millis() - account.refresh_millis > ESP_GOOGLE_SHEET_CLIENT_MIN_TOKEN_GENERATION_ERROR_INTERVAL)))
+        {
+            if (!resume)
+                account.refresh_millis = millis();
+            refresh_account = i;
+            activateAccount(i);
+            return;
+        }
+    }
+}
+
+void GSheetClass::reset()
+{
+    config.internal.client_id.clear();
+    config.internal.client_secret.clear();
+    config.internal.auth_token.clear();
+    config.internal.auth_token_version++;
+    config.internal.last_jwt_generation_error_cb_millis = 0;
+    config.signer.tokens.expires = 0;
+    config.internal.rtoken_requested = false;
+
+    config.internal.priv_key_crc = 0;
+    config.internal.email_crc = 0;
+    config.internal.password_crc = 0;
+
+    config.signer.tokens.status = token_status_uninitialized;
+}
+
+bool GSheetClass::setSecure()
+{
+    GS_TCP_Client *client = authMan.tcpClient;
+
+    if (!client)
+        return false;
+
+    client->setConfig(&config, &mbfs);
+    client->setClock(&mb_ts, &mb_ts_offset);
+
+    if (!authMan.reconnect(client))
+        return false;
+
+#if (defined(ESP8266) || defined(MB_ARDUINO_PICO))
+    if (TimeHelper::getTime(&mb_ts, &mb_ts_offset) > ESP_GOOGLE_SHEET_CLIENT_DEFAULT_TS)
+    {
+        config.internal.clock_rdy = true;
+        client->setClockStatus(true);
+    }
+#endif
+
+    if (client->getCertType() == esp_google_sheet_cert_type_undefined || cert_updated)
+    {
+
+        if (!config.internal.clock_rdy && (config.cert.file.length() > 0 || config.cert.data != NULL || cert_addr > 0))
+            TimeHelper::syncClock(&mb_ts, &mb_ts_offset, config.internal.gmt_offset, &config);
+
+        if (config.cert.file.length() == 0)
+        {
+            if (cert_addr > 0)
+                client->setCACert(reinterpret_cast<const char *>(cert_addr));
+            else if (config.cert.data != NULL)
+                client->setCACert(config.cert.data);
+            else
+                client->setCACert(NULL);
+        }
+        else
+        {
+            if (!client->setCertFile(config.cert.file.c_str(), config.cert.file_storage))
+                client->setCACert(NULL);
+        }
+        cert_updated = false;
+    }
+    return true;
+}
+
+bool GSheetClass::processRequest(MB_String &req, MB_String &response, int &httpcode, const char *body)
+{
+    GS_TCP_Client *client = authMan.tcpClient;
+
+    if (!client)
+        return false;
+
+    // Only the GET requests are counted in the read quota
+    bool write = req[0] != 'G';
+    bool idempotent = idempotentRequest(req);
+    uint8_t attempt = 0;
+    int ret = 0;
+
+    esp_google_sheet_metrics_endpoint endpoint = config.metrics ? MetricsHelper::endpoint(req.c_str()) : esp_google_sheet_metrics_endpoint_other;
+
+    do
+    {
+        config.signer.tokens.error.message.clear();
+
+        unsigned long us = micros();
+        bool quota = waitRequestQuota(write);
+        config.timing.wait += micros() - us;
+        config.timing.retries = attempt;
+        timing_pending = true;
+
+        if (!quota)
+        {
+            authMan.response_code = ESP_GOOGLE_SHEET_CLIENT_ERROR_RATE_LIMIT_EXCEEDED;
+            httpcode = ESP_GOOGLE_SHEET_CLIENT_ERROR_RATE_LIMIT_EXCEEDED;
+            config.timing.httpCode = httpcode;
+            req.clear();
+            return false;
+        }
+
+        authMan.response_code = 0;
+        authMan.retry_after = 0;
+        httpcode = 0;
+        response.clear();
+
+        unsigned long ms = millis();
+
+        GS_TRACE_BEGIN(esp_google_sheet_trace_event_request, attempt);
+
+        // The request line, header block and body are sent without concatenation
+        const char *parts[] = {req.c_str(), headerBlock(header_host), body};
+        ret = client->send(parts, body ? 3 : 2);
+
+        if (ret > 0)
+        {
+            MB_Heap::scope() = mb_heap_scope_response;
+            ret = authMan.handleResponse(client, httpcode, response, false);
+            if (!ret)
+            {
+                authMan.response_code = httpcode;
+                us = micros();
+                FirebaseJson json(response);
+                FirebaseJsonData result;
+                json.get(result, "error/message");
+                config.timing.parse += micros() - us;
+                if (result.success)
+                    config.signer.tokens.error.message = result.stringValue;
+                else
+                    config.signer.tokens.error.message = response;
+            }
+        }
+
+        if (ret < 0)
+        {
+            authMan.response_code = ret;
+            httpcode = ret;
+        }
+
+        if (!ret)
+            client->stop();
+
+        GS_TRACE_END(esp_google_sheet_trace_event_request, httpcode);
+
+        if (config.metrics)
+        {
+            config.metrics->endpoints[endpoint].codes[MetricsHelper::codeClass(httpcode)]++;
+            MetricsHelper::observe(config.metrics->endpoints[endpoint].latency, millis() - ms);
+        }
+
+    } while (ret <= 0 && retryRequest(httpcode, attempt++, idempotent));
+
+    config.timing.httpCode = httpcode;
+
+    unsigned long now = millis();
+    last_request_millis = now > 0 ? now : 1;
+
+    req.clear();
+
+    return ret > 0;
+}
+
+bool GSheetClass::mGet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *majorDimension, const char *valueRenderOption, const char *dateTimeRenderOption, operation_type_t type, const char *fields)
+{
+    MB_String req;
+    const char *body = nullptr;
+    int httpcode = 0;
+
+    // The merged ranges to slice the response back to the requested ranges
+    std::vector<esp_google_sheet_a1_range_t> requested, planned;
+    std::vector<size_t> owner;
+    bool sliced = false;
+
+    // The filter request (POST) is not cached
+    MB_String key;
+    if (cache_size > 0 && type != operation_type_filter)
+    {
+        // The responses of the other accounts are not shared
+        if (accounts.size() > 0)
+        {
+            key += selected_account;
+            key += '|';
+        }
+        key += spreadsheetId;
+        const char *parts[] = {ranges, majorDimension, valueRenderOption, dateTimeRenderOption, fields};
+        for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++)
+        {
+            key += '|';
+            key += parts[i];
+        }
+
+        // The hit needs no token and no network
+        if (cacheGet(key, response))
+            return true;
+    }
+
+    if (!checkToken())
+        return false;
+
+    if (!beginRequest(req, host_type_sheet))
+        return false;
+
+    std::vector<MB_String> rngs = std::vector<MB_String>();
+
+    if (type == operation_type_batch)
+    {
+        MB_String rng = ranges;
+        StringHelper::splitTk(rng, rngs, ",");
+
+        if (rngs.size() == 0)
+            return false;
+
+        // The field mask may exclude the data that is needed for slicing
+        if (strlen(fields) == 0 && RangeHelper::plan(rngs, requested, planned, owner))
+        {
+            sliced = true;
+            rngs.clear();
+            for (size_t i = 0; i < planned.size(); i++)
+            {
+                RangeHelper::toString(planned[i], rng);
+                rngs.push_back(rng);
+            }
+        }
+    }
+
+    HttpHelper::RequestComposer rc(req);
+    do
+    {
+        if (type == operation_type_range)
+        {
+            rc += FPSTR("GET /v4/spreadsheets/");
+            rc += spreadsheetId;
+            rc += FPSTR("/values/");
+            rc += ranges;
+
+            addFieldMask(rc, fields, false);
+
+            addHeader(rc, host_type_sheet);
+        }
+        else if (type == operation_type_batch)
+        {
+            rc += FPSTR("GET /v4/spreadsheets/");
+            rc += spreadsheetId;
+            rc += FPSTR("/values:batchGet");
+
+            for (size_t i = 0; i < rngs.size(); i++)
+            {
+                rc += i > 0 ? '&' : '?';
+                rc += FPSTR("ranges=");
+                rc += rngs[i];
+            }
+
+            if (strlen(majorDimension) > 0)
+            {
+                rc += FPSTR("&majorDimension=");
+                rc += majorDimension;
+            }
+
+            if (strlen(valueRenderOption) > 0)
+            {
+                rc += FPSTR("&valueRenderOption=");
+                rc += valueRenderOption;
+            }
+
+            if (strlen(dateTimeRenderOption) > 0)
+            {
+                rc += FPSTR("&dateTimeRenderOption=");
+                rc += dateTimeRenderOption;
+            }
+
+            addFieldMask(rc, fields, true);
+
+            addHeader(rc, host_type_sheet);
+        }
+        else if (type == operation_type_filter)
+        {
+            rc += FPSTR("POST /v4/spreadsheets/");
+            rc += spreadsheetId;
+            rc += FPSTR("/values:batchGetByDataFilter");
+
+            addFieldMask(rc, fields, false);
+
+            addHeader(rc, host_type_sheet, strlen(ranges));
+            body = ranges;
+        }
+    } while (rc.next());
+
+    bool ret = processRequest(req, response, httpcode, body);
+
+    if (ret && sliced)
+    {
+        unsigned long us = micros();
+        sliceValueRanges(response, requested, planned, owner);
+        config.timing.parse += micros() - us;
+    }
+
+    if (ret && key.length() > 0)
+        cachePut(key, spreadsheetId, ranges, response);
+
+    return ret;
+}
+
+void GSheetClass::sliceValueRanges(MB_String &response, std::vector<esp_google_sheet_a1_range_t> &requested,
+                                   std::vector<esp_google_sheet_a1_range_t> &planned, std::vector<size_t> &owner)
+{
+    FirebaseJson json(response);
+    FirebaseJsonData result;
+    FirebaseJsonArray values, row;
+    MB_String path, key, rangeStr, dimension, out;
+
+    out = FPSTR("{\"spreadsheetId\":\"");
+    if (json.get(result, "spreadsheetId"))
+        out += result.stringValue;
+    out += FPSTR("\",\"valueRanges\":[");
+
+    for (size_t i = 0; i < requested.size() && i < owner.size(); i++)
+    {
+        esp_google_sheet_a1_range_t &req = requested[i];
+        esp_google_sheet_a1_range_t &src = planned[owner[i]];
+
+        path = FPSTR("valueRanges/[");
+        path += owner[i];
+        path += FPSTR("]/");
+
+        if (i > 0)
+            out += ',';
+
+        // The whole sheet range was not merged, its value range is kept as is
+        if (src.whole)
+        {
+            path.pop_back();
+            if (json.get(result, path.c_str()))
+                out += result.stringValue;
+            else
+                out += FPSTR("{}");
+            continue;
+        }
+
+        key = path;
+        key += FPSTR("majorDimension");
+        dimension = FPSTR("ROWS");
+        if (json.get(result, key.c_str()))
+            dimension = result.stringValue;
+
+        // The outer array is the rows, or the columns for the COLUMNS major dimension
+        bool columns = dimension == "COLUMNS";
+        uint32_t outerOfs = columns ? req.col1 - src.col1 : req.row1 - src.row1;
+        uint32_t outerLen = columns ? req.col2 - req.col1 + 1 : req.row2 - req.row1 + 1;
+        uint32_t innerOfs = columns ? req.row1 - src.row1 : req.col1 - src.col1;
+        uint32_t innerLen = columns ? req.row2 - req.row1 + 1 : req.col2 - req.col1 + 1;
+
+        values.clear();
+        key = path;
+        key += FPSTR("values");
+        if (json.get(result, key.c_str()))
+            result.getArray(values);
+
+        // The range of response is sheet-qualified e.g. Sheet1!A1:D10 even if the sheet name was not requested
+        esp_google_sheet_a1_range_t qualified = req;
+        key = path;
+        key += FPSTR("range");
+        if (json.get(result, key.c_str()))
+        {
+            int pos = result.stringValue.lastIndexOf('!');
+            if (pos > 0)
+                qualified.sheet = result.stringValue.substring(0, pos).c_str();
+        }
+
+        RangeHelper::toString(qualified, rangeStr);
+
+        out += FPSTR("{\"range\":\"");
+        out += rangeStr;
+        out += FPSTR("\",\"majorDimension\":\"");
+        out += dimension;
+        out += '"';
+
+        // The trailing empty rows and cells were omitted by server, so as the sliced values
+        MB_String rows;
+        size_t lastRow = 0;
+
+        for (uint32_t r = 0; r < outerLen && outerOfs + r < values.size(); r++)
+        {
+            MB_String cells;
+            size_t lastCell = 0;
+            row.clear();
+            if (values.get(result, (int)(outerOfs + r)))
+                result.getArray(row);
+
+            for (uint32_t c = 0; c < innerLen && innerOfs + c < row.size(); c++)
+            {
+                if (c > 0)
+                    cells += ',';
+
+                bool ok = row.get(result, (int)(innerOfs + c));
+                if (!ok || result.typeNum == FirebaseJson::JSON_STRING)
+                {
+                    // The string value is still escaped
+                    cells += '"';
+                    if (ok)
+                        cells += result.stringValue;
+                    cells += '"';
+                }
+                else
+                    cells += result.stringValue;
+
+                if (ok && (result.typeNum != FirebaseJson::JSON_STRING || result.stringValue.length() > 0))
+                    lastCell = cells.length();
+            }
+
+            if (r > 0)
+                rows += ',';
+            rows += '[';
+            if (lastCell > 0)
+                rows += cells.substr(0, lastCell);
+            rows += ']';
+
+            if (lastCell > 0)
+                lastRow = rows.length();
+        }
+
+        if (lastRow > 0)
+        {
+            out += FPSTR(",\"values\":[");
+            out += rows.substr(0, lastRow);
+            out += ']';
+        }
+
+        out += '}';
+    }
+
+    out += FPSTR("]}");
+    response = out;
+}
+
+void GSheetClass::addFieldMask(HttpHelper::RequestComposer &rc, const char *fields, bool hasParam)
+{
+    if (!fields || strlen(fields) == 0)
+        return;
+
+    rc += hasParam ? '&' : '?';
+    rc += esp_google_sheet_pgm_str_50; // "fields"
+    rc += '=';
+
+    // The spaces that GSHEET_FIELDS stringification keeps after commas are not part of the mask
+    rc.addEncoded(fields, ' ');
+}
+
+bool GSheetClass::queueGet(const char *spreadsheetId, const char *range, FirebaseJson *json, String *str)
+{
+    if (strlen(spreadsheetId) == 0 || strlen(range) == 0)
+        return false;
+
+    if (read_batch.size() == 0)
+        read_batch_millis = millis();
+
+    read_batch_item_t item;
+    item.spreadsheetId = spreadsheetId;
+    item.range = range;
+    item.json = json;
+    item.str = str;
+    read_batch.push_back(item);
+
+    // The full queue is sent now unless it should be delayed by the rate limit
+    if (read_batch.size() >= ESP_GOOGLE_SHEET_CLIENT_MAX_READ_BATCH_SIZE && quotaWait(false) == 0)
+        return flushGet();
+
+    return true;
+}
+
+bool GSheetClass::flushGet()
 {
-    config.cert.file = filename;
-    config.cert.file_storage = (mb_fs_mem_storage_type)type;
-    cert_addr = 0;
-    if (config.cert.file.length() > 0)
+    bool ret = true;
+
+    while (read_batch.size() > 0)
     {
-        cert_updated = true;
-        waitClockReady();
+        if (!flushBatch())
+            ret = false;
     }
+
+    return ret;
 }
 
-void GSheetClass::reset()
+bool GSheetClass::flushBatch()
 {
-    config.internal.client_id.clear();
-    config.internal.client_secret.clear();
-    config.internal.auth_token.clear();
-    config.internal.last_jwt_generation_error_cb_millis = 0;
-    config.signer.tokens.expires = 0;
-    config.internal.rtoken_requested = false;
+    // Collect the ranges of the same spreadsheet as the first queued request
+    MB_String spreadsheetId = read_batch[0].spreadsheetId;
+    MB_String ranges;
+    std::vector<size_t> items;
 
-    config.internal.priv_key_crc = 0;
-    config.internal.email_crc = 0;
-    config.internal.password_crc = 0;
+    for (size_t i = 0; i < read_batch.size(); i++)
+    {
+        if (read_batch[i].spreadsheetId == spreadsheetId)
+        {
+            if (ranges.length() > 0)
+                ranges += FPSTR(",");
+            ranges += read_batch[i].range;
+            items.push_back(i);
+        }
+    }
 
-    config.signer.tokens.status = token_status_uninitialized;
-}
+    MB_String response;
+    bool status = mGet(response, spreadsheetId.c_str(), ranges.c_str(), "", "", "", operation_type_batch);
 
-bool GSheetClass::setSecure()
-{
-    GS_TCP_Client *client = authMan.tcpClient;
+    if (status)
+        status = !isError(response);
 
-    if (!client)
-        return false;
+    unsigned long us = micros();
 
-    client->setConfig(&config, &mbfs);
+    FirebaseJson json;
+    FirebaseJsonData result;
 
-    if (!authMan.reconnect(client))
-        return false;
+    if (status)
+        json.setJsonData(response);
 
-#if (defined(ESP8266) || defined(MB_ARDUINO_PICO))
-    if (TimeHelper::getTime(&mb_ts, &mb_ts_offset) > ESP_GOOGLE_SHEET_CLIENT_DEFAULT_TS)
+    // The valueRanges are in the same order as the requested ranges
+    for (size_t i = 0; i < items.size(); i++)
     {
-        config.internal.clock_rdy = true;
-        client->setClockStatus(true);
-    }
-#endif
+        read_batch_item_t &item = read_batch[items[i]];
 
-    if (client->getCertType() == esp_google_sheet_cert_type_undefined || cert_updated)
-    {
+        if (status)
+        {
+            MB_String path = FPSTR("valueRanges/[");
+            path += i;
+            path += FPSTR("]");
+            json.get(result, path.c_str());
 
-        if (!config.internal.clock_rdy && (config.cert.file.length() > 0 || config.cert.data != NULL || cert_addr > 0))
-            TimeHelper::syncClock(&mb_ts, &mb_ts_offset, config.internal.gmt_offset, &config);
+            if (item.json)
+            {
+                if (result.success)
+                    result.getJSON(*item.json);
+                else
+                    item.json->clear();
+            }
 
-        if (config.cert.file.length() == 0)
-        {
-            if (cert_addr > 0)
-                client->setCACert(reinterpret_cast<const char *>(cert_addr));
-            else if (config.cert.data != NULL)
-                client->setCACert(config.cert.data);
-            else
-                client->setCACert(NULL);
+            if (item.str)
+                *item.str = result.success ? result.stringValue : "";
         }
         else
         {
-            if (!client->setCertFile(config.cert.file.c_str(), config.cert.file_storage))
-                client->setCACert(NULL);
+            if (item.json)
+                item.json->setJsonData(response);
+
+            if (item.str)
+                *item.str = response.c_str();
         }
-        cert_updated = false;
     }
-    return true;
+
+    config.timing.parse += micros() - us;
+    commitTiming();
+
+    for (size_t i = items.size(); i > 0; i--)
+        read_batch.erase(read_batch.begin() + items[i - 1]);
+
+    return status;
 }
 
-bool GSheetClass::processRequest(MB_String &req, MB_String &response, int &httpcode)
+void GSheetClass::readBatchTask()
 {
-    GS_TCP_Client *client = authMan.tcpClient;
+    if (read_batch.size() == 0 || millis() - read_batch_millis < read_batch_window)
+        return;
 
-    if (!client)
-        return false;
+    // The batches are delayed to the later calls instead of waiting for the rate limit
+    while (read_batch.size() > 0 && quotaWait(false) == 0)
+        flushBatch();
+}
 
-    authMan.response_code = 0;
+void GSheetClass::setCache(size_t size, unsigned long ttl, esp_google_sheet_file_storage_type storage_type)
+{
+    cache_size = size;
+    cache_ttl = ttl;
+    cache_storage = (mb_fs_mem_storage_type)storage_type;
 
-    int ret = client->send(req.c_str());
-    req.clear();
-    config.signer.tokens.error.message.clear();
+    while (cache.size() > cache_size)
+        cacheRemove(0);
+}
+
+void GSheetClass::clearCache()
+{
+    while (cache.size() > 0)
+        cacheRemove(0);
+}
 
-    if (ret > 0)
+bool GSheetClass::cacheGet(const MB_String &key, MB_String &response)
+{
+    for (size_t i = 0; i < cache.size(); i++)
     {
-        ret = authMan.handleResponse(client, httpcode, response, false);
-        if (!ret)
+        if (cache[i].key != key)
+            continue;
+
+        if (millis() - cache[i].millis > cache[i].ttl)
         {
-            authMan.response_code = httpcode;
-            FirebaseJson json(response);
-            FirebaseJsonData result;
-            json.get(result, "error/message");
-            if (result.success)
-                config.signer.tokens.error.message = result.stringValue;
-            else
-                config.signer.tokens.error.message = response;
+            cacheRemove(i);
+            return false;
         }
-    }
 
-    if (ret < 0)
-    {
-        authMan.response_code = ret;
-        httpcode = ret;
-    }
+        if (cache[i].file.length() > 0)
+        {
+            int len = mbfs.open(cache[i].file, mbfs_type cache_storage, mb_fs_open_mode_read);
+            if (len <= 0)
+            {
+                cacheRemove(i);
+                return false;
+            }
 
-    if (!ret)
-        client->stop();
+            char *buf = MemoryHelper::createBuffer<char *>(&mbfs, len + 1);
+            bool ret = mbfs.read(mbfs_type cache_storage, (uint8_t *)buf, len) == len;
+            mbfs.close(mbfs_type cache_storage);
+            if (ret)
+                response = buf;
+            MemoryHelper::freeBuffer(&mbfs, buf);
 
-    return ret > 0;
+            if (!ret)
+            {
+                cacheRemove(i);
+                return false;
+            }
+        }
+        else
+            response = cache[i].response;
+
+        // Move to the most recently used position
+        if (i < cache.size() - 1)
+        {
+            cache_item_t item = cache[i];
+            cache.erase(cache.begin() + i);
+            cache.push_back(item);
+        }
+
+        return true;
+    }
+
+    return false;
 }
 
-bool GSheetClass::mGet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *majorDimension, const char *valueRenderOption, const char *dateTimeRenderOption, operation_type_t type)
+void GSheetClass::cachePut(const MB_String &key, const char *spreadsheetId, const char *ranges, const MB_String &response)
 {
-    if (!checkToken())
-        return false;
+    for (size_t i = 0; i < cache.size(); i++)
+    {
+        if (cache[i].key == key)
+        {
+            cacheRemove(i);
+            break;
+        }
+    }
 
-    MB_String req;
-    int httpcode = 0;
+    while (cache.size() > 0 && cache.size() >= cache_size)
+        cacheRemove(0);
 
-    if (!beginRequest(req, host_type_sheet))
-        return false;
+    cache_item_t item;
+    item.key = key;
+    item.spreadsheetId = spreadsheetId;
+    item.ranges = ranges;
+    item.millis = millis();
+    item.ttl = cache_ttl;
 
-    if (type == operation_type_range)
+    if (cache_storage != mb_fs_mem_storage_type_undefined && response.length() > ESP_GOOGLE_SHEET_CLIENT_CACHE_SPILL_SIZE)
     {
-        req = FPSTR("GET /v4/spreadsheets/");
-        req += spreadsheetId;
-        req += FPSTR("/values/");
-        req += ranges;
+        item.file = esp_google_sheet_pgm_str_52; // "/gsheet_cache_"
+        item.file += cache_file_idx++;
 
-        addHeader(req, host_type_sheet);
-        req += FPSTR("\r\n");
+        if (mbfs.open(item.file, mbfs_type cache_storage, mb_fs_open_mode_write) < 0)
+            item.file.clear();
+        else
+        {
+            if (mbfs.print(mbfs_type cache_storage, response.c_str()) != (int)response.length())
+            {
+                mbfs.close(mbfs_type cache_storage);
+                mbfs.remove(item.file, mbfs_type cache_storage);
+                return;
+            }
+            mbfs.close(mbfs_type cache_storage);
+        }
     }
-    else if (type == operation_type_batch)
-    {
-        req = FPSTR("GET /v4/spreadsheets/");
-        req += spreadsheetId;
-        req += FPSTR("/values:batchGet");
 
-        std::vector<MB_String> rngs = std::vector<MB_String>();
-        MB_String rng = ranges;
-        StringHelper::splitTk(rng, rngs, ",");
-
-        if (rngs.size() == 0)
-            return false;
+    if (item.file.length() == 0)
+        item.response = response;
 
-        MB_String s;
+    cache.push_back(item);
+}
 
-        for (size_t i = 0; i < rngs.size(); i++)
-        {
-            if (s.length() > 0)
-                s += FPSTR("&");
-            else
-                s += FPSTR("?");
+void GSheetClass::cacheRemove(size_t index)
+{
+    if (cache[index].file.length() > 0)
+        mbfs.remove(cache[index].file, mbfs_type cache_storage);
 
-            s += FPSTR("ranges=");
-            s += rngs[i].c_str();
-        }
+    cache.erase(cache.begin() + index);
+}
 
-        req += s;
-        s.clear();
+void GSheetClass::cacheInvalidate(const char *spreadsheetId, const char *ranges, bool append)
+{
+    if (cache.size() == 0)
+        return;
 
-        if (strlen(majorDimension) > 0)
-        {
-            req += FPSTR("&majorDimension=");
-            req += majorDimension;
-        }
+    // The range that is not bounded e.g. Sheet1 or Sheet1!A:A covers the whole sheet
+    std::vector<esp_google_sheet_a1_range_t> writes;
+    std::vector<MB_String> tk;
+    MB_String rng = ranges;
+    bool all = rng.length() == 0;
 
-        if (strlen(valueRenderOption) > 0)
+    if (!all)
+    {
+        StringHelper::splitTk(rng, tk, ",");
+        for (size_t i = 0; i < tk.size(); i++)
         {
-            req += FPSTR("&valueRenderOption=");
-            req += valueRenderOption;
-        }
+            esp_google_sheet_a1_range_t range;
+            RangeHelper::cover(tk[i], range);
 
-        if (strlen(dateTimeRenderOption) > 0)
-        {
-            req += FPSTR("&dateTimeRenderOption=");
-            req += dateTimeRenderOption;
+            // The appended rows can be anywhere below the table in that sheet
+            if (append)
+            {
+                range.col1 = 1;
+                range.row1 = 1;
+                range.col2 = UINT32_MAX;
+                range.row2 = UINT32_MAX;
+            }
+            writes.push_back(range);
         }
-
-        addHeader(req, host_type_sheet);
-        req += FPSTR("\r\n");
     }
-    else if (type == operation_type_filter)
+
+    for (size_t i = cache.size(); i > 0; i--)
     {
-        req = FPSTR("POST /v4/spreadsheets/");
-        req += spreadsheetId;
-        req += FPSTR("/values:batchGetByDataFilter");
+        cache_item_t &item = cache[i - 1];
 
-        addHeader(req, host_type_sheet, strlen(ranges));
+        if (strcmp(item.spreadsheetId.c_str(), spreadsheetId) != 0)
+            continue;
 
-        req += FPSTR("\r\n");
+        bool hit = all;
 
-        req += ranges;
-    }
+        if (!hit)
+        {
+            tk.clear();
+            StringHelper::splitTk(item.ranges, tk, ",");
+            for (size_t j = 0; j < tk.size() && !hit; j++)
+            {
+                esp_google_sheet_a1_range_t range;
+                RangeHelper::cover(tk[j], range);
 
-    return processRequest(req, response, httpcode);
+                for (size_t k = 0; k < writes.size() && !hit; k++)
+                    hit = RangeHelper::intersects(range, writes[k]);
+            }
+        }
+
+        if (hit)
+            cacheRemove(i - 1);
+    }
 }
 
 bool GSheetClass::isError(MB_String &response)
 {
+    unsigned long us = micros();
     authMan.initJson();
     bool ret = false;
     if (JsonHelper::setData(authMan.jsonPtr, response, false))
         ret = JsonHelper::parse(authMan.jsonPtr, authMan.resultPtr, gauth_pgm_str_14) || JsonHelper::parse(authMan.jsonPtr, authMan.resultPtr, gauth_pgm_str_14);
 
     authMan.freeJson();
+    config.timing.parse += micros() - us;
     return ret;
 }
 
-bool GSheetClass::get(MB_String &response, const char *spreadsheetId, const char *range)
+bool GSheetClass::get(MB_String &response, const char *spreadsheetId, const char *range, const char *fields)
 {
-    return mGet(response, spreadsheetId, range, "", "", "", operation_type_range);
+    return mGet(response, spreadsheetId, range, "", "", "", operation_type_range, fields);
 }
 
-bool GSheetClass::batchGet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *majorDimension, const char *valueRenderOption, const char *dateTimeRenderOption)
+bool GSheetClass::batchGet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *majorDimension, const char *valueRenderOption, const char *dateTimeRenderOption, const char *fields)
 {
-    return mGet(response, spreadsheetId, ranges, majorDimension, valueRenderOption, dateTimeRenderOption, operation_type_batch);
+    return mGet(response, spreadsheetId, ranges, majorDimension, valueRenderOption, dateTimeRenderOption, operation_type_batch, fields);
 }
 
-bool GSheetClass::batchGetByDataFilter(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray, const char *majorDimension, const char *valueRenderOption, const char *dateTimeRenderOption)
+bool GSheetClass::batchGetByDataFilter(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray, const char *majorDimension, const char *valueRenderOption, const char *dateTimeRenderOption, const char *fields)
 {
     if (!checkToken())
         return false;
@@ -411,7 +1477,7 @@ bool GSheetClass::batchGetByDataFilter(MB_String &response, const char *spreadsh
             js.add(FPSTR("valueRenderOption"), valueRenderOption);
         if (strlen(dateTimeRenderOption) > 0)
             js.add(FPSTR("dateTimeRenderOption"), dateTimeRenderOption);
-        return mGet(response, spreadsheetId, js.raw(), "", "", "", operation_type_filter);
+        return mGet(response, spreadsheetId, js.raw(), "", "", "", operation_type_filter, fields);
     }
 
     return false;
@@ -485,67 +1551,66 @@ bool GSheetClass::mUpdate(bool append, operation_type_t type, MB_String &respons
     if (!beginRequest(req, host_type_sheet))
         return false;
 
-    if (append || type == operation_type_batch || type == operation_type_filter)
-        req = FPSTR("POST /v4/spreadsheets/");
-    else
-        req = FPSTR("PUT /v4/spreadsheets/");
-
-    req += spreadsheetId;
-    req += FPSTR("/values");
+    cacheInvalidate(spreadsheetId, type == operation_type_range ? range : "", append);
 
-    if (type == operation_type_range)
+    HttpHelper::RequestComposer rc(req);
+    do
     {
-        req += FPSTR("/");
-        req += range;
-    }
-    else if (type == operation_type_batch)
-        req += FPSTR(":batchUpdate");
-    else if (type == operation_type_filter)
-        req += FPSTR(":batchUpdateByDataFilter");
-
-    if (append)
-        req += FPSTR(":append");
+        if (append || type == operation_type_batch || type == operation_type_filter)
+            rc += FPSTR("POST /v4/spreadsheets/");
+        else
+            rc += FPSTR("PUT /v4/spreadsheets/");
 
-    if (append || type == operation_type_range)
-    {
-        req += FPSTR("?valueInputOption=");
-        req += valueInputOption;
+        rc += spreadsheetId;
+        rc += FPSTR("/values");
 
-        if (strlen(insertDataOption) > 0)
+        if (type == operation_type_range)
         {
-            req += FPSTR("&insertDataOption=");
-            req += insertDataOption;
+            rc += FPSTR("/");
+            rc += range;
         }
+        else if (type == operation_type_batch)
+            rc += FPSTR(":batchUpdate");
+        else if (type == operation_type_filter)
+            rc += FPSTR(":batchUpdateByDataFilter");
 
-        if (strlen(includeValuesInResponse) > 0)
-        {
-            req += FPSTR("&includeValuesInResponse=");
-            req += includeValuesInResponse;
-        }
+        if (append)
+            rc += FPSTR(":append");
 
-        if (strlen(responseValueRenderOption) > 0)
+        if (append || type == operation_type_range)
         {
-            req += FPSTR("&responseValueRenderOption=");
-            req += responseValueRenderOption;
-        }
+            rc += FPSTR("?valueInputOption=");
+            rc += valueInputOption;
 
-        if (strlen(responseDateTimeRenderOption) > 0)
-        {
-            req += FPSTR("&responseDateTimeRenderOption=");
-            req += responseDateTimeRenderOption;
-        }
-    }
+            if (strlen(insertDataOption) > 0)
+            {
+                rc += FPSTR("&insertDataOption=");
+                rc += insertDataOption;
+            }
 
-    if (valueRange)
-        addHeader(req, host_type_sheet, strlen(valueRange->raw()));
-    else
-        addHeader(req, host_type_sheet, 0);
+            if (strlen(includeValuesInResponse) > 0)
+            {
+                rc += FPSTR("&includeValuesInResponse=");
+                rc += includeValuesInResponse;
+            }
+
+            if (strlen(responseValueRenderOption) > 0)
+            {
+                rc += FPSTR("&responseValueRenderOption=");
+                rc += responseValueRenderOption;
+            }
+
+            if (strlen(responseDateTimeRenderOption) > 0)
+            {
+                rc += FPSTR("&responseDateTimeRenderOption=");
+                rc += responseDateTimeRenderOption;
+            }
+        }
 
-    req += FPSTR("\r\n");
-    if (valueRange)
-        req += valueRange->raw();
+        addHeader(rc, host_type_sheet, valueRange ? strlen(valueRange->raw()) : 0);
+    } while (rc.next());
 
-    return processRequest(req, response, httpcode);
+    return processRequest(req, response, httpcode, valueRange ? valueRange->raw() : nullptr);
 }
 
 bool GSheetClass::clear(MB_String &response, const char *spreadsheetId, const char *range)
@@ -576,68 +1641,78 @@ bool GSheetClass::mClear(MB_String &response, const char *spreadsheetId, const c
     if (!beginRequest(req, host_type_sheet))
         return false;
 
-    req = FPSTR("POST /v4/spreadsheets/");
-    req += spreadsheetId;
+    cacheInvalidate(spreadsheetId, type == operation_type_filter ? "" : ranges);
+
+    // The request body which must be alive until the request was sent
+    FirebaseJson r;
+    const char *body = nullptr;
 
     if (strlen(ranges) > 0)
     {
         if (type == operation_type_range)
+            body = (const char *)FPSTR("{}");
+        else if (type == operation_type_batch)
         {
+            std::vector<MB_String> rngs = std::vector<MB_String>();
+            MB_String rng = ranges;
+            StringHelper::splitTk(rng, rngs, ",");
 
-            req += FPSTR("/values/");
-            req += ranges;
-            req += FPSTR(":clear");
-
-            addHeader(req, host_type_sheet, 2);
+            if (rngs.size() == 0)
+                return false;
 
-            req += FPSTR("\r\n{}");
-        }
-        else
-        {
-            if (type == operation_type_batch)
+            // Clear the merged ranges which cover exactly the same cells
+            std::vector<esp_google_sheet_a1_range_t> requested, planned;
+            std::vector<size_t> owner;
+            if (RangeHelper::plan(rngs, requested, planned, owner))
             {
-                req += FPSTR("/values:batchClear");
-                std::vector<MB_String> rngs = std::vector<MB_String>();
-                MB_String rng = ranges;
-                StringHelper::splitTk(rng, rngs, ",");
-
-                if (rngs.size() == 0)
-                    return false;
-
-                FirebaseJson r;
-                MB_String tmp;
-
-                for (size_t i = 0; i < rngs.size(); i++)
+                rngs.clear();
+                for (size_t i = 0; i < planned.size(); i++)
                 {
-                    tmp = (const char *)FPSTR("ranges/[");
-                    tmp += i;
-                    tmp += (const char *)FPSTR("]");
-
-                    r.set(tmp.c_str(), rngs[i].c_str());
+                    RangeHelper::toString(planned[i], rng);
+                    rngs.push_back(rng);
                 }
-                tmp.clear();
+            }
 
-                addHeader(req, host_type_sheet, strlen(r.raw()));
+            MB_String tmp;
 
-                req += FPSTR("\r\n");
+            for (size_t i = 0; i < rngs.size(); i++)
+            {
+                tmp = (const char *)FPSTR("ranges/[");
+                tmp += i;
+                tmp += (const char *)FPSTR("]");
 
-                req += r.raw();
-                r.clear();
+                r.set(tmp.c_str(), rngs[i].c_str());
             }
-            else if (type == operation_type_filter)
-            {
-                req += FPSTR("/values:batchClearByDataFilter");
+            tmp.clear();
 
-                addHeader(req, host_type_sheet, strlen(ranges));
+            body = r.raw();
+        }
+        else if (type == operation_type_filter)
+            body = ranges;
+    }
 
-                req += FPSTR("\r\n");
+    HttpHelper::RequestComposer rc(req);
+    do
+    {
+        rc += FPSTR("POST /v4/spreadsheets/");
+        rc += spreadsheetId;
 
-                req += ranges;
-            }
+        if (type == operation_type_range)
+        {
+            rc += FPSTR("/values/");
+            rc += ranges;
+            rc += FPSTR(":clear");
         }
-    }
+        else if (type == operation_type_batch)
+            rc += FPSTR("/values:batchClear");
+        else if (type == operation_type_filter)
+            rc += FPSTR("/values:batchClearByDataFilter");
 
-    return processRequest(req, response, httpcode);
+        if (body)
+            addHeader(rc, host_type_sheet, strlen(body));
+    } while (rc.next());
+
+    return processRequest(req, response, httpcode, body);
 }
 
 bool GSheetClass::copyTo(MB_String &response, const char *spreadsheetId, uint32_t sheetId, const char *destinationSpreadsheetId)
@@ -651,24 +1726,27 @@ bool GSheetClass::copyTo(MB_String &response, const char *spreadsheetId, uint32_
     if (!beginRequest(req, host_type_sheet))
         return false;
 
-    req = FPSTR("POST /v4/spreadsheets/");
-    req += spreadsheetId;
-
-    req += FPSTR("/sheets/");
-    req += sheetId;
-    req += FPSTR(":copyTo");
+    cacheInvalidate(destinationSpreadsheetId, "");
 
     MB_String s;
     s = FPSTR("{\"destinationSpreadsheetId\":\"");
     s += destinationSpreadsheetId;
     s += "\"}";
 
-    addHeader(req, host_type_sheet, s.length());
+    HttpHelper::RequestComposer rc(req);
+    do
+    {
+        rc += FPSTR("POST /v4/spreadsheets/");
+        rc += spreadsheetId;
 
-    req += FPSTR("\r\n");
-    req += s;
+        rc += FPSTR("/sheets/");
+        rc += sheetId;
+        rc += FPSTR(":copyTo");
 
-    return processRequest(req, response, httpcode);
+        addHeader(rc, host_type_sheet, s.length());
+    } while (rc.next());
+
+    return processRequest(req, response, httpcode, s.c_str());
 }
 
 bool GSheetClass::batchUpdate(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *requestsArray, const char *includeSpreadsheetInResponse, const char *responseRanges, const char *responseIncludeGridData)
@@ -682,10 +1760,8 @@ bool GSheetClass::batchUpdate(MB_String &response, const char *spreadsheetId, Fi
     if (!beginRequest(req, host_type_sheet))
         return false;
 
-    req = FPSTR("POST /v4/spreadsheets/");
-    req += spreadsheetId;
-
-    req += FPSTR(":batchUpdate");
+    // The structural changes e.g. insert or delete rows can move any cell
+    cacheInvalidate(spreadsheetId, "");
 
     FirebaseJson js;
 
@@ -731,12 +1807,18 @@ bool GSheetClass::batchUpdate(MB_String &response, const char *spreadsheetId, Fi
             tmp.clear();
         }
 
-        addHeader(req, host_type_sheet, strlen(js.raw()));
+        HttpHelper::RequestComposer rc(req);
+        do
+        {
+            rc += FPSTR("POST /v4/spreadsheets/");
+            rc += spreadsheetId;
+
+            rc += FPSTR(":batchUpdate");
 
-        req += FPSTR("\r\n");
-        req += js.raw();
+            addHeader(rc, host_type_sheet, strlen(js.raw()));
+        } while (rc.next());
 
-        return processRequest(req, response, httpcode);
+        return processRequest(req, response, httpcode, js.raw());
     }
 
     return false;
@@ -753,16 +1835,17 @@ bool GSheetClass::create(MB_String &response, FirebaseJson *spreadsheet, const c
     if (!beginRequest(req, host_type_sheet))
         return false;
 
-    req = FPSTR("POST /v4/spreadsheets");
-
-    addHeader(req, host_type_sheet, strlen(spreadsheet->raw()));
+    HttpHelper::RequestComposer rc(req);
+    do
+    {
+        rc += FPSTR("POST /v4/spreadsheets");
 
-    req += FPSTR("\r\n");
-    req += spreadsheet->raw();
+        addHeader(rc, host_type_sheet, strlen(spreadsheet->raw()));
+    } while (rc.next());
 
-    return processRequest(req, response, httpcode);
+    return processRequest(req, response, httpcode, spreadsheet->raw());
 }
-bool GSheetClass::getMetadata(MB_String &response, const char *spreadsheetId, uint32_t metadataId)
+bool GSheetClass::getMetadata(MB_String &response, const char *spreadsheetId, uint32_t metadataId, const char *fields)
 {
     if (!checkToken())
         return false;
@@ -773,14 +1856,18 @@ bool GSheetClass::getMetadata(MB_String &response, const char *spreadsheetId, ui
     if (!beginRequest(req, host_type_sheet))
         return false;
 
-    req = FPSTR("GET /v4/spreadsheets/");
-    req += spreadsheetId;
-    req += FPSTR("/developerMetadata/");
-    req += metadataId;
+    HttpHelper::RequestComposer rc(req);
+    do
+    {
+        rc += FPSTR("GET /v4/spreadsheets/");
+        rc += spreadsheetId;
+        rc += FPSTR("/developerMetadata/");
+        rc += metadataId;
 
-    addHeader(req, host_type_sheet);
+        addFieldMask(rc, fields, false);
 
-    req += FPSTR("\r\n");
+        addHeader(rc, host_type_sheet);
+    } while (rc.next());
 
     return processRequest(req, response, httpcode);
 }
@@ -798,26 +1885,26 @@ bool GSheetClass::searchMetadata(MB_String &response, const char *spreadsheetId,
         if (!beginRequest(req, host_type_sheet))
             return false;
 
-        req = FPSTR("POST /v4/spreadsheets/");
-        req += spreadsheetId;
-        req += FPSTR("/developerMetadata:search");
-
         FirebaseJson js;
         js.add(FPSTR("dataFilters"), *dataFiltersArray);
 
-        addHeader(req, host_type_sheet, strlen(js.raw()));
-
-        req += FPSTR("\r\n");
+        HttpHelper::RequestComposer rc(req);
+        do
+        {
+            rc += FPSTR("POST /v4/spreadsheets/");
+            rc += spreadsheetId;
+            rc += FPSTR("/developerMetadata:search");
 
-        req += js.raw();
+            addHeader(rc, host_type_sheet, strlen(js.raw()));
+        } while (rc.next());
 
-        return processRequest(req, response, httpcode);
+        return processRequest(req, response, httpcode, js.raw());
     }
 
     return false;
 }
 
-bool GSheetClass::getSpreadsheet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *includeGridData)
+bool GSheetClass::getSpreadsheet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *includeGridData, const char *fields)
 {
     if (!checkToken())
         return false;
@@ -828,57 +1915,54 @@ bool GSheetClass::getSpreadsheet(MB_String &response, const char *spreadsheetId,
     if (!beginRequest(req, host_type_drive))
         return false;
 
-    req = FPSTR("GET /v4/spreadsheets/");
-    req += spreadsheetId;
-
-    MB_String s;
+    std::vector<MB_String> rngs = std::vector<MB_String>();
 
     if (strlen(ranges) > 0)
     {
-        std::vector<MB_String> rngs = std::vector<MB_String>();
         MB_String rng = ranges;
         StringHelper::splitTk(rng, rngs, ",");
 
         if (rngs.size() == 0)
             return false;
+    }
+
+    HttpHelper::RequestComposer rc(req);
+    do
+    {
+        rc += FPSTR("GET /v4/spreadsheets/");
+        rc += spreadsheetId;
 
         for (size_t i = 0; i < rngs.size(); i++)
         {
-            if (s.length() > 0)
-                s += FPSTR("&");
-            else
-                s += FPSTR("?");
-
-            s += FPSTR("ranges=");
-            s += rngs[i].c_str();
+            rc += i > 0 ? '&' : '?';
+            rc += FPSTR("ranges=");
+            rc += rngs[i];
         }
 
-        req += s;
-    }
+        bool hasParam = rngs.size() > 0;
 
-    if (strlen(includeGridData) > 0)
-    {
-        if (s.length() > 0)
-            s += FPSTR("&");
-        else
-            s += FPSTR("?");
+        if (strlen(includeGridData) > 0)
+        {
+            rc += hasParam ? '&' : '?';
+            rc += FPSTR("includeGridData=");
 
-        if (strcmp(includeGridData, (const char *)FPSTR("true")) == 0)
-            s += FPSTR("true");
-        else
-            s += FPSTR("false");
-    }
+            if (strcmp(includeGridData, (const char *)FPSTR("true")) == 0)
+                rc += FPSTR("true");
+            else
+                rc += FPSTR("false");
 
-    s.clear();
+            hasParam = true;
+        }
 
-    addHeader(req, host_type_sheet);
+        addFieldMask(rc, fields, hasParam);
 
-    req += FPSTR("\r\n");
+        addHeader(rc, host_type_sheet);
+    } while (rc.next());
 
     return processRequest(req, response, httpcode);
 }
 
-bool GSheetClass::getSpreadsheetByDataFilter(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray, const char *includeGridData)
+bool GSheetClass::getSpreadsheetByDataFilter(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray, const char *includeGridData, const char *fields)
 {
     if (!checkToken())
         return false;
@@ -891,10 +1975,6 @@ bool GSheetClass::getSpreadsheetByDataFilter(MB_String &response, const char *sp
         if (!beginRequest(req, host_type_drive))
             return false;
 
-        req = FPSTR("POST /v4/spreadsheets/");
-        req += spreadsheetId;
-        req += ":getByDataFilter";
-
         FirebaseJson js;
         js.add(FPSTR("dataFilters"), *dataFiltersArray);
 
@@ -903,11 +1983,20 @@ bool GSheetClass::getSpreadsheetByDataFilter(MB_String &response, const char *sp
             if (strcmp(includeGridData, (const char *)FPSTR("true")) == 0)
                 js.add(FPSTR("includeGridData"), true);
         }
-        addHeader(req, host_type_sheet, strlen(js.raw()));
 
-        req += FPSTR("\r\n");
-        req += js.raw();
-        return processRequest(req, response, httpcode);
+        HttpHelper::RequestComposer rc(req);
+        do
+        {
+            rc += FPSTR("POST /v4/spreadsheets/");
+            rc += spreadsheetId;
+            rc += ":getByDataFilter";
+
+            addFieldMask(rc, fields, false);
+
+            addHeader(rc, host_type_sheet, strlen(js.raw()));
+        } while (rc.next());
+
+        return processRequest(req, response, httpcode, js.raw());
     }
 
     return false;
@@ -932,12 +2021,16 @@ bool GSheetClass::deleteFile(MB_String &response, const char *spreadsheetId, boo
     if (!beginRequest(req, host_type_drive))
         return false;
 
-    req = FPSTR("DELETE /drive/v3/files/");
-    req += spreadsheetId;
+    cacheInvalidate(spreadsheetId, "");
 
-    addHeader(req, host_type_drive);
+    HttpHelper::RequestComposer rc(req);
+    do
+    {
+        rc += FPSTR("DELETE /drive/v3/files/");
+        rc += spreadsheetId;
 
-    req += FPSTR("\r\n");
+        addHeader(rc, host_type_drive);
+    } while (rc.next());
 
     processRequest(req, response, httpcode);
 
@@ -953,7 +2046,8 @@ bool GSheetClass::deleteFiles(MB_String &response)
     if (!checkToken())
         return false;
 
-    bool ret = listFiles(response);
+    // Only the file IDs are needed for deletion
+    bool ret = listFiles(response, 5, "", "", GSHEET_FIELDS_FILE_IDS);
 
     if (ret)
     {
@@ -996,7 +2090,7 @@ bool GSheetClass::deleteFiles(MB_String &response)
     return ret;
 }
 
-bool GSheetClass::listFiles(MB_String &response, uint32_t pageSize, const char *orderBy, const char *pageToken)
+bool GSheetClass::listFiles(MB_String &response, uint32_t pageSize, const char *orderBy, const char *pageToken, const char *fields)
 {
     if (!checkToken())
         return false;
@@ -1015,24 +2109,28 @@ bool GSheetClass::listFiles(MB_String &response, uint32_t pageSize, const char *
     if (!beginRequest(req, host_type_drive))
         return false;
 
-    req = FPSTR("GET /drive/v3/files?pageSize=");
-    req += pageSize;
-
-    if (strlen(orderBy) > 0)
+    HttpHelper::RequestComposer rc(req);
+    do
     {
-        req += FPSTR("&orderBy=");
-        req += orderBy;
-    }
+        rc += FPSTR("GET /drive/v3/files?pageSize=");
+        rc += pageSize;
 
-    if (strlen(pageToken) > 0)
-    {
-        req += FPSTR("&pageToken=");
-        req += pageToken;
-    }
+        if (strlen(orderBy) > 0)
+        {
+            rc += FPSTR("&orderBy=");
+            rc += orderBy;
+        }
 
-    addHeader(req, host_type_drive);
+        if (strlen(pageToken) > 0)
+        {
+            rc += FPSTR("&pageToken=");
+            rc += pageToken;
+        }
 
-    req += FPSTR("\r\n");
+        addFieldMask(rc, fields, true);
+
+        addHeader(rc, host_type_drive);
+    } while (rc.next());
 
     bool ret = processRequest(req, response, httpcode);
 
@@ -1076,24 +2174,25 @@ bool GSheetClass::createPermission(MB_String &response, const char *fileid, cons
     if (!beginRequest(req, host_type_drive))
         return false;
 
-    req = FPSTR("POST /drive/v3/files/");
-    req += fileid;
-    req += FPSTR("/permissions?supportsAllDrives=true");
-
-    if (strcmp(role, (const char *)FPSTR("owner")) == 0)
-        req += FPSTR("&transferOwnership=true");
-
     FirebaseJson js;
     js.add((const char *)FPSTR("role"), role);
     js.add((const char *)FPSTR("type"), type);
     js.add((const char *)FPSTR("emailAddress"), email);
 
-    addHeader(req, host_type_drive, strlen(js.raw()));
+    HttpHelper::RequestComposer rc(req);
+    do
+    {
+        rc += FPSTR("POST /drive/v3/files/");
+        rc += fileid;
+        rc += FPSTR("/permissions?supportsAllDrives=true");
+
+        if (strcmp(role, (const char *)FPSTR("owner")) == 0)
+            rc += FPSTR("&transferOwnership=true");
 
-    req += FPSTR("\r\n");
-    req += js.raw();
+        addHeader(rc, host_type_drive, strlen(js.raw()));
+    } while (rc.next());
 
-    bool ret = processRequest(req, response, httpcode);
+    bool ret = processRequest(req, response, httpcode, js.raw());
 
     return ret;
 }
@@ -42,27 +42,107 @@ private:
         host_type_drive
     };
 
+    struct read_batch_item_t
+    {
+        MB_String spreadsheetId;
+        MB_String range;
+        FirebaseJson *json = nullptr;
+        String *str = nullptr;
+    };
+
+    struct header_block_t
+    {
+        MB_String block;
+        // The access token version that the block was built with
+        uint16_t tokenVersion = 0;
+    };
+
+    struct cache_item_t
+    {
+        MB_String key;
+        MB_String spreadsheetId;
+        MB_String ranges;
+        MB_String response;
+        // The file that keeps the response when it was spilled to storage
+        MB_String file;
+        unsigned long millis = 0;
+        unsigned long ttl = 0;
+    };
+
     esp_google_sheet_auth_cfg_t config;
     GAuthManager authMan;
+    header_block_t header_blocks[2];
+    host_type_t header_host = host_type_sheet;
+    // The host of the last connection, the connection is kept warm to this host
+    host_type_t conn_host = host_type_sheet;
+    unsigned long last_request_millis = 0;
+    unsigned long keep_warm_window = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_KEEP_WARM_WINDOW;
+    bool keep_warm_ping = false;
     MB_FS mbfs;
     uint32_t mb_ts = 0;
     uint32_t mb_ts_offset = 0;
     int response_code = 0;
 
-    int cert_addr = 0;
+    uintptr_t cert_addr = 0;
     bool cert_updated = false;
 
+    std::vector<read_batch_item_t> read_batch;
+    unsigned long read_batch_millis = 0;
+    uint16_t read_batch_window = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_READ_BATCH_WINDOW;
+
+    // The least recently used item is at the front
+    std::vector<cache_item_t> cache;
+    size_t cache_size = 0;
+    unsigned long cache_ttl = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_CACHE_TTL;
+    mb_fs_mem_storage_type cache_storage = mb_fs_mem_storage_type_undefined;
+    uint16_t cache_file_idx = 0;
+
+    RequestTimingCallback timing_cb = NULL;
+    // The ring buffer of the latency records, the oldest record is at timing_buf_idx when it is full
+    std::vector<RequestTiming> timing_buf;
+    size_t timing_buf_size = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_TIMING_BUFFER_SIZE;
+    size_t timing_buf_idx = 0;
+    unsigned long timing_micros = 0;
+    bool timing_pending = false;
+    // The heap usage of the last operation
+    HeapStats heap_stats[mb_heap_scope_max];
+
+    // The registered service accounts, empty when only the account of begin is used
+    std::vector<esp_google_sheet_account_t> accounts;
+    // The account that its state is in the config and the account that is used for the requests
+    size_t active_account = 0;
+    size_t selected_account = 0;
+    // The account that was refreshed in background and the account that its JWT is in the signer buffers
+    size_t refresh_account = 0;
+    size_t signer_account = 0;
+
     void auth(const char *client_email, const char *project_id, const char *private_key, const char *sa_key_file, esp_google_sheet_file_storage_type storage_type, ESP8266_SPI_ETH_MODULE *eth = nullptr);
     void setTokenCallback(TokenStatusCallback callback);
     void addAP(const char *ssid, const char *password);
     void clearAP();
-    bool checkToken();
+    bool checkToken(bool background = false);
     String accessToken();
     void setPrerefreshSeconds(uint16_t seconds);
+    void setRateLimit(uint16_t readPerMinute, uint16_t writePerMinute, uint16_t readBurst, uint16_t writeBurst);
+    void setRetry(uint8_t maxRetry, unsigned long backoffBase, unsigned long backoffMax, unsigned long maxWait);
+    void refillBucket(esp_google_sheet_rate_limit_bucket_t &bucket);
+    unsigned long quotaWait(bool write);
+    bool waitRequestQuota(bool write);
+    bool idempotentRequest(const MB_String &req);
+    bool retryRequest(int httpcode, uint8_t attempt, bool idempotent);
+    void setTimingBuffer(size_t size);
+    bool getTiming(size_t index, RequestTiming &timing);
+    void commitTiming();
+    void enableMetrics(bool enable);
+    void resetMetrics();
+    void printMetrics(Print &out, esp_google_sheet_metrics_format format);
+    bool dumpTrace(const char *filename, esp_google_sheet_file_storage_type storage_type);
+    void setResponse(FirebaseJson *json, MB_String &response);
+    void setResponse(String *str, MB_String &response);
     bool isError(MB_String &response);
-    bool get(MB_String &response, const char *spreadsheetId, const char *range);
-    bool batchGet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *majorDimension = "", const char *valueRenderOption = "", const char *dateTimeRenderOption = "");
-    bool batchGetByDataFilter(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray, const char *majorDimension = "", const char *valueRenderOption = "", const char *dateTimeRenderOption = "");
+    bool get(MB_String &response, const char *spreadsheetId, const char *range, const char *fields = "");
+    bool batchGet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *majorDimension = "", const char *valueRenderOption = "", const char *dateTimeRenderOption = "", const char *fields = "");
+    bool batchGetByDataFilter(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray, const char *majorDimension = "", const char *valueRenderOption = "", const char *dateTimeRenderOption = "", const char *fields = "");
     bool append(MB_String &response, const char *spreadsheetId, const char *range, FirebaseJson *valueRange, const char *valueInputOption = "USER_ENTERED", const char *insertDataOption = "", const char *includeValuesInResponse = "", const char *responseValueRenderOption = "", const char *responseDateTimeRenderOption = "");
     bool update(MB_String &response, const char *spreadsheetId, const char *range, FirebaseJson *valueRange, const char *valueInputOption = "USER_ENTERED", const char *includeValuesInResponse = "", const char *responseValueRenderOption = "", const char *responseDateTimeRenderOption = "");
     bool _batchUpdate(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *valueRangeArray, const char *valueInputOption = "USER_ENTERED", const char *includeValuesInResponse = "", const char *responseValueRenderOption = "", const char *responseDateTimeRenderOption = "");
@@ -73,20 +153,38 @@ private:
     bool copyTo(MB_String &response, const char *spreadsheetId, uint32_t sheetId, const char *destinationSpreadsheetId);
     bool batchUpdate(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *requestsArray, const char *includeSpreadsheetInResponse = "", const char *responseRanges = "", const char *responseIncludeGridData = "");
     bool create(MB_String &response, FirebaseJson *spreadsheet, const char *sharedUserEmail);
-    bool getMetadata(MB_String &response, const char *spreadsheetId, uint32_t metadataId);
+    bool getMetadata(MB_String &response, const char *spreadsheetId, uint32_t metadataId, const char *fields = "");
     bool searchMetadata(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray);
     bool deleteFile(MB_String &response, const char *spreadsheetId, bool closeSession = true);
-    bool getSpreadsheet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *includeGridData = "");
-    bool getSpreadsheetByDataFilter(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray, const char *includeGridData = "");
+    bool getSpreadsheet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *includeGridData = "", const char *fields = "");
+    bool getSpreadsheetByDataFilter(MB_String &response, const char *spreadsheetId, FirebaseJsonArray *dataFiltersArray, const char *includeGridData = "", const char *fields = "");
     bool deleteFiles(MB_String &response);
-    bool listFiles(MB_String &response, uint32_t pageSize = 5, const char *orderBy = "", const char *pageToken = "");
+    bool listFiles(MB_String &response, uint32_t pageSize = 5, const char *orderBy = "", const char *pageToken = "", const char *fields = "");
     bool beginRequest(MB_String &req, host_type_t host_type);
-    void addHeader(MB_String &req, host_type_t host_type, int len = -1);
-    bool processRequest(MB_String &req, MB_String &response, int &httpcode);
+    void beginHost(host_type_t host_type);
+    void setKeepWarm(unsigned long idleTimeout, unsigned long window, bool ping);
+    void keepWarmTask();
+    bool pingConnection();
+    void addHeader(HttpHelper::RequestComposer &rc, host_type_t host_type, int len = -1);
+    const char *headerBlock(host_type_t host_type);
+    bool processRequest(MB_String &req, MB_String &response, int &httpcode, const char *body = nullptr);
     void mUpdateInit(FirebaseJson *js, FirebaseJsonArray *rangeArr, const char *valueInputOption, const char *includeValuesInResponse, const char *responseValueRenderOption, const char *responseDateTimeRenderOption);
     bool mUpdate(bool append, operation_type_t type, MB_String &response, const char *spreadsheetId, const char *range, FirebaseJson *valueRange, const char *valueInputOption = "USER_ENTERED", const char *insertDataOption = "", const char *includeValuesInResponse = "", const char *responseValueRenderOption = "", const char *responseDateTimeRenderOption = "");
     bool mClear(MB_String &response, const char *spreadsheetId, const char *ranges, operation_type_t type);
-    bool mGet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *majorDimension, const char *valueRenderOption, const char *dateTimeRenderOption, operation_type_t type);
+    bool mGet(MB_String &response, const char *spreadsheetId, const char *ranges, const char *majorDimension, const char *valueRenderOption, const char *dateTimeRenderOption, operation_type_t type, const char *fields = "");
+    void addFieldMask(HttpHelper::RequestComposer &rc, const char *fields, bool hasParam);
+    void sliceValueRanges(MB_String &response, std::vector<esp_google_sheet_a1_range_t> &requested,
+                          std::vector<esp_google_sheet_a1_range_t> &planned, std::vector<size_t> &owner);
+    bool queueGet(const char *spreadsheetId, const char *range, FirebaseJson *json, String *str);
+    bool flushGet();
+    bool flushBatch();
+    void readBatchTask();
+    void setCache(size_t size, unsigned long ttl, esp_google_sheet_file_storage_type storage_type);
+    void clearCache();
+    bool cacheGet(const MB_String &key, MB_String &response);
+    void cachePut(const MB_String &key, const char *spreadsheetId, const char *ranges, const MB_String &response);
+    void cacheRemove(size_t index);
+    void cacheInvalidate(const char *spreadsheetId, const char *ranges, bool append = false);
     MB_String mGetValue(MB_String &response, const char *key);
     bool createPermission(MB_String &response, const char *fileId, const char *role, const char *type, const char *email);
     bool setClock(float gmtOffset);
@@ -97,6 +195,14 @@ private:
     bool setSecure();
     void setCert(const char *ca);
     void setCertFile(const char *filename, esp_google_sheet_file_storage_type type);
+    void setKeyCacheFile(const char *filename, esp_google_sheet_file_storage_type type);
+    void setTimeFromHttpDate(bool enable);
+    int addAccount(const char *client_email, const char *project_id, const char *private_key, const char *sa_key_file, esp_google_sheet_file_storage_type storage_type);
+    bool selectAccount(size_t index);
+    void activateAccount(size_t index);
+    void swapAccount(esp_google_sheet_account_t &account);
+    bool accountTokenValid(size_t index);
+    void accountTask();
     void reset();
     bool waitClockReady();
 };
@@ -114,24 +220,28 @@ public:
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (string) The ID of the spreadsheet to retrieve data from.
      * @param range (string) The A1 notation or R1C1 notation of the range to retrieve values from.
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(range,values).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_VALUES.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.values/get
      */
-    template <typename T1 = const char *, typename T2 = const char *>
-    bool get(FirebaseJson *response, T1 spreadsheetId, T2 range)
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool get(FirebaseJson *response, T1 spreadsheetId, T2 range, T3 fields = "")
     {
         if (!gsheet)
             return false;
 
         MB_String _response;
 
-        bool ret = gsheet->get(_response, toString(spreadsheetId), toString(range));
+        bool ret = gsheet->get(_response, toString(spreadsheetId), toString(range), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -141,24 +251,28 @@ public:
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (string) The ID of the spreadsheet to retrieve data from.
      * @param range (string) The A1 notation or R1C1 notation of the range to retrieve values from.
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(range,values).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_VALUES.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.values/get
      */
-    template <typename T1 = const char *, typename T2 = const char *>
-    bool get(String *response, T1 spreadsheetId, T2 range)
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool get(String *response, T1 spreadsheetId, T2 range, T3 fields = "")
     {
         if (!gsheet)
             return false;
 
         MB_String _response;
 
-        bool ret = gsheet->get(_response, toString(spreadsheetId), toString(range));
+        bool ret = gsheet->get(_response, toString(spreadsheetId), toString(range), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -168,6 +282,10 @@ public:
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (string) The ID of the spreadsheet to retrieve data from.
      * @param ranges (string) The A1 notation or R1C1 notation of the range to retrieve values from. Ranges separated with comma ",".
+     *
+     * @note The adjacent and overlapping A1 ranges of the same sheet are merged into one request range
+     * and the response is sliced back to the requested ranges.
+     *
      * @param majorDimension (enum string) The major dimension that results should use.
      *
      * @note If the spreadsheet data is: A1=1,B1=2,A2=3,B2=4,
@@ -203,24 +321,28 @@ public:
      * FORMATTED_STRING     Instructs date, time, datetime, and duration fields to be output as strings in their given number
      *                      format (which is dependent on the spreadsheet locale).
      *
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(valueRanges(range,values)).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_VALUE_RANGES.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      *
      * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.values/batchGet
      */
-    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *>
-    bool batchGet(FirebaseJson *response, T1 spreadsheetId, T2 ranges, T3 majorDimension = "", T4 valueRenderOption = "", T5 dateTimeRenderOption = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *, typename T6 = const char *>
+    bool batchGet(FirebaseJson *response, T1 spreadsheetId, T2 ranges, T3 majorDimension = "", T4 valueRenderOption = "", T5 dateTimeRenderOption = "", T6 fields = "")
     {
         if (!gsheet)
             return false;
 
         MB_String _response;
-        bool ret = gsheet->batchGet(_response, toString(spreadsheetId), toString(ranges), toString(majorDimension), toString(valueRenderOption), toString(dateTimeRenderOption));
+        bool ret = gsheet->batchGet(_response, toString(spreadsheetId), toString(ranges), toString(majorDimension), toString(valueRenderOption), toString(dateTimeRenderOption), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -230,6 +352,10 @@ public:
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (string) The ID of the spreadsheet to retrieve data from.
      * @param ranges (string) The A1 notation or R1C1 notation of the range to retrieve values from. Ranges separated with comma ",".
+     *
+     * @note The adjacent and overlapping A1 ranges of the same sheet are merged into one request range
+     * and the response is sliced back to the requested ranges.
+     *
      * @param majorDimension (enum string) The major dimension that results should use.
      *
      * @note If the spreadsheet data is: A1=1,B1=2,A2=3,B2=4,
@@ -265,24 +391,28 @@ public:
      * FORMATTED_STRING     Instructs date, time, datetime, and duration fields to be output as strings in their given number
      *                      format (which is dependent on the spreadsheet locale).
      *
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(valueRanges(range,values)).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_VALUE_RANGES.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      *
      * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.values/batchGet
      */
-    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *>
-    bool batchGet(String *response, T1 spreadsheetId, T2 ranges, T3 majorDimension = "", T4 valueRenderOption = "", T5 dateTimeRenderOption = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *, typename T6 = const char *>
+    bool batchGet(String *response, T1 spreadsheetId, T2 ranges, T3 majorDimension = "", T4 valueRenderOption = "", T5 dateTimeRenderOption = "", T6 fields = "")
     {
         if (!gsheet)
             return false;
 
         MB_String _response;
-        bool ret = gsheet->batchGet(_response, toString(spreadsheetId), toString(ranges), toString(majorDimension), toString(valueRenderOption), toString(dateTimeRenderOption));
+        bool ret = gsheet->batchGet(_response, toString(spreadsheetId), toString(ranges), toString(majorDimension), toString(valueRenderOption), toString(dateTimeRenderOption), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -327,25 +457,30 @@ public:
      *                      February 1st 1900 at 3pm would be 33.625. This correctly treats the year 1900 as not a leap year.
      * FORMATTED_STRING     Instructs date, time, datetime, and duration fields to be output as strings in their given number
      *                      format (which is dependent on the spreadsheet locale).
+     *
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(valueRanges(valueRange(range,values))).
+     *
+     * @note See GS_Const.h for the predefined masks.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      *
      * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.values/batchGetByDataFilter
      */
-    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *>
-    bool batchGetByDataFilter(FirebaseJson *response, T1 spreadsheetId, FirebaseJsonArray *dataFiltersArray, T2 majorDimension, T3 valueRenderOption = "", T4 dateTimeRenderOption = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *>
+    bool batchGetByDataFilter(FirebaseJson *response, T1 spreadsheetId, FirebaseJsonArray *dataFiltersArray, T2 majorDimension, T3 valueRenderOption = "", T4 dateTimeRenderOption = "", T5 fields = "")
     {
         if (!gsheet)
             return false;
 
         MB_String _response;
 
-        bool ret = gsheet->batchGetByDataFilter(_response, toString(spreadsheetId), dataFiltersArray, toString(majorDimension), toString(valueRenderOption), toString(dateTimeRenderOption));
+        bool ret = gsheet->batchGetByDataFilter(_response, toString(spreadsheetId), dataFiltersArray, toString(majorDimension), toString(valueRenderOption), toString(dateTimeRenderOption), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -390,25 +525,30 @@ public:
      *                      February 1st 1900 at 3pm would be 33.625. This correctly treats the year 1900 as not a leap year.
      * FORMATTED_STRING     Instructs date, time, datetime, and duration fields to be output as strings in their given number
      *                      format (which is dependent on the spreadsheet locale).
+     *
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(valueRanges(valueRange(range,values))).
+     *
+     * @note See GS_Const.h for the predefined masks.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      *
      * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.values/batchGetByDataFilter
      */
-    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *>
-    bool batchGetByDataFilter(String *response, T1 spreadsheetId, FirebaseJsonArray *dataFiltersArray, T2 majorDimension, T3 valueRenderOption = "", T4 dateTimeRenderOption = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *>
+    bool batchGetByDataFilter(String *response, T1 spreadsheetId, FirebaseJsonArray *dataFiltersArray, T2 majorDimension, T3 valueRenderOption = "", T4 dateTimeRenderOption = "", T5 fields = "")
     {
         if (!gsheet)
             return false;
 
         MB_String _response;
 
-        bool ret = gsheet->batchGetByDataFilter(_response, toString(spreadsheetId), dataFiltersArray, toString(majorDimension), toString(valueRenderOption), toString(dateTimeRenderOption));
+        bool ret = gsheet->batchGetByDataFilter(_response, toString(spreadsheetId), dataFiltersArray, toString(majorDimension), toString(valueRenderOption), toString(dateTimeRenderOption), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -481,7 +621,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -554,7 +694,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -618,7 +758,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -682,7 +822,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
         return ret;
     }
 
@@ -744,7 +884,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -807,7 +947,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -870,7 +1010,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -933,7 +1073,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -961,7 +1101,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -989,7 +1129,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -999,6 +1139,8 @@ public:
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (string) The ID of the spreadsheet to update.
      * @param ranges (string) The ranges to clear, in A1 or R1C1 notation. Ranges separated with comma ",".
+     *
+     * @note The adjacent and overlapping A1 ranges of the same sheet are merged before sending.
      * @return Boolean type status indicates the success of the operation.
      *
      *
@@ -1017,7 +1159,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1027,6 +1169,8 @@ public:
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (string) The ID of the spreadsheet to update.
      * @param ranges (string) The ranges to clear, in A1 or R1C1 notation. Ranges separated with comma ",".
+     *
+     * @note The adjacent and overlapping A1 ranges of the same sheet are merged before sending.
      * @return Boolean type status indicates the success of the operation.
      *
      *
@@ -1044,7 +1188,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1072,7 +1216,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1100,11 +1244,88 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
 
+    /** Queue a range of values to get from a spreadsheet.
+     *
+     * @param response (FirebaseJson or String) The response that will be set when the queued requests were sent.
+     * @param spreadsheetId (string) The ID of the spreadsheet to retrieve data from.
+     * @param range (string) The A1 notation or R1C1 notation of the range to retrieve values from.
+     * @return Boolean type status indicates the success of the operation.
+     *
+     * @note The queued ranges of the same spreadsheet are sent as one values:batchGet request
+     * when flushGet is called or when GSheet.ready() is called after the queue window elapsed.
+     * The response of each range is the same as values.get response (ValueRange object).
+     * The response object should exist until the queued requests were sent.
+     *
+     * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.values/batchGet
+     */
+    template <typename T1 = const char *, typename T2 = const char *>
+    bool queueGet(FirebaseJson *response, T1 spreadsheetId, T2 range)
+    {
+        if (!gsheet)
+            return false;
+
+        return gsheet->queueGet(toString(spreadsheetId), toString(range), response, nullptr);
+    }
+
+    /** Queue a range of values to get from a spreadsheet.
+     *
+     * @param response (FirebaseJson or String) The response that will be set when the queued requests were sent.
+     * @param spreadsheetId (string) The ID of the spreadsheet to retrieve data from.
+     * @param range (string) The A1 notation or R1C1 notation of the range to retrieve values from.
+     * @return Boolean type status indicates the success of the operation.
+     *
+     * @note The queued ranges of the same spreadsheet are sent as one values:batchGet request
+     * when flushGet is called or when GSheet.ready() is called after the queue window elapsed.
+     * The response of each range is the same as values.get response (ValueRange object).
+     * The response object should exist until the queued requests were sent.
+     *
+     * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.values/batchGet
+     */
+    template <typename T1 = const char *, typename T2 = const char *>
+    bool queueGet(String *response, T1 spreadsheetId, T2 range)
+    {
+        if (!gsheet)
+            return false;
+
+        return gsheet->queueGet(toString(spreadsheetId), toString(range), nullptr, response);
+    }
+
+    /** Send all queued get requests.
+     *
+     * @return Boolean type status indicates the success of the operation.
+     *
+     * @note The responses of the failed batch are set with the error response.
+     */
+    bool flushGet()
+    {
+        if (!gsheet)
+            return false;
+
+        return gsheet->flushGet();
+    }
+
+    /** Get the number of queued get requests.
+     *
+     * @return The number of queued requests that were not yet sent.
+     */
+    size_t queuedGet() { return gsheet ? gsheet->read_batch.size() : 0; }
+
+    /** Set the time window to collect the queued get requests.
+     *
+     * @param ms The time in ms from the first queued request until the queue was sent from GSheet.ready().
+     * Default value is 100 ms.
+     */
+    void setQueueWindow(uint16_t ms)
+    {
+        if (gsheet)
+            gsheet->read_batch_window = ms;
+    }
+
 private:
     GSheetClass *gsheet = NULL;
     void init(GSheetClass *gsheet) { this->gsheet = gsheet; }
@@ -1158,7 +1379,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1190,7 +1411,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1226,24 +1447,28 @@ public:
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (string) The ID of the spreadsheet to retrieve metadata from.
      * @param metadataId (integer) The ID of the developer metadata to retrieve.
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(metadataKey,metadataValue).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_DEVELOPER_METADATA.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.developerMetadata/get
      */
-    template <typename T = const char *>
-    bool get(FirebaseJson *response, T spreadsheetId, uint32_t metadataId)
+    template <typename T1 = const char *, typename T2 = const char *>
+    bool get(FirebaseJson *response, T1 spreadsheetId, uint32_t metadataId, T2 fields = "")
     {
         if (!gsheet)
             return false;
 
         MB_String _response;
 
-        bool ret = gsheet->getMetadata(_response, toString(spreadsheetId), metadataId);
+        bool ret = gsheet->getMetadata(_response, toString(spreadsheetId), metadataId, toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1253,24 +1478,28 @@ public:
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (string) The ID of the spreadsheet to retrieve metadata from.
      * @param metadataId (integer) The ID of the developer metadata to retrieve.
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(metadataKey,metadataValue).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_DEVELOPER_METADATA.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      * For ref doc go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets.developerMetadata/get
      */
-    template <typename T = const char *>
-    bool get(String *response, T spreadsheetId, uint32_t metadataId)
+    template <typename T1 = const char *, typename T2 = const char *>
+    bool get(String *response, T1 spreadsheetId, uint32_t metadataId, T2 fields = "")
     {
         if (!gsheet)
             return false;
 
         MB_String _response;
 
-        bool ret = gsheet->getMetadata(_response, toString(spreadsheetId), metadataId);
+        bool ret = gsheet->getMetadata(_response, toString(spreadsheetId), metadataId, toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1298,7 +1527,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1326,7 +1555,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1410,6 +1639,18 @@ public:
     template <typename T = const char *>
     void setCertFile(T filename, esp_google_sheet_file_storage_type storageType) { gsheet->setCertFile(toString(filename), storageType); }
 
+    /** Set the file to cache the parsed Service Account's JSON key file.
+     *
+     * @param filename The cache file name included path.
+     * @param storageType The storage type of the cache file. esp_google_sheet_file_storage_type_flash or esp_google_sheet_file_storage_type_sd
+     *
+     * The private key is stored as the binary DER key with the other credentials. When the JSON key file is not
+     * changed, the credentials are loaded from this file and the JSON, PEM and base64 parsing are skipped.
+     * The cache file is not encrypted, keep it in the same storage as the JSON key file.
+     */
+    template <typename T = const char *>
+    void setKeyCacheFile(T filename, esp_google_sheet_file_storage_type storageType) { gsheet->setKeyCacheFile(toString(filename), storageType); }
+
     /** Set the OAuth2.0 token generation status callback.
      *
      * @param callback The callback function that accepts the TokenInfo as argument.
@@ -1484,11 +1725,21 @@ public:
     /** Get the authentication ready status and process the authentication.
      *
      * @note This function should be called repeatedly in loop.
+     * The token is refreshed here before it expires, the requests keep using the current token until
+     * the new token was received.
      *
      */
     bool ready()
     {
-        return gsheet->checkToken();
+        bool ret = gsheet->checkToken(true);
+
+        if (ret)
+        {
+            gsheet->readBatchTask();
+            gsheet->keepWarmTask();
+        }
+
+        return ret;
     }
 
     /**
@@ -1504,12 +1755,256 @@ public:
      * @param seconds The seconds (60 sec to 3540 sec) that auth token will refresh before expired.
      * Default value is 300 seconds.
      *
+     * The refresh starts at random time up to half of these seconds earlier to spread the token requests
+     * from many devices.
+     *
      */
     void setPrerefreshSeconds(uint16_t seconds)
     {
         gsheet->setPrerefreshSeconds(seconds);
     }
 
+    /** Set the client side request rate limit.
+     *
+     * @param readPerMinute The number of read (GET) requests allowed per minute, 0 for unlimited.
+     * @param writePerMinute The number of write requests allowed per minute, 0 for unlimited.
+     * @param readBurst The maximum number of read requests that can be sent back to back.
+     * @param writeBurst The maximum number of write requests that can be sent back to back.
+     *
+     * @note The rate limit is off (unlimited) by default, the Sheets API per user quota is 60 read and 60 write
+     * requests per minute e.g. setRateLimit(60, 60).
+     * The queued values get requests (queueGet) are delayed to the later GSheet.ready() calls,
+     * the other requests that exceed the limit wait in the call up to the maxWait of setRetry.
+     *
+     */
+    void setRateLimit(uint16_t readPerMinute, uint16_t writePerMinute, uint16_t readBurst = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_REQUEST_BURST,
+                      uint16_t writeBurst = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_REQUEST_BURST)
+    {
+        gsheet->setRateLimit(readPerMinute, writePerMinute, readBurst, writeBurst);
+    }
+
+    /** Set the retry option for the request that was rejected with HTTP 429 or 5xx.
+     *
+     * @param maxRetry The maximum number of retries, 0 for no retry.
+     * @param backoffBase The first backoff delay in ms which will be doubled (with jitter) on every retry.
+     * @param backoffMax The maximum backoff delay in ms.
+     * @param maxWait The longest time in ms that the request can be delayed before it was dropped.
+     *
+     * @note The server Retry-After header is used instead of backoff delay when presents.
+     * The requests that can't be repeated safely (append, batchUpdate and create) are retried only
+     * on HTTP 429, or HTTP 503 with Retry-After header, the server may have committed them before 5xx error.
+     *
+     */
+    void setRetry(uint8_t maxRetry, unsigned long backoffBase = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_RETRY_BACKOFF_BASE,
+                  unsigned long backoffMax = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_RETRY_BACKOFF_MAX,
+                  unsigned long maxWait = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_MAX_THROTTLE_WAIT)
+    {
+        gsheet->setRetry(maxRetry, backoffBase, backoffMax, maxWait);
+    }
+
+    /** Get the rate limiter counters.
+     *
+     * @return RateLimitStats that contains the number of throttled, retried and dropped requests.
+     *
+     */
+    RateLimitStats rateLimitStats() { return gsheet->config.rate_limit.stats; }
+
+    /** Reset the rate limiter counters.
+     *
+     */
+    void resetRateLimitStats() { gsheet->config.rate_limit.stats = RateLimitStats(); }
+
+    /** Set the values get response cache.
+     *
+     * @param size The maximum number of cached responses, 0 to disable the cache.
+     * @param ttl The time in ms that the cached response is valid.
+     * @param storage_type The optional storage type e.g. esp_google_sheet_file_storage_type_flash and esp_google_sheet_file_storage_type_sd
+     * to keep the large response in file instead of memory.
+     *
+     * @note The values.get and values.batchGet responses are cached by spreadsheet ID, ranges and render options.
+     * The cached responses are removed when the values update, append and clear or spreadsheet batchUpdate were
+     * called on the intersecting ranges of the same spreadsheet.
+     *
+     */
+    void setCache(size_t size, unsigned long ttl = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_CACHE_TTL, esp_google_sheet_file_storage_type storage_type = esp_google_sheet_file_storage_type_undefined)
+    {
+        gsheet->setCache(size, ttl, storage_type);
+    }
+
+    /** Remove all cached responses.
+     *
+     */
+    void clearCache() { gsheet->clearCache(); }
+
+    /** Keep the connection warm between the requests.
+     *
+     * @param idleTimeout The idle time in ms that the server closes the kept alive connection, 0 to disable (default).
+     * @param window The time in ms after the last request that the next request is expected.
+     * @param ping Set true to send the cheap request that keeps the connection open instead of reconnecting.
+     *
+     * @note While the next request is expected, the connection is renewed (or pinged) from ready() in loop
+     * shortly before the idle timeout, then the request does not wait for the TCP connect and TLS handshake.
+     * The connection that was closed or half-closed by the server, or idle for longer than the idle timeout,
+     * is reconnected before sending the request instead of after the failed write.
+     *
+     */
+    void setKeepWarm(unsigned long idleTimeout, unsigned long window = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_KEEP_WARM_WINDOW, bool ping = false)
+    {
+        gsheet->setKeepWarm(idleTimeout, window, ping);
+    }
+
+    /** Set the adaptive timeouts that were estimated from the measured round trip time and throughput.
+     *
+     * @param enable Set true to enable or false to use the fixed timeouts (default).
+     * @param floor The minimum timeout in ms.
+     * @param ceiling The maximum timeout in ms.
+     *
+     * @note The TCP connect, first byte and inter-chunk (the wait for the next response data) timeouts of each host are
+     * the smoothed time plus 4 times of its mean deviation (RFC 6298) of the previous requests, the inter-chunk timeout
+     * also includes the time to receive the chunk at the estimated throughput. The fixed timeouts are used until
+     * the first sample. The timeout is doubled after it was timed out.
+     *
+     */
+    void setAdaptiveTimeout(bool enable, unsigned long floor = ESP_GOOGLE_SHEET_CLIENT_MIN_SERVER_RESPONSE_TIMEOUT, unsigned long ceiling = ESP_GOOGLE_SHEET_CLIENT_MAX_SERVER_RESPONSE_TIMEOUT)
+    {
+        gsheet->config.adaptive.enabled = enable;
+        gsheet->config.adaptive.floor = floor;
+        gsheet->config.adaptive.ceiling = ceiling < floor ? floor : ceiling;
+    }
+
+    /** Set the DNS cache of the Google API hosts.
+     *
+     * @param ttl The time in seconds that the resolved address is used before it was resolved again, 0 to disable the cache.
+     * @param negativeTtl The time in seconds that the failed lookup is kept, the connection fails without the lookup in this period.
+     * @param cache The optional DNSCache storage e.g. RTC_DATA_ATTR DNSCache dnsCache; to keep the entries across the deep sleep.
+     *
+     * @note The connection is made by the cached address while the host name is still used for the SNI and certificate
+     * verification. The entry is removed when the connection by its address was failed.
+     * This applies only to the internal WiFi client, the external clients resolve the host by themselves.
+     *
+     */
+    void setDNSCache(unsigned long ttl = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_DNS_TTL, unsigned long negativeTtl = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_DNS_NEGATIVE_TTL, DNSCache *cache = nullptr)
+    {
+        gsheet->config.dns.ttl = ttl;
+        gsheet->config.dns.negativeTtl = negativeTtl;
+        gsheet->config.dns.cache = cache;
+    }
+
+    /** Remove all DNS cache entries.
+     *
+     */
+    void clearDNSCache()
+    {
+        DNSCache *cache = gsheet->config.dns.cache ? gsheet->config.dns.cache : &gsheet->config.dns.local;
+        memset(cache, 0, sizeof(DNSCache));
+    }
+
+    /** Set the callback function that receives the latency breakdown of each request.
+     *
+     * @param callback The RequestTimingCallback function that accepts the RequestTiming as parameter.
+     *
+     * @note The RequestTiming contains the time in microseconds spent in the token check, rate limit wait,
+     * TCP connect and TLS handshake, send, time to first byte, header read, body read and JSON parse,
+     * and the number of bytes sent and received.
+     *
+     */
+    void setTimingCallback(RequestTimingCallback callback) { gsheet->timing_cb = callback; }
+
+    /** Set the number of the latency records to keep in the ring buffer.
+     *
+     * @param size The number of records, 0 to disable. The oldest record will be overwritten when it is full.
+     *
+     */
+    void setTimingBuffer(size_t size) { gsheet->setTimingBuffer(size); }
+
+    /** Get the number of the latency records in the ring buffer.
+     *
+     * @return The number of records.
+     *
+     */
+    size_t timingCount() { return gsheet->timing_buf.size(); }
+
+    /** Get the latency record from the ring buffer.
+     *
+     * @param index The index of record, 0 for the oldest record.
+     * @param timing The RequestTiming to keep the record.
+     * @return Boolean type status indicates the success of the operation.
+     *
+     */
+    bool getTiming(size_t index, RequestTiming &timing) { return gsheet->getTiming(index, timing); }
+
+    /** Remove all latency records from the ring buffer.
+     *
+     */
+    void clearTiming() { gsheet->setTimingBuffer(gsheet->timing_buf_size); }
+
+    /** Get the heap usage of the last operation.
+     *
+     * @param scope The mb_heap_scope e.g. mb_heap_scope_auth, mb_heap_scope_request, mb_heap_scope_response,
+     * mb_heap_scope_json and mb_heap_scope_total (default).
+     * @return HeapStats that contains the live bytes, the peak live bytes and the number of allocations.
+     *
+     * @note The allocations from MB_String, MB_FS, FirebaseJson and MB_JSON are counted only when MB_HEAP_ACCOUNTING
+     * was defined in the compiler build flags e.g. build_flags = -D MB_HEAP_ACCOUNTING in PlatformIO.
+     * Every allocation takes 8 more bytes for its size header when it was enabled.
+     *
+     */
+    HeapStats heapStats(mb_heap_scope scope = mb_heap_scope_total) { return gsheet->heap_stats[scope < mb_heap_scope_max ? scope : mb_heap_scope_total]; }
+
+    /** Enable or disable the metrics registry.
+     *
+     * @param enable The boolean option to enable the metrics registry.
+     *
+     * @note The registry takes fixed memory (about 1.2 kB) when it was enabled. It counts the requests by endpoint
+     * and HTTP code, retries, network reconnections, token requests and keeps the latency histograms
+     * of the requests and JWT signing.
+     *
+     */
+    void enableMetrics(bool enable) { gsheet->enableMetrics(enable); }
+
+    /** Clear all metrics counters and histograms.
+     *
+     */
+    void resetMetrics() { gsheet->resetMetrics(); }
+
+    /** Print the metrics to Print object e.g. Serial or WiFiClient.
+     *
+     * @param out The Print object.
+     * @param format The esp_google_sheet_metrics_format e.g. esp_google_sheet_metrics_format_prometheus (default)
+     * for the Prometheus text exposition format and esp_google_sheet_metrics_format_json for the compact JSON.
+     *
+     */
+    void printMetrics(Print &out, esp_google_sheet_metrics_format format = esp_google_sheet_metrics_format_prometheus)
+    {
+        gsheet->printMetrics(out, format);
+    }
+
+    /** Print the trace events to Print object e.g. Serial in Chrome trace event format.
+     *
+     * @param out The Print object.
+     *
+     * @note The connect, send chunk, first byte, read chunk, chunk header, response timeout, token step and
+     * token status events are kept in the fixed size ring buffer (ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE) only when
+     * ESP_GOOGLE_SHEET_CLIENT_ENABLE_TRACE was defined in ESP_Google_Sheet_Client_FS_Config.h.
+     * The output can be opened with chrome://tracing or https://ui.perfetto.dev.
+     *
+     */
+    void dumpTrace(Print &out) { TraceHelper::dump(out); }
+
+    /** Save the trace events to file in Chrome trace event format.
+     *
+     * @param filename The file name to save.
+     * @param storage_type The storage type e.g. esp_google_sheet_file_storage_type_flash and esp_google_sheet_file_storage_type_sd.
+     * @return Boolean type status indicates the success of the operation.
+     *
+     */
+    bool dumpTrace(const char *filename, esp_google_sheet_file_storage_type storage_type) { return gsheet->dumpTrace(filename, storage_type); }
+
+    /** Remove all trace events.
+     *
+     */
+    void clearTrace() { TraceHelper::clear(); }
+
     /**
      * Get the token type string.
      *
@@ -1559,6 +2054,48 @@ public:
      */
     bool setSystemTime(time_t ts) { return gsheet->authMan.setTime(ts); }
 
+    /** Set the system time from the Date header of the server response when NTP time is not ready.
+     *
+     * @param enable The boolean option to enable.
+     *
+     * The NTP time synching is started in background without waiting. When the time is required for the JWT token,
+     * it is taken from the Date header of the token server response instead (one second resolution).
+     */
+    void setTimeFromHttpDate(bool enable) { gsheet->setTimeFromHttpDate(enable); }
+
+    /** Add the service account to the account registry.
+     *
+     * @param client_email (string) The Service Account's client email.
+     * @param project_id (string) The project ID.
+     * @param private_key (string) The Service Account's private key.
+     * @return The account index to select with selectAccount, the account of begin is index 0.
+     * When the client email was already added, its index is returned.
+     *
+     * The accounts share the TCP client, SSL and signer buffers, each additional account only keeps its credentials
+     * and access token. The access token of each account is requested and refreshed in background (from ready() in loop).
+     */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    int addAccount(T1 client_email, T2 project_id, T3 private_key) { return gsheet->addAccount(toString(client_email), toString(project_id), toString(private_key), "", esp_google_sheet_file_storage_type_undefined); }
+
+    /** Add the service account to the account registry.
+     *
+     * @param service_account_file (string) The Service Account's JSON key file.
+     * @param storage_type (esp_google_sheet_file_storage_type) The JSON key file storage type e.g. esp_google_sheet_file_storage_type_flash and esp_google_sheet_file_storage_type_sd.
+     * @return The account index to select with selectAccount, the account of begin is index 0.
+     * When the key file was already added, its index is returned.
+     */
+    template <typename T1 = const char *>
+    int addAccount(T1 service_account_file, esp_google_sheet_file_storage_type storage_type) { return gsheet->addAccount("", "", "", toString(service_account_file), storage_type); }
+
+    /** Select the service account for the next requests.
+     *
+     * @param index The account index that returned from addAccount, 0 for the account of begin.
+     * @return Boolean type status indicates the success of the operation.
+     *
+     * The queued reads (queueGet) of the previous account are sent before the account was changed.
+     */
+    bool selectAccount(size_t index) { return gsheet->selectAccount(index); }
+
     /**
      * Formatted printing on Serial.
      *
@@ -1633,7 +2170,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1664,7 +2201,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1702,7 +2239,7 @@ public:
             }
         }
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1739,7 +2276,7 @@ public:
             }
         }
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1753,22 +2290,26 @@ public:
      *
      * @note This parameter is ignored if a field mask was set in the request.
      *
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(spreadsheetId,properties.title).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_SPREADSHEET_PROPERTIES.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      * For ref doc, go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets/get
      *
      */
-    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
-    bool get(FirebaseJson *response, T1 spreadsheetId, T2 ranges = "", T3 includeGridData = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *>
+    bool get(FirebaseJson *response, T1 spreadsheetId, T2 ranges = "", T3 includeGridData = "", T4 fields = "")
     {
         MB_String _response;
 
-        bool ret = gsheet->getSpreadsheet(_response, toString(spreadsheetId), toString(ranges), toString(includeGridData));
+        bool ret = gsheet->getSpreadsheet(_response, toString(spreadsheetId), toString(ranges), toString(includeGridData), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1782,22 +2323,26 @@ public:
      *
      * @note This parameter is ignored if a field mask was set in the request.
      *
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(spreadsheetId,properties.title).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_SPREADSHEET_PROPERTIES.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      * For ref doc, go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets/get
      *
      */
-    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
-    bool get(String *response, T1 spreadsheetId, T2 ranges = "", T3 includeGridData = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *>
+    bool get(String *response, T1 spreadsheetId, T2 ranges = "", T3 includeGridData = "", T4 fields = "")
     {
         MB_String _response;
 
-        bool ret = gsheet->getSpreadsheet(_response, toString(spreadsheetId), toString(ranges), toString(includeGridData));
+        bool ret = gsheet->getSpreadsheet(_response, toString(spreadsheetId), toString(ranges), toString(includeGridData), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1806,23 +2351,28 @@ public:
      *
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (FirebaseJson) The spreadsheet to request.
+     * @param dataFiltersArray (FirebaseJsonArray of DataFilter object) The DataFilters used to select which ranges to retrieve from the spreadsheet.
+     * @param includeGridData (boolean string) True if grid data should be returned.
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(spreadsheetId,properties.title).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_SPREADSHEET_PROPERTIES.
      *
      * @return Boolean type status indicates the success of the operation.
      *
      * For ref doc, go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets/getByDataFilter
      *
      */
-    template <typename T1 = const char *, typename T2 = const char *>
-    bool getByDataFilter(FirebaseJson *response, T1 spreadsheetId, FirebaseJsonArray *dataFiltersArray, T2 includeGridData = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool getByDataFilter(FirebaseJson *response, T1 spreadsheetId, FirebaseJsonArray *dataFiltersArray, T2 includeGridData = "", T3 fields = "")
     {
         MB_String _response;
 
-        bool ret = gsheet->getSpreadsheetByDataFilter(_response, toString(spreadsheetId), dataFiltersArray, toString(includeGridData));
+        bool ret = gsheet->getSpreadsheetByDataFilter(_response, toString(spreadsheetId), dataFiltersArray, toString(includeGridData), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1831,23 +2381,28 @@ public:
      *
      * @param response (FirebaseJson or String) The returned response.
      * @param spreadsheetId (FirebaseJson) The spreadsheet to request.
+     * @param dataFiltersArray (FirebaseJsonArray of DataFilter object) The DataFilters used to select which ranges to retrieve from the spreadsheet.
+     * @param includeGridData (boolean string) True if grid data should be returned.
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(spreadsheetId,properties.title).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_SPREADSHEET_PROPERTIES.
      *
      * @return Boolean type status indicates the success of the operation.
      *
      * For ref doc, go to https://developers.google.com/sheets/api/reference/rest/v4/spreadsheets/getByDataFilter
      *
      */
-    template <typename T1 = const char *, typename T2 = const char *>
-    bool getByDataFilter(String *response, T1 spreadsheetId, FirebaseJsonArray *dataFiltersArray, T2 includeGridData = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool getByDataFilter(String *response, T1 spreadsheetId, FirebaseJsonArray *dataFiltersArray, T2 includeGridData = "", T3 fields = "")
     {
         MB_String _response;
 
-        bool ret = gsheet->getSpreadsheetByDataFilter(_response, toString(spreadsheetId), dataFiltersArray, toString(includeGridData));
+        bool ret = gsheet->getSpreadsheetByDataFilter(_response, toString(spreadsheetId), dataFiltersArray, toString(includeGridData), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1873,7 +2428,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1899,7 +2454,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1924,7 +2479,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1949,7 +2504,7 @@ public:
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -1969,20 +2524,24 @@ public:
      *
      * @note This should be set to the value of 'nextPageToken' from the previous response.
      *
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(files(id,name)).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_FILES.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      */
-    template <typename T1 = const char *, typename T2 = const char *>
-    bool listFiles(FirebaseJson *response, uint32_t pageSize = 5, T1 orderBy = "createdTime%20desc", T2 pageToken = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool listFiles(FirebaseJson *response, uint32_t pageSize = 5, T1 orderBy = "createdTime%20desc", T2 pageToken = "", T3 fields = "")
     {
         MB_String _response;
 
-        bool ret = gsheet->listFiles(_response, pageSize, toString(orderBy), toString(pageToken));
+        bool ret = gsheet->listFiles(_response, pageSize, toString(orderBy), toString(pageToken), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        response->setJsonData(_response);
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -2002,20 +2561,24 @@ public:
      *
      * @note This should be set to the value of 'nextPageToken' from the previous response.
      *
+     * @param fields (string) Optional field mask that limits the response to the listed fields e.g. GSHEET_FIELDS(files(id,name)).
+     *
+     * @note See GS_Const.h for the predefined masks e.g. GSHEET_FIELDS_FILES.
+     *
      * @return Boolean type status indicates the success of the operation.
      *
      */
-    template <typename T1 = const char *, typename T2 = const char *>
-    bool listFiles(String *response, uint32_t pageSize = 5, T1 orderBy = "createdTime%20desc", T2 pageToken = "")
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool listFiles(String *response, uint32_t pageSize = 5, T1 orderBy = "createdTime%20desc", T2 pageToken = "", T3 fields = "")
     {
         MB_String _response;
 
-        bool ret = gsheet->listFiles(_response, pageSize, toString(orderBy), toString(pageToken));
+        bool ret = gsheet->listFiles(_response, pageSize, toString(orderBy), toString(pageToken), toString(fields));
 
         if (ret)
             ret = !gsheet->isError(_response);
 
-        *response = _response.c_str();
+        gsheet->setResponse(response, _response);
 
         return ret;
     }
@@ -77,6 +77,10 @@
 // For ESP8266 W5500 Ethernet module
 // #define ENABLE_ESP8266_W5500_ETH
 
+// To keep the connect, send, read and token events in the trace ring buffer (GSheet.dumpTrace)
+// #define ESP_GOOGLE_SHEET_CLIENT_ENABLE_TRACE
+// #define ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE 128
+
 // To use your custom config, create Custom_ESP_Google_Sheet_Client_FS_Config.h in the same folder of this 
 // ESP_Google_Sheet_Client_FS_Config.h file
 #if __has_include("Custom_ESP_Google_Sheet_Client_FS_Config.h")
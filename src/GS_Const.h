@@ -25,6 +25,66 @@
 #define ESP_GOOGLE_SHEET_CLIENT_MIN_WIFI_RECONNECT_TIMEOUT 10 * 1000
 #define ESP_GOOGLE_SHEET_CLIENT_MAX_WIFI_RECONNECT_TIMEOUT 5 * 60 * 1000
 
+/* Client side request pacing, off (0, unlimited) by default, the Sheets API quota is 60 read and 60 write
+   requests per minute per user */
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_READ_REQUESTS_PER_MINUTE 0
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_WRITE_REQUESTS_PER_MINUTE 0
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_REQUEST_BURST 10
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_MAX_THROTTLE_WAIT (60 * 1000)
+
+/* Queued values get requests of the same spreadsheet are sent as one values:batchGet */
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_READ_BATCH_WINDOW 100
+#define ESP_GOOGLE_SHEET_CLIENT_MAX_READ_BATCH_SIZE 20
+
+/* The A1 notation bounds, column XFD and the row of 10 million cells sheet */
+#define ESP_GOOGLE_SHEET_CLIENT_A1_MAX_COLUMN 16384
+#define ESP_GOOGLE_SHEET_CLIENT_A1_MAX_ROW 10000000
+
+/* Values get response cache, disabled (0 entries) by default */
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_CACHE_TTL 60 * 1000
+/* The response that is larger than this size is stored in file when the cache storage was set */
+#define ESP_GOOGLE_SHEET_CLIENT_CACHE_SPILL_SIZE 1024
+
+/* The resolved host addresses are kept for the TTL and the failed lookups for the negative TTL (in seconds) */
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_DNS_TTL 5 * 60
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_DNS_NEGATIVE_TTL 10
+#define ESP_GOOGLE_SHEET_CLIENT_DNS_CACHE_SIZE 4
+#define ESP_GOOGLE_SHEET_CLIENT_DNS_HOST_LENGTH 32
+
+/* The kept alive connection is renewed or pinged up to this time (ms) before the server idle timeout
+   while the next request is expected (within the keep warm window after the last request) */
+#define ESP_GOOGLE_SHEET_CLIENT_KEEP_WARM_MARGIN 3 * 1000
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_KEEP_WARM_WINDOW 5 * 60 * 1000
+
+/* The adaptive timeouts are estimated per host (sheets, www and oauth2.googleapis.com) */
+#define ESP_GOOGLE_SHEET_CLIENT_ADAPTIVE_TIMEOUT_HOSTS 3
+/* The response that is smaller than this size is not used for the throughput estimate */
+#define ESP_GOOGLE_SHEET_CLIENT_MIN_THROUGHPUT_SAMPLE_SIZE 1024
+
+/* Per-request latency records kept for later reading, disabled (0 records) by default */
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_TIMING_BUFFER_SIZE 0
+
+/* The latency histogram buckets upper bounds are 16 ms, 32 ms, ... 32768 ms */
+#define ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_BUCKETS 12
+#define ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_MIN_MS 16
+
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_MAX_RETRY 3
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_RETRY_BACKOFF_BASE 1000
+#define ESP_GOOGLE_SHEET_CLIENT_DEFAULT_RETRY_BACKOFF_MAX (32 * 1000)
+
+/* Field mask (partial response) builder e.g. GSHEET_FIELDS(spreadsheetId,sheets(properties(sheetId,title))) */
+#define GSHEET_FIELDS(...) #__VA_ARGS__
+
+/* The common field masks which can be joined at compile time e.g. GSHEET_FIELDS_SPREADSHEET_ID "," GSHEET_FIELDS_SHEETS_PROPERTIES */
+#define GSHEET_FIELDS_SPREADSHEET_ID "spreadsheetId"
+#define GSHEET_FIELDS_SPREADSHEET_PROPERTIES "properties(title,locale,timeZone)"
+#define GSHEET_FIELDS_SHEETS_PROPERTIES "sheets(properties(sheetId,title,index,gridProperties))"
+#define GSHEET_FIELDS_VALUES "range,majorDimension,values"
+#define GSHEET_FIELDS_VALUE_RANGES "valueRanges(range,values)"
+#define GSHEET_FIELDS_DEVELOPER_METADATA "metadataId,metadataKey,metadataValue"
+#define GSHEET_FIELDS_FILES "nextPageToken,files(id,name)"
+#define GSHEET_FIELDS_FILE_IDS "files(id)"
+
 #include <Arduino.h>
 #include "mbfs/MB_MCU.h"
 #include "GS_Error.h"
@@ -264,6 +324,21 @@ struct gauth_service_account_t
 {
     struct gauth_service_account_data_info_t data;
     struct gauth_service_account_file_info_t json;
+    // The binary cache of the parsed key file with the DER private key, disabled when the path is empty.
+    struct gauth_service_account_file_info_t key_cache;
+};
+
+// The buffered reader of the service account key file, the checksum covers all bytes that were read.
+struct gauth_sa_file_reader_t
+{
+    mbfs_file_type type = mb_fs_mem_storage_type_undefined;
+    uint8_t buf[64];
+    int len = 0;
+    int pos = 0;
+    // The character that was read ahead, -1 for none.
+    int back = -1;
+    uint32_t size = 0;
+    uint32_t crc = 0xFFFFFFFF;
 };
 
 struct gauth_auth_token_error_t
@@ -279,6 +354,8 @@ struct gauth_auth_token_info_t
     unsigned long expires = 0;
     /* milliseconds count when last expiry time was set */
     unsigned long last_millis = 0;
+    /* random seconds that the refresh starts before the pre-refresh seconds */
+    unsigned long jitter = 0;
     gauth_auth_token_type token_type = token_type_undefined;
     gauth_auth_token_status status = token_status_uninitialized;
     struct gauth_auth_token_error_t error;
@@ -303,17 +380,31 @@ struct gauth_token_signer_resources_t
     unsigned long reqTO = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_REQUEST_TIMEOUT;
     MB_String customHeaders;
     MB_String pk;
+    /* the DER private key that was decoded from pk or loaded from the key cache */
+    uint8_t *der = nullptr;
+    size_t derLen = 0;
     size_t hashSize = 32; // SHA256 size (256 bits or 32 bytes)
     size_t signatureSize = 256;
     char *hash = nullptr;
     unsigned char *signature = nullptr;
-    MB_String encHeader;
-    MB_String encPayload;
-    MB_String encHeadPayload;
-    MB_String encSignature;
     gauth_auth_token_info_t tokens;
 };
 
+// The credentials and token state of a service account in the account registry.
+// The state of the active account is kept in the config, the other accounts are swapped in when they are used.
+struct esp_google_sheet_account_t
+{
+    struct gauth_service_account_t service_account;
+    MB_String pk;
+    uint8_t *der = nullptr;
+    size_t derLen = 0;
+    int step = 0;
+    struct gauth_auth_token_info_t tokens;
+    MB_String auth_token;
+    // The millis when the background token refresh of this account was started
+    unsigned long refresh_millis = 0;
+};
+
 typedef void (*TokenStatusCallback)(TokenInfo);
 
 struct  esp_google_sheet_chunk_state_info
@@ -350,6 +441,8 @@ struct  esp_google_sheet_tcp_response_handler_t
     MB_String header;
     // time out checking for execution
     unsigned long dataTime = 0;
+    // the time out in ms of waiting for the next data since dataTime
+    unsigned long dataTimeout = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_SERVER_RESPONSE_TIMEOUT;
     // pointer to payload
     MB_String *payload = nullptr;
     // data is already in receive buffer (must be int)
@@ -400,6 +493,23 @@ struct  esp_google_sheet_server_response_data_t
     MB_String pushName;
     MB_String fbError;
     MB_String transferEnc;
+    // The Retry-After header value in seconds (429 and 503 responses)
+    int retryAfter = 0;
+    // The Date header value in seconds from midnight Jan 1, 1970, 0 when not available
+    uint32_t date = 0;
+};
+
+struct esp_google_sheet_a1_range_t
+{
+    // The sheet name (quoted or unquoted) without "!", empty for the first visible sheet.
+    MB_String sheet;
+    // The 1-based column and row indexes of the top-left and bottom-right cells.
+    uint32_t col1 = 0;
+    uint32_t row1 = 0;
+    uint32_t col2 = 0;
+    uint32_t row2 = 0;
+    // The whole sheet e.g. Sheet1, it is never merged with the other ranges.
+    bool whole = false;
 };
 
 template <typename T>
@@ -445,9 +555,17 @@ struct gauth_cfg_int_t
     /* flag set when NTP time server synching has been started */
     bool clock_synched = false;
     float gmt_offset = 0;
+
+    /* flag set when the time can be taken from the Date header of the server response */
+    bool http_date_time = false;
+    /* flag set when NTP time server synching has been started in background */
+    bool ntp_started = false;
+    unsigned long last_http_date_millis = 0;
     bool auth_uri = false;
 
     MB_String auth_token;
+    // Increased whenever auth_token was changed
+    uint16_t auth_token_version = 0;
     MB_String refresh_token;
     MB_String client_id;
     MB_String client_secret;
@@ -472,6 +590,9 @@ struct gauth_client_timeout_t
     uint16_t tokenGenerationError = 5 * 1000;
 
     uint16_t ntpServerRequest = 15 * 1000;
+
+    // The idle time in ms that the server closes the kept alive connection, 0 for unknown (keep warm disabled).
+    unsigned long serverIdle = 0;
 };
 
 typedef struct gauth_spi_ethernet_module_t
@@ -491,6 +612,196 @@ typedef struct gauth_spi_ethernet_module_t
 #endif
 } SPI_ETH_Module;
 
+struct esp_google_sheet_rate_limit_bucket_t
+{
+    // The number of requests allowed per minute, 0 for unlimited.
+    uint16_t perMinute = 0;
+    // The maximum number of requests that can be sent back to back.
+    uint16_t burst = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_REQUEST_BURST;
+    float tokens = 0;
+    // 0 when the bucket was never used, filled to burst at first use.
+    unsigned long lastRefillMillis = 0;
+};
+
+typedef struct esp_google_sheet_rate_limit_stats_t
+{
+    // The number of requests that were delayed by the rate limiter or by the server Retry-After.
+    uint32_t throttled = 0;
+    // The number of retries after 429 or 5xx response.
+    uint32_t retried = 0;
+    // The number of requests that were given up (wait exceeded or retries exhausted).
+    uint32_t dropped = 0;
+} RateLimitStats;
+
+typedef struct esp_google_sheet_request_timing_t
+{
+    // The millis() when the operation was started.
+    unsigned long startMillis = 0;
+    // The following phase durations are in microseconds and are accumulated over retries.
+    // The auth token check, includes the token generation when the token was refreshed.
+    uint32_t token = 0;
+    // The time waited for the rate limiter, Retry-After and retry backoff.
+    uint32_t wait = 0;
+    // The TCP connect and TLS handshake, 0 when the connection was reused.
+    uint32_t connect = 0;
+    uint32_t send = 0;
+    // The time to first byte, from the end of send to the first response byte available.
+    uint32_t firstByte = 0;
+    // The status line and headers read and parse.
+    uint32_t header = 0;
+    // The payload read.
+    uint32_t body = 0;
+    // The response JSON parse.
+    uint32_t parse = 0;
+    // The whole operation.
+    uint32_t total = 0;
+    uint32_t bytesSent = 0;
+    // The headers and payload bytes received (chunk framing is not counted).
+    uint32_t bytesReceived = 0;
+    int httpCode = 0;
+    uint8_t retries = 0;
+    // The peak of the counted heap bytes and the number of allocations (requires MB_HEAP_ACCOUNTING build flag).
+    uint32_t heapPeak = 0;
+    uint32_t allocs = 0;
+} RequestTiming;
+
+typedef MB_HeapStats HeapStats;
+
+enum esp_google_sheet_metrics_endpoint
+{
+    esp_google_sheet_metrics_endpoint_values_get,
+    esp_google_sheet_metrics_endpoint_values_batch_get,
+    esp_google_sheet_metrics_endpoint_values_update,
+    esp_google_sheet_metrics_endpoint_values_append,
+    esp_google_sheet_metrics_endpoint_values_batch_update,
+    esp_google_sheet_metrics_endpoint_values_clear,
+    esp_google_sheet_metrics_endpoint_values_batch_clear,
+    esp_google_sheet_metrics_endpoint_spreadsheet_get,
+    esp_google_sheet_metrics_endpoint_spreadsheet_create,
+    esp_google_sheet_metrics_endpoint_spreadsheet_batch_update,
+    esp_google_sheet_metrics_endpoint_sheet_copy,
+    esp_google_sheet_metrics_endpoint_metadata,
+    esp_google_sheet_metrics_endpoint_drive,
+    esp_google_sheet_metrics_endpoint_other,
+    esp_google_sheet_metrics_endpoint_max
+};
+
+enum esp_google_sheet_metrics_code
+{
+    esp_google_sheet_metrics_code_2xx,
+    esp_google_sheet_metrics_code_3xx,
+    esp_google_sheet_metrics_code_4xx,
+    esp_google_sheet_metrics_code_429,
+    esp_google_sheet_metrics_code_5xx,
+    // The TCP or timed out errors
+    esp_google_sheet_metrics_code_error,
+    esp_google_sheet_metrics_code_max
+};
+
+enum esp_google_sheet_metrics_format
+{
+    esp_google_sheet_metrics_format_prometheus,
+    esp_google_sheet_metrics_format_json
+};
+
+struct esp_google_sheet_metrics_histogram_t
+{
+    // The count of each bucket (not cumulative), the value over the last bucket is counted in count only.
+    uint32_t buckets[ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_BUCKETS] = {0};
+    uint32_t count = 0;
+    uint32_t sumMs = 0;
+};
+
+struct esp_google_sheet_metrics_endpoint_t
+{
+    uint32_t codes[esp_google_sheet_metrics_code_max] = {0};
+    struct esp_google_sheet_metrics_histogram_t latency;
+};
+
+struct esp_google_sheet_metrics_t
+{
+    struct esp_google_sheet_metrics_endpoint_t endpoints[esp_google_sheet_metrics_endpoint_max];
+    uint32_t retries = 0;
+    // The network reconnections
+    uint32_t reconnects = 0;
+    // The token requests and the failed token requests
+    uint32_t tokenRefreshes = 0;
+    uint32_t tokenErrors = 0;
+    struct esp_google_sheet_metrics_histogram_t jwtSign;
+};
+
+typedef void (*RequestTimingCallback)(RequestTiming);
+
+// The smoothed value and the mean deviation in ms (RFC 6298), srtt is 0 before the first sample.
+struct esp_google_sheet_rtt_t
+{
+    uint32_t srtt = 0;
+    uint32_t rttvar = 0;
+};
+
+struct esp_google_sheet_host_timing_t
+{
+    char host[ESP_GOOGLE_SHEET_CLIENT_DNS_HOST_LENGTH] = {0};
+    // The TCP connect and TLS handshake.
+    struct esp_google_sheet_rtt_t connect;
+    // The time to first byte, from the end of send to the first response byte.
+    struct esp_google_sheet_rtt_t firstByte;
+    // The longest wait between the response data of each response.
+    struct esp_google_sheet_rtt_t gap;
+    // The smoothed response read throughput in bytes per second, 0 before the first sample.
+    uint32_t throughput = 0;
+};
+
+struct esp_google_sheet_adaptive_timeout_t
+{
+    bool enabled = false;
+    // The user floor and ceiling in ms of the estimated timeouts.
+    unsigned long floor = ESP_GOOGLE_SHEET_CLIENT_MIN_SERVER_RESPONSE_TIMEOUT;
+    unsigned long ceiling = ESP_GOOGLE_SHEET_CLIENT_MAX_SERVER_RESPONSE_TIMEOUT;
+    struct esp_google_sheet_host_timing_t hosts[ESP_GOOGLE_SHEET_CLIENT_ADAPTIVE_TIMEOUT_HOSTS];
+};
+
+struct esp_google_sheet_dns_entry_t
+{
+    char host[ESP_GOOGLE_SHEET_CLIENT_DNS_HOST_LENGTH];
+    // The resolved IPv4 address, 0 for the failed lookup.
+    uint32_t ip;
+    // The expiry in seconds of the epoch time when the clock was set (epoch is true) or of the uptime.
+    uint32_t expires;
+    bool epoch;
+};
+
+// Plain data only, it can be placed in the RTC memory to keep the entries across the deep sleep.
+typedef struct esp_google_sheet_dns_cache_t
+{
+    struct esp_google_sheet_dns_entry_t entries[ESP_GOOGLE_SHEET_CLIENT_DNS_CACHE_SIZE];
+} DNSCache;
+
+struct esp_google_sheet_dns_cfg_t
+{
+    // The TTL in seconds of the resolved address, 0 to disable the cache.
+    uint32_t ttl = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_DNS_TTL;
+    uint32_t negativeTtl = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_DNS_NEGATIVE_TTL;
+    // The user storage e.g. the RTC memory, the local storage is used when it was not set.
+    DNSCache *cache = nullptr;
+    DNSCache local = DNSCache();
+};
+
+struct esp_google_sheet_rate_limit_t
+{
+    struct esp_google_sheet_rate_limit_bucket_t read;
+    struct esp_google_sheet_rate_limit_bucket_t write;
+    // The longest time in ms that the request is allowed to wait for its turn before it was dropped.
+    unsigned long maxWait = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_MAX_THROTTLE_WAIT;
+    uint8_t maxRetry = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_MAX_RETRY;
+    unsigned long backoffBase = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_RETRY_BACKOFF_BASE;
+    unsigned long backoffMax = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_RETRY_BACKOFF_MAX;
+    // All requests are held until holdMs elapsed from holdMillis (from Retry-After or backoff).
+    unsigned long holdMillis = 0;
+    unsigned long holdMs = 0;
+    RateLimitStats stats;
+};
+
 struct esp_google_sheet_auth_cfg_t
 {
     uint32_t mb_ts = 0;
@@ -503,6 +814,13 @@ struct esp_google_sheet_auth_cfg_t
     TokenStatusCallback token_status_callback = NULL;
     gauth_spi_ethernet_module_t spi_ethernet_module;
     struct gauth_client_timeout_t timeout;
+    struct esp_google_sheet_rate_limit_t rate_limit;
+    struct esp_google_sheet_dns_cfg_t dns;
+    struct esp_google_sheet_adaptive_timeout_t adaptive;
+    // The latency record of the request that is being processed.
+    struct esp_google_sheet_request_timing_t timing;
+    // The metrics registry, allocated when it was enabled.
+    struct esp_google_sheet_metrics_t *metrics = nullptr;
 
     MB_String api_key;
     MB_String client_id;
@@ -523,6 +841,30 @@ typedef void (*ESP_GOOGLE_SHEET_CLIENT_NetworkStatusRequestCallback)(void);
 typedef void (*ESP_GOOGLE_SHEET_CLIENT_ResponseCallback)(const char *);
 
 static const unsigned char  esp_google_sheet_base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const unsigned char  esp_google_sheet_base64url_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// The decode table of base64 and base64url chars that was generated at compile time,
+// 0x80 for the chars that are not in the alphabet and ESP_GOOGLE_SHEET_BASE64_PAD for '='.
+#define ESP_GOOGLE_SHEET_BASE64_PAD 0x81
+#define ESP_GOOGLE_SHEET_BASE64_DEC(c) ((c) >= 'A' && (c) <= 'Z' ? (c) - 'A' : (c) >= 'a' && (c) <= 'z' ? (c) - 'a' + 26 \
+                                        : (c) >= '0' && (c) <= '9'                           ? (c) - '0' + 52         \
+                                        : (c) == '+' || (c) == '-'                           ? 62                     \
+                                        : (c) == '/' || (c) == '_'                           ? 63                     \
+                                        : (c) == '='                                         ? ESP_GOOGLE_SHEET_BASE64_PAD \
+                                                                                             : 0x80)
+#define ESP_GOOGLE_SHEET_BASE64_DEC4(c) ESP_GOOGLE_SHEET_BASE64_DEC(c), ESP_GOOGLE_SHEET_BASE64_DEC((c) + 1), \
+                                        ESP_GOOGLE_SHEET_BASE64_DEC((c) + 2), ESP_GOOGLE_SHEET_BASE64_DEC((c) + 3)
+#define ESP_GOOGLE_SHEET_BASE64_DEC16(c) ESP_GOOGLE_SHEET_BASE64_DEC4(c), ESP_GOOGLE_SHEET_BASE64_DEC4((c) + 4), \
+                                         ESP_GOOGLE_SHEET_BASE64_DEC4((c) + 8), ESP_GOOGLE_SHEET_BASE64_DEC4((c) + 12)
+#define ESP_GOOGLE_SHEET_BASE64_DEC64(c) ESP_GOOGLE_SHEET_BASE64_DEC16(c), ESP_GOOGLE_SHEET_BASE64_DEC16((c) + 16), \
+                                         ESP_GOOGLE_SHEET_BASE64_DEC16((c) + 32), ESP_GOOGLE_SHEET_BASE64_DEC16((c) + 48)
+
+static const uint8_t esp_google_sheet_base64_dec_table[256] = {
+    ESP_GOOGLE_SHEET_BASE64_DEC64(0), ESP_GOOGLE_SHEET_BASE64_DEC64(64),
+    ESP_GOOGLE_SHEET_BASE64_DEC64(128), ESP_GOOGLE_SHEET_BASE64_DEC64(192)};
+
+// The OAuth2 scope of the service account token
+#define ESP_GOOGLE_SHEET_CLIENT_JWT_SCOPE "https://www.googleapis.com/auth/drive.metadata https://www.googleapis.com/auth/drive.appdata https://www.googleapis.com/auth/spreadsheets https://www.googleapis.com/auth/drive https://www.googleapis.com/auth/drive.file"
 
 static const char gauth_pgm_str_1[] PROGMEM = "type";
 static const char gauth_pgm_str_2[] PROGMEM = "service_account";
@@ -542,22 +884,8 @@ static const char gauth_pgm_str_15[] PROGMEM = "error/message";
 static const char gauth_pgm_str_16[] PROGMEM = "id_token";
 static const char gauth_pgm_str_18[] PROGMEM = "refresh_token";
 static const char gauth_pgm_str_19[] PROGMEM = "expires_in";
-static const char gauth_pgm_str_20[] PROGMEM = "alg";
-static const char gauth_pgm_str_21[] PROGMEM = "RS256";
-static const char gauth_pgm_str_22[] PROGMEM = "typ";
-static const char gauth_pgm_str_23[] PROGMEM = "JWT";
-static const char gauth_pgm_str_24[] PROGMEM = "iss";
-static const char gauth_pgm_str_25[] PROGMEM = "sub";
-static const char gauth_pgm_str_26[] PROGMEM = "https://";
-static const char gauth_pgm_str_27[] PROGMEM = "oauth2";
 static const char gauth_pgm_str_28[] PROGMEM = "/";
 static const char gauth_pgm_str_29[] PROGMEM = "token";
-static const char gauth_pgm_str_30[] PROGMEM = "aud";
-static const char gauth_pgm_str_31[] PROGMEM = "iat";
-static const char gauth_pgm_str_32[] PROGMEM = "exp";
-static const char gauth_pgm_str_33[] PROGMEM = "scope";
-static const char gauth_pgm_str_34[] PROGMEM = "https://www.googleapis.com/auth/drive.metadata https://www.googleapis.com/auth/drive.appdata https://www.googleapis.com/auth/spreadsheets https://www.googleapis.com/auth/drive https://www.googleapis.com/auth/drive.file";
-static const char gauth_pgm_str_35[] PROGMEM = ".";
 static const char gauth_pgm_str_36[] PROGMEM = "www";
 static const char gauth_pgm_str_37[] PROGMEM = "client_secret";
 static const char gauth_pgm_str_38[] PROGMEM = "grant_type";
@@ -568,6 +896,17 @@ static const char gauth_pgm_str_42[] PROGMEM = "error";
 static const char gauth_pgm_str_43[] PROGMEM = "error_description";
 static const char gauth_pgm_str_44[] PROGMEM = "access_token";
 static const char gauth_pgm_str_45[] PROGMEM = "Bearer ";
+static const char gauth_pgm_str_46[] PROGMEM = "-----BEGIN";
+static const char gauth_pgm_str_47[] PROGMEM = "-----END";
+static const char gauth_pgm_str_48[] PROGMEM = "GSK1";
+// The JWT header {"alg":"RS256","typ":"JWT"} in base64url
+static const char gauth_pgm_str_49[] PROGMEM = "eyJhbGciOiJSUzI1NiIsInR5cCI6IkpXVCJ9";
+// The JWT claims, the service account email and the timestamps are written between them
+static const char gauth_pgm_str_50[] PROGMEM = "{\"iss\":\"";
+static const char gauth_pgm_str_51[] PROGMEM = "\",\"sub\":\"";
+static const char gauth_pgm_str_52[] PROGMEM = "\",\"aud\":\"https://oauth2.googleapis.com/token\",\"iat\":";
+static const char gauth_pgm_str_53[] PROGMEM = ",\"exp\":";
+static const char gauth_pgm_str_54[] PROGMEM = ",\"scope\":\"" ESP_GOOGLE_SHEET_CLIENT_JWT_SCOPE "\"}";
 
 static const char  esp_google_sheet_pgm_str_1[] PROGMEM = "\r\n";
 static const char  esp_google_sheet_pgm_str_2[] PROGMEM = ".";
@@ -618,5 +957,11 @@ static const char  esp_google_sheet_pgm_str_46[] PROGMEM = "error";
 static const char  esp_google_sheet_pgm_str_47[] PROGMEM = "code: ";
 static const char  esp_google_sheet_pgm_str_48[] PROGMEM = ", message: ";
 static const char  esp_google_sheet_pgm_str_49[] PROGMEM = "ready";
+static const char  esp_google_sheet_pgm_str_50[] PROGMEM = "fields";
+static const char  esp_google_sheet_pgm_str_51[] PROGMEM = "Retry-After: ";
+static const char  esp_google_sheet_pgm_str_52[] PROGMEM = "/gsheet_cache_";
+static const char  esp_google_sheet_pgm_str_53[] PROGMEM = "\nDate: ";
+static const char  esp_google_sheet_pgm_str_54[] PROGMEM = "%*[^,], %d %3s %d %d:%d:%d";
+static const char  esp_google_sheet_pgm_str_55[] PROGMEM = "JanFebMarAprMayJunJulAugSepOctNovDec";
 
 #endif
\ No newline at end of file
@@ -80,4 +80,5 @@
 #define ESP_GOOGLE_SHEET_CLIENT_ERROR_TOKEN_ERROR_UNNOTIFY /*          */ (ESP_GOOGLE_SHEET_CLIENT_ERROR_RANGE - 15)
 #define ESP_GOOGLE_SHEET_CLIENT_ERROR_MISSING_SERVICE_ACCOUNT_CREDENTIALS /*          */ (ESP_GOOGLE_SHEET_CLIENT_ERROR_RANGE - 16)
 #define ESP_GOOGLE_SHEET_CLIENT_ERROR_SERVICE_ACCOUNT_JSON_FILE_PARSING_ERROR /*          */ (ESP_GOOGLE_SHEET_CLIENT_ERROR_RANGE - 17)
+#define ESP_GOOGLE_SHEET_CLIENT_ERROR_RATE_LIMIT_EXCEEDED /*          */ (ESP_GOOGLE_SHEET_CLIENT_ERROR_RANGE - 18)
 #endif
\ No newline at end of file
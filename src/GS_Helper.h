@@ -20,6 +20,7 @@
 #endif
 
 #include "mbfs/MB_FS.h"
+#include "GS_Trace.h"
 
 class GS_TCP_Client;
 
@@ -78,6 +79,39 @@ namespace TimeHelper
         return ts;
     }
 
+    /* Get the UTC timestamp from date and time, unlike mktime, the local time zone is not applied */
+    inline uint32_t getUTCTimestamp(int year, int mon, int date, int hour, int mins, int sec)
+    {
+        // Days from civil date, the year begins in March to place the leap day at the end of year
+        year -= mon <= 2;
+        int era = (year >= 0 ? year : year - 399) / 400;
+        unsigned int yoe = year - era * 400;
+        unsigned int doy = (153 * (mon + (mon > 2 ? -3 : 9)) + 2) / 5 + date - 1;
+        unsigned int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        long days = (long)era * 146097 + (long)doe - 719468;
+        return days * 86400 + hour * 3600 + mins * 60 + sec;
+    }
+
+    /* Parse the HTTP Date header value e.g. "Sun, 06 Nov 1994 08:49:37 GMT", return 0 when it is not valid */
+    inline uint32_t parseHttpDate(const char *s)
+    {
+        int date = 0, year = 0, hour = 0, mins = 0, sec = 0;
+        char month[4] = {0};
+
+        if (!s || sscanf(s, pgm2Str(esp_google_sheet_pgm_str_54 /* "%*[^,], %d %3s %d %d:%d:%d" */),
+                         &date, month, &year, &hour, &mins, &sec) != 6)
+            return 0;
+
+        MB_String months = esp_google_sheet_pgm_str_55; // "JanFebMarAprMayJunJulAugSepOctNovDec"
+        size_t pos = months.find(month);
+
+        if (strlen(month) != 3 || pos == MB_String::npos || pos % 3 > 0 || year < 1970 ||
+            date < 1 || date > 31 || hour > 23 || mins > 59 || sec > 60)
+            return 0;
+
+        return getUTCTimestamp(year, pos / 3 + 1, date, hour, mins, sec);
+    }
+
     inline uint32_t getTime(uint32_t *mb_ts, uint32_t *mb_ts_offset)
     {
 #if defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO)
@@ -169,12 +203,18 @@ namespace TimeHelper
             {
 
 #if defined(ESP_GOOGLE_SHEET_CLIENT_ENABLE_NTP_TIME)
+                // When the time can be taken from the HTTP Date header, NTP is started once and runs in background
+                if (!config->internal.http_date_time || !config->internal.ntp_started)
+                {
 #if (defined(ESP32) || defined(ESP8266))
-                configTime(gmtOffset * 3600, 0 * 60, "pool.ntp.org", "time.nist.gov");
+                    configTime(gmtOffset * 3600, 0 * 60, "pool.ntp.org", "time.nist.gov");
 #elif defined(ARDUINO_RASPBERRY_PI_PICO_W)
-                NTP.begin("pool.ntp.org", "time.nist.gov");
-                NTP.waitSet();
+                    NTP.begin("pool.ntp.org", "time.nist.gov");
+                    if (!config->internal.http_date_time)
+                        NTP.waitSet();
 #endif
+                    config->internal.ntp_started = true;
+                }
 #endif
                 unsigned long ms = millis();
                 do
@@ -186,6 +226,8 @@ namespace TimeHelper
 #else
                     break;
 #endif
+                    if (config->internal.http_date_time)
+                        break;
                     delay(100);
                 } while (millis() - ms < 10000 && sys_ts < ESP_GOOGLE_SHEET_CLIENT_DEFAULT_TS);
             }
@@ -482,12 +524,22 @@ namespace URLHelper
 
     inline void hexchar(char c, char &hex1, char &hex2)
     {
-        hex1 = c / 16;
-        hex2 = c % 16;
+        hex1 = (uint8_t)c / 16;
+        hex2 = (uint8_t)c % 16;
         hex1 += hex1 < 10 ? '0' : 'A' - 10;
         hex2 += hex2 < 10 ? '0' : 'A' - 10;
     }
 
+    /* The character that is not percent encoded */
+    inline bool unreserved(char c)
+    {
+        return (c >= '0' && c <= '9') ||
+               (c >= 'A' && c <= 'Z') ||
+               (c >= 'a' && c <= 'z') ||
+               c == '-' || c == '_' || c == '.' || c == '!' || c == '~' ||
+               c == '*' || c == '\'' || c == '(' || c == ')';
+    }
+
     inline MB_String encode(const MB_String &s)
     {
         MB_String ret;
@@ -495,11 +547,7 @@ namespace URLHelper
         for (size_t i = 0, l = s.size(); i < l; i++)
         {
             char c = s[i];
-            if ((c >= '0' && c <= '9') ||
-                (c >= 'A' && c <= 'Z') ||
-                (c >= 'a' && c <= 'z') ||
-                c == '-' || c == '_' || c == '.' || c == '!' || c == '~' ||
-                c == '*' || c == '\'' || c == '(' || c == ')')
+            if (unreserved(c))
             {
                 ret += c;
             }
@@ -518,6 +566,725 @@ namespace URLHelper
 
 };
 
+namespace RangeHelper
+{
+
+    /* Parse the A1 notation cell e.g. AB12, the column is up to XFD */
+    inline bool parseCell(const char *s, size_t len, uint32_t &col, uint32_t &row)
+    {
+        size_t i = 0;
+        col = 0;
+        row = 0;
+
+        while (i < len && i < 3 && isalpha(s[i]))
+        {
+            col = col * 26 + (toupper(s[i]) - 'A' + 1);
+            i++;
+        }
+
+        if (i == 0 || i == len || col > ESP_GOOGLE_SHEET_CLIENT_A1_MAX_COLUMN)
+            return false;
+
+        while (i < len && isdigit(s[i]) && row <= ESP_GOOGLE_SHEET_CLIENT_A1_MAX_ROW)
+        {
+            row = row * 10 + (s[i] - '0');
+            i++;
+        }
+
+        return i == len && row > 0 && row <= ESP_GOOGLE_SHEET_CLIENT_A1_MAX_ROW;
+    }
+
+    /* Set the range to the whole sheet */
+    inline void setWhole(esp_google_sheet_a1_range_t &range, const MB_String &sheet)
+    {
+        range.sheet = sheet;
+        range.col1 = 1;
+        range.row1 = 1;
+        range.col2 = ESP_GOOGLE_SHEET_CLIENT_A1_MAX_COLUMN;
+        range.row2 = ESP_GOOGLE_SHEET_CLIENT_A1_MAX_ROW;
+        range.whole = true;
+    }
+
+    /* Parse the bounded A1 notation range e.g. Sheet1!A1:C10, 'My Sheet'!B2 and A1:B5.
+     * The name without "!" and ":" e.g. Sheet1 is the whole sheet. */
+    inline bool parse(const MB_String &src, esp_google_sheet_a1_range_t &range)
+    {
+        size_t pos = src.find_last_of("!");
+        MB_String cells;
+
+        range.whole = false;
+
+        if (pos != MB_String::npos)
+        {
+            range.sheet = src.substr(0, pos);
+            cells = src.substr(pos + 1, src.length() - pos - 1);
+        }
+        else if (src.find(":") == MB_String::npos)
+        {
+            if (src.length() == 0)
+                return false;
+            setWhole(range, src);
+            return true;
+        }
+        else
+        {
+            range.sheet.clear();
+            cells = src;
+        }
+
+        pos = cells.find(":");
+
+        if (pos == MB_String::npos)
+        {
+            if (!parseCell(cells.c_str(), cells.length(), range.col1, range.row1))
+                return false;
+            range.col2 = range.col1;
+            range.row2 = range.row1;
+        }
+        else if (!parseCell(cells.c_str(), pos, range.col1, range.row1) ||
+                 !parseCell(cells.c_str() + pos + 1, cells.length() - pos - 1, range.col2, range.row2))
+            return false;
+
+        if (range.col1 > range.col2)
+        {
+            uint32_t t = range.col1;
+            range.col1 = range.col2;
+            range.col2 = t;
+        }
+
+        if (range.row1 > range.row2)
+        {
+            uint32_t t = range.row1;
+            range.row1 = range.row2;
+            range.row2 = t;
+        }
+
+        return true;
+    }
+
+    /* Get the range that covers src, the whole sheet when src is not the bounded range e.g. Sheet1!A:A,
+     * the range without sheet name can be any sheet */
+    inline void cover(const MB_String &src, esp_google_sheet_a1_range_t &range)
+    {
+        if (parse(src, range))
+            return;
+
+        size_t pos = src.find_last_of("!");
+        setWhole(range, pos != MB_String::npos ? src.substr(0, pos) : MB_String());
+    }
+
+    inline void appendCell(MB_String &out, uint32_t col, uint32_t row)
+    {
+        char buf[8];
+        int i = sizeof(buf) - 1;
+        buf[i] = 0;
+        while (col > 0 && i > 0)
+        {
+            col--;
+            buf[--i] = 'A' + (col % 26);
+            col /= 26;
+        }
+        out += &buf[i];
+        out += row;
+    }
+
+    /* Get the A1 notation string of range */
+    inline void toString(const esp_google_sheet_a1_range_t &range, MB_String &out)
+    {
+        out.clear();
+
+        if (range.whole)
+        {
+            out = range.sheet;
+            return;
+        }
+
+        if (range.sheet.length() > 0)
+        {
+            out += range.sheet;
+            out += '!';
+        }
+
+        appendCell(out, range.col1, range.row1);
+
+        if (range.col2 != range.col1 || range.row2 != range.row1)
+        {
+            out += ':';
+            appendCell(out, range.col2, range.row2);
+        }
+    }
+
+    // Get the sheet name without the quotes, the quote in quoted name was doubled e.g. 'John''s'
+    inline void unquote(const MB_String &sheet, const char *&s, size_t &len, bool &quoted)
+    {
+        s = sheet.c_str();
+        len = sheet.length();
+        quoted = len >= 2 && s[0] == '\'' && s[len - 1] == '\'';
+        if (quoted)
+        {
+            s++;
+            len -= 2;
+        }
+    }
+
+    /* Check whether the sheet names are the same sheet e.g. 'Sheet1' and Sheet1 */
+    inline bool sameSheet(const MB_String &a, const MB_String &b)
+    {
+        const char *p, *q;
+        size_t m, n, i = 0, j = 0;
+        bool qa, qb;
+        unquote(a, p, m, qa);
+        unquote(b, q, n, qb);
+
+        while (i < m && j < n)
+        {
+            if (p[i] != q[j])
+                return false;
+            if (qa && p[i] == '\'' && i + 1 < m && p[i + 1] == '\'')
+                i++;
+            if (qb && q[j] == '\'' && j + 1 < n && q[j + 1] == '\'')
+                j++;
+            i++;
+            j++;
+        }
+
+        return i == m && j == n;
+    }
+
+    inline bool contains(const esp_google_sheet_a1_range_t &a, const esp_google_sheet_a1_range_t &b)
+    {
+        if (a.whole || b.whole)
+            return a.whole && b.whole && sameSheet(a.sheet, b.sheet);
+
+        return sameSheet(a.sheet, b.sheet) && b.col1 >= a.col1 && b.col2 <= a.col2 && b.row1 >= a.row1 && b.row2 <= a.row2;
+    }
+
+    /* Check whether the range can be in any sheet, the range without sheet name,
+     * or the bare name that is also a cell e.g. A1 which may not be the sheet name */
+    inline bool anySheet(const esp_google_sheet_a1_range_t &range)
+    {
+        uint32_t col, row;
+        return range.sheet.length() == 0 || (range.whole && parseCell(range.sheet.c_str(), range.sheet.length(), col, row));
+    }
+
+    /* Check whether two ranges share any cell */
+    inline bool intersects(const esp_google_sheet_a1_range_t &a, const esp_google_sheet_a1_range_t &b)
+    {
+        if (!anySheet(a) && !anySheet(b) && !sameSheet(a.sheet, b.sheet))
+            return false;
+
+        return a.col1 <= b.col2 && b.col1 <= a.col2 && a.row1 <= b.row2 && b.row1 <= a.row2;
+    }
+
+    /* Merge range b into range a when their union is exactly a rectangle */
+    inline bool merge(esp_google_sheet_a1_range_t &a, const esp_google_sheet_a1_range_t &b)
+    {
+        if (a.whole || b.whole || !sameSheet(a.sheet, b.sheet))
+            return false;
+
+        if (contains(a, b))
+            return true;
+
+        if (contains(b, a))
+        {
+            a = b;
+            return true;
+        }
+
+        // Same rows, adjacent or overlapping columns
+        if (a.row1 == b.row1 && a.row2 == b.row2 && b.col1 <= a.col2 + 1 && a.col1 <= b.col2 + 1)
+        {
+            a.col1 = b.col1 < a.col1 ? b.col1 : a.col1;
+            a.col2 = b.col2 > a.col2 ? b.col2 : a.col2;
+            return true;
+        }
+
+        // Same columns, adjacent or overlapping rows
+        if (a.col1 == b.col1 && a.col2 == b.col2 && b.row1 <= a.row2 + 1 && a.row1 <= b.row2 + 1)
+        {
+            a.row1 = b.row1 < a.row1 ? b.row1 : a.row1;
+            a.row2 = b.row2 > a.row2 ? b.row2 : a.row2;
+            return true;
+        }
+
+        return false;
+    }
+
+    /* Plan the minimal set of ranges that covers the requested ranges.
+     * Returns false when any range could not be parsed or nothing was merged.
+     * The owner is the index of planned range that contains each requested range. */
+    inline bool plan(const MB_VECTOR<MB_String> &ranges, MB_VECTOR<esp_google_sheet_a1_range_t> &requested,
+                     MB_VECTOR<esp_google_sheet_a1_range_t> &planned, MB_VECTOR<size_t> &owner)
+    {
+        requested.clear();
+        planned.clear();
+        owner.clear();
+
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            esp_google_sheet_a1_range_t range;
+            if (!parse(ranges[i], range))
+                return false;
+            requested.push_back(range);
+        }
+
+        planned = requested;
+
+        // Merge until no more pair can be merged as the merged range may be mergeable with the others
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (size_t i = 0; i < planned.size(); i++)
+            {
+                for (size_t j = i + 1; j < planned.size(); j++)
+                {
+                    if (merge(planned[i], planned[j]))
+                    {
+                        planned.erase(planned.begin() + j);
+                        merged = true;
+                        j--;
+                    }
+                }
+            }
+        }
+
+        if (planned.size() == requested.size())
+            return false;
+
+        for (size_t i = 0; i < requested.size(); i++)
+        {
+            for (size_t j = 0; j < planned.size(); j++)
+            {
+                if (contains(planned[j], requested[i]))
+                {
+                    owner.push_back(j);
+                    break;
+                }
+            }
+        }
+
+        return true;
+    }
+
+};
+
+namespace MetricsHelper
+{
+    // Check the path (length len) ends with suffix
+    inline bool endsWith(const char *path, size_t len, PGM_P suffix)
+    {
+        size_t slen = strlen_P(suffix);
+        return len >= slen && strncmp_P(path + len - slen, suffix, slen) == 0;
+    }
+
+    // Get the endpoint from the request line e.g. "POST /v4/spreadsheets/{id}/values/{range}:append?..."
+    inline esp_google_sheet_metrics_endpoint endpoint(const char *req)
+    {
+        const char *path = strchr(req, ' ');
+        if (!path)
+            return esp_google_sheet_metrics_endpoint_other;
+
+        path++;
+        size_t len = strcspn(path, "? ");
+        bool get = req[0] == 'G';
+
+        if (strncmp_P(path, PSTR("/drive/"), 7) == 0)
+            return esp_google_sheet_metrics_endpoint_drive;
+
+        // The ByDataFilter variants are counted to their base endpoints
+        if (endsWith(path, len, PSTR("ByDataFilter")))
+            len -= 12;
+
+        if (endsWith(path, len, PSTR("/values:batchGet")))
+            return esp_google_sheet_metrics_endpoint_values_batch_get;
+        if (endsWith(path, len, PSTR("/values:batchUpdate")))
+            return esp_google_sheet_metrics_endpoint_values_batch_update;
+        if (endsWith(path, len, PSTR("/values:batchClear")))
+            return esp_google_sheet_metrics_endpoint_values_batch_clear;
+        if (endsWith(path, len, PSTR(":append")))
+            return esp_google_sheet_metrics_endpoint_values_append;
+        if (endsWith(path, len, PSTR(":clear")))
+            return esp_google_sheet_metrics_endpoint_values_clear;
+        if (endsWith(path, len, PSTR(":copyTo")))
+            return esp_google_sheet_metrics_endpoint_sheet_copy;
+        if (endsWith(path, len, PSTR(":batchUpdate")))
+            return esp_google_sheet_metrics_endpoint_spreadsheet_batch_update;
+        if (endsWith(path, len, PSTR(":get")))
+            return esp_google_sheet_metrics_endpoint_spreadsheet_get;
+
+        const char *p = strstr(path, "/developerMetadata");
+        if (p && p < path + len)
+            return esp_google_sheet_metrics_endpoint_metadata;
+
+        p = strstr(path, "/values/");
+        if (p && p < path + len)
+            return get ? esp_google_sheet_metrics_endpoint_values_get : esp_google_sheet_metrics_endpoint_values_update;
+
+        return get ? esp_google_sheet_metrics_endpoint_spreadsheet_get : esp_google_sheet_metrics_endpoint_spreadsheet_create;
+    }
+
+    inline const __FlashStringHelper *endpointName(int ep)
+    {
+        switch (ep)
+        {
+        case esp_google_sheet_metrics_endpoint_values_get:
+            return FPSTR("values_get");
+        case esp_google_sheet_metrics_endpoint_values_batch_get:
+            return FPSTR("values_batch_get");
+        case esp_google_sheet_metrics_endpoint_values_update:
+            return FPSTR("values_update");
+        case esp_google_sheet_metrics_endpoint_values_append:
+            return FPSTR("values_append");
+        case esp_google_sheet_metrics_endpoint_values_batch_update:
+            return FPSTR("values_batch_update");
+        case esp_google_sheet_metrics_endpoint_values_clear:
+            return FPSTR("values_clear");
+        case esp_google_sheet_metrics_endpoint_values_batch_clear:
+            return FPSTR("values_batch_clear");
+        case esp_google_sheet_metrics_endpoint_spreadsheet_get:
+            return FPSTR("spreadsheet_get");
+        case esp_google_sheet_metrics_endpoint_spreadsheet_create:
+            return FPSTR("spreadsheet_create");
+        case esp_google_sheet_metrics_endpoint_spreadsheet_batch_update:
+            return FPSTR("spreadsheet_batch_update");
+        case esp_google_sheet_metrics_endpoint_sheet_copy:
+            return FPSTR("sheet_copy");
+        case esp_google_sheet_metrics_endpoint_metadata:
+            return FPSTR("metadata");
+        case esp_google_sheet_metrics_endpoint_drive:
+            return FPSTR("drive");
+        default:
+            return FPSTR("other");
+        }
+    }
+
+    inline const __FlashStringHelper *codeName(int code)
+    {
+        switch (code)
+        {
+        case esp_google_sheet_metrics_code_2xx:
+            return FPSTR("2xx");
+        case esp_google_sheet_metrics_code_3xx:
+            return FPSTR("3xx");
+        case esp_google_sheet_metrics_code_4xx:
+            return FPSTR("4xx");
+        case esp_google_sheet_metrics_code_429:
+            return FPSTR("429");
+        case esp_google_sheet_metrics_code_5xx:
+            return FPSTR("5xx");
+        default:
+            return FPSTR("error");
+        }
+    }
+
+    inline esp_google_sheet_metrics_code codeClass(int httpCode)
+    {
+        if (httpCode == ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_TOO_MANY_REQUESTS)
+            return esp_google_sheet_metrics_code_429;
+        if (httpCode >= 200 && httpCode < 300)
+            return esp_google_sheet_metrics_code_2xx;
+        if (httpCode >= 300 && httpCode < 400)
+            return esp_google_sheet_metrics_code_3xx;
+        if (httpCode >= 400 && httpCode < 500)
+            return esp_google_sheet_metrics_code_4xx;
+        if (httpCode >= 500 && httpCode < 600)
+            return esp_google_sheet_metrics_code_5xx;
+        return esp_google_sheet_metrics_code_error;
+    }
+
+    inline uint32_t bucketBound(int i)
+    {
+        return (uint32_t)ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_MIN_MS << i;
+    }
+
+    inline void observe(esp_google_sheet_metrics_histogram_t &h, unsigned long ms)
+    {
+        for (int i = 0; i < ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_BUCKETS; i++)
+        {
+            if (ms <= bucketBound(i))
+            {
+                h.buckets[i]++;
+                break;
+            }
+        }
+        h.count++;
+        h.sumMs += ms;
+    }
+
+    // Print the milliseconds as seconds with 3 decimal places
+    inline void printSeconds(Print &out, uint32_t ms)
+    {
+        out.print(ms / 1000);
+        out.print('.');
+        uint32_t frac = ms % 1000;
+        if (frac < 100)
+            out.print('0');
+        if (frac < 10)
+            out.print('0');
+        out.print(frac);
+    }
+
+    inline void printLabel(Print &out, const __FlashStringHelper *endpoint, bool more)
+    {
+        if (!endpoint)
+        {
+            if (more)
+                out.print('{');
+            return;
+        }
+
+        out.print(FPSTR("{endpoint=\""));
+        out.print(endpoint);
+        out.print('"');
+        if (more)
+            out.print(',');
+        else
+            out.print('}');
+    }
+
+    inline void printPrometheusHistogram(Print &out, const __FlashStringHelper *name, const __FlashStringHelper *endpoint, esp_google_sheet_metrics_histogram_t &h)
+    {
+        uint32_t cumulative = 0;
+        for (int i = 0; i <= ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_BUCKETS; i++)
+        {
+            out.print(name);
+            out.print(FPSTR("_bucket"));
+            printLabel(out, endpoint, true);
+            out.print(FPSTR("le=\""));
+            if (i < ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_BUCKETS)
+            {
+                cumulative += h.buckets[i];
+                printSeconds(out, bucketBound(i));
+            }
+            else
+            {
+                cumulative = h.count;
+                out.print(FPSTR("+Inf"));
+            }
+            out.print(FPSTR("\"} "));
+            out.println(cumulative);
+        }
+
+        out.print(name);
+        out.print(FPSTR("_sum"));
+        printLabel(out, endpoint, false);
+        out.print(' ');
+        printSeconds(out, h.sumMs);
+        out.println();
+
+        out.print(name);
+        out.print(FPSTR("_count"));
+        printLabel(out, endpoint, false);
+        out.print(' ');
+        out.println(h.count);
+    }
+
+    inline void printCounter(Print &out, const __FlashStringHelper *name, uint32_t value)
+    {
+        out.print(FPSTR("# TYPE "));
+        out.print(name);
+        out.println(FPSTR(" counter"));
+        out.print(name);
+        out.print(' ');
+        out.println(value);
+    }
+
+    inline void printJsonHistogram(Print &out, esp_google_sheet_metrics_histogram_t &h)
+    {
+        out.print(FPSTR("{\"count\":"));
+        out.print(h.count);
+        out.print(FPSTR(",\"sum_ms\":"));
+        out.print(h.sumMs);
+        out.print(FPSTR(",\"buckets\":["));
+        for (int i = 0; i < ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_BUCKETS; i++)
+        {
+            if (i > 0)
+                out.print(',');
+            out.print(h.buckets[i]);
+        }
+        out.print(FPSTR("]}"));
+    }
+
+    inline void printPrometheus(Print &out, esp_google_sheet_metrics_t &m)
+    {
+        out.println(FPSTR("# TYPE gsheet_requests_total counter"));
+        for (int i = 0; i < esp_google_sheet_metrics_endpoint_max; i++)
+        {
+            for (int j = 0; j < esp_google_sheet_metrics_code_max; j++)
+            {
+                if (m.endpoints[i].codes[j] == 0)
+                    continue;
+
+                out.print(FPSTR("gsheet_requests_total"));
+                printLabel(out, endpointName(i), true);
+                out.print(FPSTR("code=\""));
+                out.print(codeName(j));
+                out.print(FPSTR("\"} "));
+                out.println(m.endpoints[i].codes[j]);
+            }
+        }
+
+        out.println(FPSTR("# TYPE gsheet_request_duration_seconds histogram"));
+        for (int i = 0; i < esp_google_sheet_metrics_endpoint_max; i++)
+        {
+            if (m.endpoints[i].latency.count > 0)
+                printPrometheusHistogram(out, FPSTR("gsheet_request_duration_seconds"), endpointName(i), m.endpoints[i].latency);
+        }
+
+        printCounter(out, FPSTR("gsheet_retries_total"), m.retries);
+        printCounter(out, FPSTR("gsheet_reconnects_total"), m.reconnects);
+        printCounter(out, FPSTR("gsheet_token_refreshes_total"), m.tokenRefreshes);
+        printCounter(out, FPSTR("gsheet_token_errors_total"), m.tokenErrors);
+
+        out.println(FPSTR("# TYPE gsheet_jwt_sign_duration_seconds histogram"));
+        printPrometheusHistogram(out, FPSTR("gsheet_jwt_sign_duration_seconds"), nullptr, m.jwtSign);
+    }
+
+    inline void printJson(Print &out, esp_google_sheet_metrics_t &m)
+    {
+        out.print(FPSTR("{\"buckets_ms\":["));
+        for (int i = 0; i < ESP_GOOGLE_SHEET_CLIENT_METRICS_HISTOGRAM_BUCKETS; i++)
+        {
+            if (i > 0)
+                out.print(',');
+            out.print(bucketBound(i));
+        }
+
+        out.print(FPSTR("],\"requests\":{"));
+        bool first = true;
+        for (int i = 0; i < esp_google_sheet_metrics_endpoint_max; i++)
+        {
+            if (m.endpoints[i].latency.count == 0)
+                continue;
+
+            if (!first)
+                out.print(',');
+            first = false;
+
+            out.print('"');
+            out.print(endpointName(i));
+            out.print(FPSTR("\":{\"codes\":{"));
+            bool firstCode = true;
+            for (int j = 0; j < esp_google_sheet_metrics_code_max; j++)
+            {
+                if (m.endpoints[i].codes[j] == 0)
+                    continue;
+                if (!firstCode)
+                    out.print(',');
+                firstCode = false;
+                out.print('"');
+                out.print(codeName(j));
+                out.print(FPSTR("\":"));
+                out.print(m.endpoints[i].codes[j]);
+            }
+            out.print(FPSTR("},\"latency\":"));
+            printJsonHistogram(out, m.endpoints[i].latency);
+            out.print('}');
+        }
+
+        out.print(FPSTR("},\"retries\":"));
+        out.print(m.retries);
+        out.print(FPSTR(",\"reconnects\":"));
+        out.print(m.reconnects);
+        out.print(FPSTR(",\"token_refreshes\":"));
+        out.print(m.tokenRefreshes);
+        out.print(FPSTR(",\"token_errors\":"));
+        out.print(m.tokenErrors);
+        out.print(FPSTR(",\"jwt_sign\":"));
+        printJsonHistogram(out, m.jwtSign);
+        out.println('}');
+    }
+};
+
+namespace TimeoutHelper
+{
+    // Update the estimate with the new sample in ms (RFC 6298)
+    inline void update(esp_google_sheet_rtt_t &rtt, uint32_t sample)
+    {
+        if (rtt.srtt == 0)
+        {
+            rtt.srtt = sample > 0 ? sample : 1;
+            rtt.rttvar = sample / 2;
+            return;
+        }
+
+        uint32_t delta = rtt.srtt > sample ? rtt.srtt - sample : sample - rtt.srtt;
+        rtt.rttvar = (3 * rtt.rttvar + delta) / 4;
+        rtt.srtt = (7 * rtt.srtt + sample) / 8;
+        if (rtt.srtt == 0)
+            rtt.srtt = 1;
+    }
+
+    // Double the timeout after it was timed out, the next sample brings it back
+    inline void backoff(esp_google_sheet_rtt_t &rtt)
+    {
+        if (rtt.srtt > 0)
+            rtt.rttvar = 2 * rtt.rttvar + rtt.srtt / 4;
+    }
+
+    inline unsigned long clamp(const esp_google_sheet_adaptive_timeout_t &cfg, unsigned long ms)
+    {
+        if (ms < cfg.floor)
+            return cfg.floor;
+        return ms > cfg.ceiling ? cfg.ceiling : ms;
+    }
+
+    // The timeout in ms, or the fixed timeout when there is no sample
+    inline unsigned long timeout(const esp_google_sheet_adaptive_timeout_t &cfg, const esp_google_sheet_rtt_t &rtt, unsigned long fixed)
+    {
+        return clamp(cfg, rtt.srtt > 0 ? rtt.srtt + 4 * rtt.rttvar : fixed);
+    }
+
+    // The wait between the response data, including the time to receive the chunk at the estimated throughput
+    inline unsigned long chunkTimeout(const esp_google_sheet_adaptive_timeout_t &cfg, const esp_google_sheet_host_timing_t &host, unsigned long fixed, size_t chunkSize)
+    {
+        if (host.gap.srtt == 0)
+            return clamp(cfg, fixed);
+
+        unsigned long ms = host.gap.srtt + 4 * host.gap.rttvar;
+        if (host.throughput > 0)
+            ms += (unsigned long)((uint64_t)chunkSize * 1000 / host.throughput);
+        return clamp(cfg, ms);
+    }
+
+    inline void updateThroughput(esp_google_sheet_host_timing_t &host, size_t bytes, unsigned long ms)
+    {
+        if (bytes < ESP_GOOGLE_SHEET_CLIENT_MIN_THROUGHPUT_SAMPLE_SIZE)
+            return;
+
+        uint32_t sample = (uint32_t)((uint64_t)bytes * 1000 / (ms > 0 ? ms : 1));
+        host.throughput = host.throughput == 0 ? sample : (uint32_t)((7 * (uint64_t)host.throughput + sample) / 8);
+    }
+
+    // Get the estimates of the host, the last slot is reused when all slots were taken by the other hosts
+    inline esp_google_sheet_host_timing_t *host(esp_google_sheet_adaptive_timeout_t &cfg, const char *name)
+    {
+        if (!cfg.enabled || strlen(name) >= ESP_GOOGLE_SHEET_CLIENT_DNS_HOST_LENGTH)
+            return nullptr;
+
+        for (size_t i = 0; i < ESP_GOOGLE_SHEET_CLIENT_ADAPTIVE_TIMEOUT_HOSTS; i++)
+        {
+            if (strcmp(cfg.hosts[i].host, name) == 0)
+                return &cfg.hosts[i];
+        }
+
+        for (size_t i = 0; i < ESP_GOOGLE_SHEET_CLIENT_ADAPTIVE_TIMEOUT_HOSTS; i++)
+        {
+            if (cfg.hosts[i].host[0] == 0)
+            {
+                strcpy(cfg.hosts[i].host, name);
+                return &cfg.hosts[i];
+            }
+        }
+
+        esp_google_sheet_host_timing_t *slot = &cfg.hosts[ESP_GOOGLE_SHEET_CLIENT_ADAPTIVE_TIMEOUT_HOSTS - 1];
+        *slot = esp_google_sheet_host_timing_t();
+        strcpy(slot->host, name);
+        return slot;
+    }
+};
+
 namespace JsonHelper
 {
 
@@ -757,26 +1524,126 @@ namespace Base64Helper
         return (3 * (len / 4)) - pad;
     }
 
-    inline unsigned char *creatBase64EncBuffer(MB_FS *mbfs, bool isURL)
+    /* Encode the 3 bytes blocks into the 4 chars blocks, return the number of chars written */
+    inline size_t encodeBlocks(const unsigned char *table, const uint8_t *in, size_t blocks, char *out)
     {
-        unsigned char *base64EncBuf = MemoryHelper::createBuffer<unsigned char *>(mbfs, 65);
-        strcpy_P((char *)base64EncBuf, (char *)esp_google_sheet_base64_table);
-        if (isURL)
+        for (size_t i = 0; i < blocks; i++, in += 3, out += 4)
         {
-            base64EncBuf[62] = '-';
-            base64EncBuf[63] = '_';
+            uint32_t v = (uint32_t)in[0] << 16 | (uint32_t)in[1] << 8 | in[2];
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            out[0] = table[v >> 18];
+            out[1] = table[(v >> 12) & 0x3f];
+            out[2] = table[(v >> 6) & 0x3f];
+            out[3] = table[v & 0x3f];
+#else
+            // One 32-bit store for the 4 chars
+            uint32_t w = (uint32_t)table[v >> 18] | (uint32_t)table[(v >> 12) & 0x3f] << 8 |
+                         (uint32_t)table[(v >> 6) & 0x3f] << 16 | (uint32_t)table[v & 0x3f] << 24;
+            memcpy(out, &w, 4);
+#endif
         }
-        return base64EncBuf;
+        return blocks * 4;
     }
 
-    inline unsigned char *creatBase64DecBuffer(MB_FS *mbfs)
+    /* Encode the last 1 or 2 bytes, return the number of chars written */
+    inline size_t encodeTail(const unsigned char *table, const uint8_t *in, size_t len, char *out, bool pad)
     {
-        unsigned char *base64DecBuf = MemoryHelper::createBuffer<unsigned char *>(mbfs, 256, false);
-        memset(base64DecBuf, 0x80, 256);
-        for (size_t i = 0; i < sizeof(esp_google_sheet_base64_table) - 1; i++)
-            base64DecBuf[esp_google_sheet_base64_table[i]] = (unsigned char)i;
-        base64DecBuf['='] = 0;
-        return base64DecBuf;
+        if (len == 0 || len > 2)
+            return 0;
+
+        uint32_t v = (uint32_t)in[0] << 16 | (len == 2 ? (uint32_t)in[1] << 8 : 0);
+        size_t n = 0;
+        out[n++] = table[v >> 18];
+        out[n++] = table[(v >> 12) & 0x3f];
+        if (len == 2)
+            out[n++] = table[(v >> 6) & 0x3f];
+        while (pad && n < 4)
+            out[n++] = '=';
+        return n;
+    }
+
+    /* The streaming decoder state, the sextets of the incomplete block are kept between the chunks */
+    struct DecodeState
+    {
+        uint32_t acc = 0;
+        uint8_t count = 0;
+        // The padding was found
+        bool end = false;
+    };
+
+    /* Decode the base64 or base64url chars, the chars that are not in the alphabet e.g. new line are skipped.
+       The out should have room for len * 3 / 4 + 3 bytes, return the number of bytes written */
+    inline size_t decodeChunk(const char *src, size_t len, uint8_t *out, DecodeState &st)
+    {
+        const uint8_t *s = (const uint8_t *)src, *end = s + len;
+        uint8_t *o = out;
+
+        while (s < end && !st.end)
+        {
+            // The complete 4 chars blocks are decoded at once
+            if (st.count == 0)
+            {
+                while (end - s >= 4)
+                {
+                    uint32_t d0 = esp_google_sheet_base64_dec_table[s[0]], d1 = esp_google_sheet_base64_dec_table[s[1]],
+                             d2 = esp_google_sheet_base64_dec_table[s[2]], d3 = esp_google_sheet_base64_dec_table[s[3]];
+
+                    if ((d0 | d1 | d2 | d3) & 0x80)
+                        break;
+
+                    uint32_t v = d0 << 18 | d1 << 12 | d2 << 6 | d3;
+                    o[0] = v >> 16;
+                    o[1] = v >> 8;
+                    o[2] = v;
+                    o += 3;
+                    s += 4;
+                }
+
+                if (s == end)
+                    break;
+            }
+
+            uint8_t d = esp_google_sheet_base64_dec_table[*s++];
+
+            if (d == ESP_GOOGLE_SHEET_BASE64_PAD)
+                st.end = true;
+            else if (d < 0x40)
+            {
+                st.acc = st.acc << 6 | d;
+                if (++st.count == 4)
+                {
+                    o[0] = st.acc >> 16;
+                    o[1] = st.acc >> 8;
+                    o[2] = st.acc;
+                    o += 3;
+                    st.acc = 0;
+                    st.count = 0;
+                }
+            }
+        }
+
+        return o - out;
+    }
+
+    /* Decode the incomplete block at the end of data, return the number of bytes written or -1 for invalid length */
+    inline int decodeEnd(uint8_t *out, DecodeState &st)
+    {
+        int n = 0;
+        if (st.count == 1)
+            n = -1;
+        else if (st.count == 2)
+        {
+            out[0] = st.acc >> 4;
+            n = 1;
+        }
+        else if (st.count == 3)
+        {
+            out[0] = st.acc >> 10;
+            out[1] = st.acc >> 2;
+            n = 2;
+        }
+        st = DecodeState();
+        return n;
     }
 
     template <typename T = uint8_t>
@@ -793,161 +1660,112 @@ namespace Base64Helper
         return false;
     }
 
+    /* Append the bytes to the output, the file and client output are written in the output buffer sized blocks */
     template <typename T = uint8_t>
-    inline bool setOutput(MB_FS *mbfs, uint8_t val, esp_google_sheet_base64_io_t<T> &out, T **pos)
+    inline bool setOutput(MB_FS *mbfs, const uint8_t *data, size_t len, esp_google_sheet_base64_io_t<T> &out, T **pos)
     {
         if (out.outT)
         {
             if (out.outC || out.filetype != mb_fs_mem_storage_type_undefined)
             {
-                out.outT[out.bufWrite++] = val;
-                if (out.bufWrite == (int)out.bufLen && !writeOutput(mbfs, out))
-                    return false;
+                while (len > 0)
+                {
+                    size_t n = out.bufLen - out.bufWrite;
+                    if (n > len)
+                        n = len;
+                    memcpy((uint8_t *)out.outT + out.bufWrite, data, n);
+                    out.bufWrite += n;
+                    data += n;
+                    len -= n;
+                    if (out.bufWrite == (int)out.bufLen && !writeOutput(mbfs, out))
+                        return false;
+                }
             }
             else
-                *(*pos)++ = (T)(val);
+            {
+                for (size_t i = 0; i < len; i++)
+                    *(*pos)++ = (T)(data[i]);
+            }
         }
         else if (out.outL)
-            out.outL->push_back(val);
+        {
+            for (size_t i = 0; i < len; i++)
+                out.outL->push_back(data[i]);
+        }
 
         return true;
     }
 
     template <typename T>
-    inline bool decode(MB_FS *mbfs, unsigned char *base64DecBuf, const char *src, size_t len, esp_google_sheet_base64_io_t<T> &out)
+    inline bool decode(MB_FS *mbfs, const char *src, size_t len, esp_google_sheet_base64_io_t<T> &out)
     {
-        // the maximum chunk size that writes to output is limited by out.bufLen, the minimum is depending on the source length
-        bool ret = false;
-        unsigned char *block = MemoryHelper::createBuffer<unsigned char *>(mbfs, 4, false);
-        unsigned char temp;
-        size_t i, count;
-        int pad = 0;
-        size_t extra_pad;
         T *pos = out.outT ? (T *)&out.outT[0] : nullptr;
         if (len == 0)
             len = strlen(src);
 
-        count = 0;
+        DecodeState st;
+        int n = 0;
 
-        for (i = 0; i < len; i++)
+        // The byte array is decoded in place
+        if (sizeof(T) == 1 && out.outT && !out.outC && out.filetype == mb_fs_mem_storage_type_undefined)
         {
-            if ((uint8_t)base64DecBuf[(uint8_t)src[i]] != 0x80)
-                count++;
+            n = decodeChunk(src, len, (uint8_t *)pos, st);
+            int last = decodeEnd((uint8_t *)pos + n, st);
+            return last >= 0 && n + last > 0;
         }
 
-        if (count == 0)
-            goto skip;
+        // The other outputs are decoded in 48 chars chunks
+        uint8_t buf[36 + 3];
+        size_t total = 0;
 
-        extra_pad = (4 - count % 4) % 4;
-        count = 0;
-        for (i = 0; i < len + extra_pad; i++)
+        for (size_t i = 0; i < len && !st.end; i += 48)
         {
-            unsigned char val;
-
-            if (i >= len)
-                val = '=';
-            else
-                val = src[i];
-
-            temp = base64DecBuf[val];
-
-            if (temp == 0x80)
-                continue;
-
-            if (val == '=')
-                pad++;
-
-            block[count] = temp;
-            count++;
-            if (count == 4)
-            {
-
-                setOutput(mbfs, (block[0] << 2) | (block[1] >> 4), out, &pos);
-
-                count = 0;
-                if (pad)
-                {
-                    if (pad == 1)
-                        setOutput(mbfs, (block[1] << 4) | (block[2] >> 2), out, &pos);
-                    else if (pad > 2)
-                        goto skip;
-
-                    break;
-                }
-                else
-                {
-                    setOutput(mbfs, (block[1] << 4) | (block[2] >> 2), out, &pos);
-                    setOutput(mbfs, (block[2] << 6) | block[3], out, &pos);
-                }
-            }
+            n = decodeChunk(src + i, len - i < 48 ? len - i : 48, buf, st);
+            total += n;
+            if (!setOutput(mbfs, buf, n, out, &pos))
+                return false;
         }
 
-        // write remaining
-        if (out.bufWrite > 0 && !writeOutput(mbfs, out))
-            goto skip;
-
-        ret = true;
-
-    skip:
-        MemoryHelper::freeBuffer(mbfs, block);
-        return ret;
-    }
+        n = decodeEnd(buf, st);
+        total += n > 0 ? n : 0;
 
-    template <typename T>
-    inline bool encodeLast(MB_FS *mbfs, unsigned char *base64EncBuf, const unsigned char *in, size_t len,
-                           esp_google_sheet_base64_io_t<T> &out, T **pos)
-    {
-        if (len > 2)
+        if (n < 0 || total == 0 || !setOutput(mbfs, buf, n, out, &pos))
             return false;
 
-        if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, pos))
-            return false;
-
-        if (len == 1)
-        {
-            if (!setOutput(mbfs, base64EncBuf[(in[0] & 0x03) << 4], out, pos))
-                return false;
-            if (!setOutput(mbfs, '=', out, pos))
-                return false;
-        }
-        else
-        {
-            if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[(in[1] & 0x0f) << 2], out, pos))
-                return false;
-        }
-
-        if (!setOutput(mbfs, '=', out, pos))
+        // write remaining
+        if (out.bufWrite > 0 && !writeOutput(mbfs, out))
             return false;
 
         return true;
     }
 
     template <typename T>
-    inline bool encode(MB_FS *mbfs, unsigned char *base64EncBuf, uint8_t *src, size_t len,
+    inline bool encode(MB_FS *mbfs, const unsigned char *base64EncBuf, uint8_t *src, size_t len,
                        esp_google_sheet_base64_io_t<T> &out, bool writeAllRemaining = true)
     {
-        const unsigned char *end, *in;
-
         T *pos = out.outT ? (T *)&out.outT[0] : nullptr;
-        in = src;
-        end = src + len;
 
-        while (end - in >= 3)
+        // The char array is encoded in place
+        if (sizeof(T) == 1 && out.outT && !out.outC && out.filetype == mb_fs_mem_storage_type_undefined)
         {
-            if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, &pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, &pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[((in[1] & 0x0f) << 2) | (in[2] >> 6)], out, &pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[in[2] & 0x3f], out, &pos))
+            size_t n = encodeBlocks(base64EncBuf, src, len / 3, (char *)pos);
+            encodeTail(base64EncBuf, src + len / 3 * 3, len % 3, (char *)pos + n, true);
+            return true;
+        }
+
+        // The other outputs are encoded in 48 bytes chunks
+        char buf[64];
+
+        for (size_t i = 0; i + 3 <= len; i += 48)
+        {
+            size_t blocks = (len - i) / 3 < 16 ? (len - i) / 3 : 16;
+            size_t n = encodeBlocks(base64EncBuf, src + i, blocks, buf);
+            if (!setOutput(mbfs, (const uint8_t *)buf, n, out, &pos))
                 return false;
-            in += 3;
         }
 
-        if (end - in && !encodeLast(mbfs, base64EncBuf, in, end - in, out, &pos))
+        size_t n = encodeTail(base64EncBuf, src + len / 3 * 3, len % 3, buf, true);
+        if (n > 0 && !setOutput(mbfs, (const uint8_t *)buf, n, out, &pos))
             return false;
 
         if (writeAllRemaining && out.bufWrite > 0 && !writeOutput(mbfs, out))
@@ -955,60 +1773,133 @@ namespace Base64Helper
 
         return true;
     }
+
     template <typename T>
     inline bool decodeToArray(MB_FS *mbfs, const MB_String &src, MB_VECTOR<T> &val)
     {
         esp_google_sheet_base64_io_t<T> out;
         out.outL = &val;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<T>(mbfs, base64DecBuf, src.c_str(), src.length(), out);
-        MemoryHelper::freeBuffer(mbfs, base64DecBuf);
-        return ret;
+        return decode<T>(mbfs, src.c_str(), src.length(), out);
     }
 
-    inline bool decodeToFile(MB_FS *mbfs, const char *src, size_t len, mbfs_file_type type)
+    // Decode the base64 body of PEM into the new buffer that should be freed with MemoryHelper::freeBuffer
+    inline bool decodePEM(MB_FS *mbfs, const char *pem, uint8_t **der, size_t &derLen)
     {
+        const char *begin = strstr(pem, pgm2Str(gauth_pgm_str_46 /* "-----BEGIN" */));
+        if (begin)
+            begin = strchr(begin, '\n');
+        const char *end = begin ? strstr(begin, pgm2Str(gauth_pgm_str_47 /* "-----END" */)) : nullptr;
+        if (!end)
+            return false;
+
+        size_t count = 0;
+        for (const char *p = begin; p < end; p++)
+        {
+            if (esp_google_sheet_base64_dec_table[(uint8_t)*p] < 0x40)
+                count++;
+        }
+
+        derLen = count * 3 / 4;
+        *der = derLen > 0 ? MemoryHelper::createBuffer<uint8_t *>(mbfs, derLen + 3) : nullptr;
+
         esp_google_sheet_base64_io_t<uint8_t> out;
-        out.filetype = type;
-        uint8_t *buf = MemoryHelper::createBuffer<uint8_t *>(mbfs, out.bufLen);
-        out.outT = buf;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<uint8_t>(mbfs, base64DecBuf, src, strlen(src), out);
-        MemoryHelper::freeBuffer(mbfs, buf);
-        MemoryHelper::freeBuffer(mbfs, base64DecBuf);
+        out.outT = *der;
+        bool ret = *der && decode<uint8_t>(mbfs, begin, end - begin, out);
+
+        if (!ret)
+        {
+            if (*der)
+                MemoryHelper::freeBuffer(mbfs, *der);
+            *der = nullptr;
+            derLen = 0;
+        }
+
         return ret;
     }
 
-    inline void encodeUrl(MB_FS *mbfs, char *encoded, unsigned char *string, size_t len)
+    inline bool decodeToFile(MB_FS *mbfs, const char *src, size_t len, mbfs_file_type type)
     {
-        size_t i;
-        char *p = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, true);
+        if (len == 0)
+            len = strlen(src);
+
+        // The source is decoded in chunks that fill the file buffer, each chunk is written at once
+        size_t bufLen = 1024;
+        uint8_t *buf = MemoryHelper::createBuffer<uint8_t *>(mbfs, bufLen + 3);
+        size_t chunk = bufLen / 3 * 4;
 
-        for (i = 0; i < len - 2; i += 3)
+        DecodeState st;
+        bool ret = true;
+        size_t total = 0;
+
+        for (size_t i = 0; i < len && !st.end && ret; i += chunk)
         {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-            *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2) | ((int)(string[i + 2] & 0xC0) >> 6)];
-            *p++ = base64EncBuf[string[i + 2] & 0x3F];
+            int n = decodeChunk(src + i, len - i < chunk ? len - i : chunk, buf, st);
+            total += n;
+            ret = n == 0 || mbfs->write(mbfs_type type, buf, n) == n;
         }
 
-        if (i < len)
+        int n = decodeEnd(buf, st);
+        if (n < 0 || (n > 0 && mbfs->write(mbfs_type type, buf, n) != n))
+            ret = false;
+
+        MemoryHelper::freeBuffer(mbfs, buf);
+        return ret && total + n > 0;
+    }
+
+    inline void encodeUrl(MB_FS *mbfs, char *encoded, unsigned char *string, size_t len)
+    {
+        size_t n = encodeBlocks(esp_google_sheet_base64url_table, string, len / 3, encoded);
+        n += encodeTail(esp_google_sheet_base64url_table, string + len / 3 * 3, len % 3, encoded + n, false);
+        encoded[n] = '\0';
+    }
+
+    /* The base64url encoder that writes into the preallocated buffer as the input was appended,
+       the bytes of the incomplete block are kept between the writes */
+    struct UrlEncoder
+    {
+        char *out = nullptr;
+        size_t pos = 0;
+        uint8_t carry[3];
+        uint8_t count = 0;
+
+        /* Append the data, return the number of chars written */
+        size_t write(const uint8_t *data, size_t len)
         {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            if (i == (len - 1))
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4)];
-            else
+            size_t start = pos;
+
+            while (count > 0 && count < 3 && len > 0)
             {
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-                *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2)];
+                carry[count++] = *data++;
+                len--;
             }
-        }
 
-        *p++ = '\0';
+            if (count == 3)
+            {
+                pos += encodeBlocks(esp_google_sheet_base64url_table, carry, 1, out + pos);
+                count = 0;
+            }
 
-        MemoryHelper::freeBuffer(mbfs, base64EncBuf);
-    }
+            size_t blocks = len / 3;
+            pos += encodeBlocks(esp_google_sheet_base64url_table, data, blocks, out + pos);
+            data += blocks * 3;
+            len -= blocks * 3;
+
+            while (len-- > 0)
+                carry[count++] = *data++;
+
+            return pos - start;
+        }
+
+        /* Encode the remaining bytes without padding and terminate the output, return the number of chars written */
+        size_t end()
+        {
+            size_t start = pos;
+            pos += encodeTail(esp_google_sheet_base64url_table, carry, count, out + pos, false);
+            count = 0;
+            out[pos] = '\0';
+            return pos - start;
+        }
+    };
 
     inline MB_String encodeToString(MB_FS *mbfs, uint8_t *src, size_t len)
     {
@@ -1016,11 +1907,9 @@ namespace Base64Helper
         char *encoded = MemoryHelper::createBuffer<char *>(mbfs, encodedLength(len) + 1);
         esp_google_sheet_base64_io_t<char> out;
         out.outT = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, false);
-        if (encode<char>(mbfs, base64EncBuf, (uint8_t *)src, len, out))
+        if (encode<char>(mbfs, esp_google_sheet_base64_table, (uint8_t *)src, len, out))
             str = encoded;
         MemoryHelper::freeBuffer(mbfs, encoded);
-        MemoryHelper::freeBuffer(mbfs, base64EncBuf);
         return str;
     }
 
@@ -1030,16 +1919,132 @@ namespace Base64Helper
         out.outC = client;
         uint8_t *buf = MemoryHelper::createBuffer<uint8_t *>(mbfs, out.bufLen);
         out.outT = buf;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, false);
-        bool ret = encode<uint8_t>(mbfs, base64EncBuf, (uint8_t *)data, len, out);
+        bool ret = encode<uint8_t>(mbfs, esp_google_sheet_base64_table, (uint8_t *)data, len, out);
         MemoryHelper::freeBuffer(mbfs, buf);
-        MemoryHelper::freeBuffer(mbfs, base64EncBuf);
         return ret;
     }
 };
 
 namespace HttpHelper
 {
+    /* The two-pass request composer. The first pass measures the request length, the buffer is
+       reserved once and the second pass fills it without reallocation.
+
+       HttpHelper::RequestComposer rc(req);
+       do
+       {
+           rc += FPSTR("GET /path");
+       } while (rc.next());
+    */
+    class RequestComposer
+    {
+    public:
+        explicit RequestComposer(MB_String &req) : req(req) {}
+
+        /* End the current pass, return true when the fill pass should run */
+        bool next()
+        {
+            if (!measuring)
+                return false;
+
+            measuring = false;
+            req.clear();
+            req.reserve(len);
+            return true;
+        }
+
+        size_t length() const { return len; }
+
+        RequestComposer &operator+=(const char *v)
+        {
+            if (!v)
+                return *this;
+
+            if (measuring)
+                len += strlen_P(v);
+            else
+                req += v;
+            return *this;
+        }
+
+        RequestComposer &operator+=(const __FlashStringHelper *v)
+        {
+            if (!v)
+                return *this;
+
+            if (measuring)
+                len += strlen_P((PGM_P)v);
+            else
+                req += v;
+            return *this;
+        }
+
+        RequestComposer &operator+=(const MB_String &v)
+        {
+            if (measuring)
+                len += v.length();
+            else
+                req += v;
+            return *this;
+        }
+
+        RequestComposer &operator+=(char v)
+        {
+            if (measuring)
+                len++;
+            else
+                req += v;
+            return *this;
+        }
+
+        template <typename T>
+        auto operator+=(T v) -> typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value, RequestComposer &>::type
+        {
+            if (measuring)
+            {
+                // The decimal digits and sign
+                len++;
+                if (v < 0)
+                    len++;
+                while (v / 10 != 0)
+                {
+                    v /= 10;
+                    len++;
+                }
+            }
+            else
+                req += v;
+            return *this;
+        }
+
+        /* Append the URL encoded string, the skip character is dropped */
+        RequestComposer &addEncoded(const char *v, char skip = 0)
+        {
+            for (; v && *v; v++)
+            {
+                if (*v == skip)
+                    continue;
+
+                if (URLHelper::unreserved(*v))
+                    *this += *v;
+                else
+                {
+                    char d1, d2;
+                    URLHelper::hexchar(*v, d1, d2);
+                    *this += '%';
+                    *this += d1;
+                    *this += d2;
+                }
+            }
+            return *this;
+        }
+
+    private:
+        MB_String &req;
+        size_t len = 0;
+        bool measuring = true;
+    };
+
     inline void addNewLine(MB_String &header)
     {
         header += esp_google_sheet_pgm_str_1; // "\r\n"
@@ -1163,6 +2168,13 @@ namespace HttpHelper
             StringHelper::tokenSubString(src, response.etag,
                                          esp_google_sheet_pgm_str_23 /* "ETag: " */,
                                          esp_google_sheet_pgm_str_1 /* "\r\n" */, beginPos, 0, false);
+            StringHelper::tokenSubStringInt(src, response.retryAfter,
+                                            esp_google_sheet_pgm_str_51 /* "Retry-After: " */,
+                                            esp_google_sheet_pgm_str_1 /* "\r\n" */, beginPos, 0, false);
+            if (StringHelper::tokenSubString(src, out,
+                                             esp_google_sheet_pgm_str_53 /* "\nDate: " */,
+                                             esp_google_sheet_pgm_str_1 /* "\r\n" */, beginPos, 0, false))
+                response.date = TimeHelper::parseHttpDate(out.c_str());
             response.payloadLen = response.contentLen;
 
             if (StringHelper::tokenSubString(src, response.transferEnc,
@@ -1313,6 +2325,26 @@ namespace HttpHelper
         return val;
     }
 
+    /* Read the trailer fields and the empty line that end the chunked body, the bytes that were left
+       in the client make the kept alive connection look stale */
+    inline void readChunkTrailer(Client *client)
+    {
+        char line[64];
+        bool lineStart = true;
+        while (client->available())
+        {
+            int len = readLine(client, line, sizeof(line));
+            if (len == 0)
+                break;
+
+            bool lineEnd = line[len - 1] == '\n';
+            if (lineStart && lineEnd && (len == 1 || (len == 2 && line[0] == '\r')))
+                break;
+
+            lineStart = lineEnd;
+        }
+    }
+
     // Returns -1 when complete
     inline int readChunkedData(MB_FS *mbfs, Client *client, char *out1, MB_String *out2,
                                struct esp_google_sheet_tcp_response_handler_t &tcpHandler)
@@ -1362,11 +2394,16 @@ namespace HttpHelper
                         tcpHandler.chunkState.chunkedSize = hex2int(temp);
                         MemoryHelper::freeBuffer(mbfs, temp);
                     }
+
+                    GS_TRACE_INSTANT(esp_google_sheet_trace_event_chunk_header, tcpHandler.chunkState.chunkedSize);
                 }
 
                 // last chunk
                 if (tcpHandler.chunkState.chunkedSize < 1)
+                {
+                    readChunkTrailer(client);
                     olen = -1;
+                }
             }
             else
                 tcpHandler.chunkState.state = 0;
@@ -1495,6 +2532,18 @@ namespace Utils
         return mbfs->calCRC(buf);
     }
 
+    // CRC-32 (IEEE 802.3) update without the lookup table, start with 0xFFFFFFFF and invert the result
+    inline uint32_t crc32(uint32_t crc, const uint8_t *buf, size_t len)
+    {
+        while (len--)
+        {
+            crc ^= *buf++;
+            for (int i = 0; i < 8; i++)
+                crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+        return crc;
+    }
+
     inline bool isNoContent(esp_google_sheet_server_response_data_t *response)
     {
         return !response->isChunkedEnc && response->contentLen == 0;
@@ -1502,8 +2551,10 @@ namespace Utils
 
     inline bool isResponseTimeout(esp_google_sheet_tcp_response_handler_t *tcpHandler, bool &complete)
     {
-        if (millis() - tcpHandler->dataTime > 5000)
+        if (millis() - tcpHandler->dataTime > tcpHandler->dataTimeout)
         {
+            GS_TRACE_INSTANT(esp_google_sheet_trace_event_response_timeout, millis() - tcpHandler->dataTime);
+
             // Read all remaining data
             tcpHandler->client->flush();
             complete = true;
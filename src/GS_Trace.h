@@ -0,0 +1,180 @@
+#ifndef ESP_GOOGLE_SHEET_CLIENT_TRACE_H
+#define ESP_GOOGLE_SHEET_CLIENT_TRACE_H
+
+#include <Arduino.h>
+#include "ESP_Google_Sheet_Client_FS_Config.h"
+#include "mbfs/MB_FS.h"
+
+enum esp_google_sheet_trace_event
+{
+    esp_google_sheet_trace_event_request,
+    esp_google_sheet_trace_event_connect,
+    esp_google_sheet_trace_event_send_chunk,
+    esp_google_sheet_trace_event_first_byte,
+    esp_google_sheet_trace_event_read_chunk,
+    esp_google_sheet_trace_event_chunk_header,
+    esp_google_sheet_trace_event_response_timeout,
+    esp_google_sheet_trace_event_token_step,
+    esp_google_sheet_trace_event_token_status,
+    esp_google_sheet_trace_event_max
+};
+
+#if defined(ESP_GOOGLE_SHEET_CLIENT_ENABLE_TRACE)
+
+#ifndef ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE
+#define ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE 128
+#endif
+
+#define GS_TRACE_BEGIN(event, arg) TraceHelper::add(event, 'B', arg)
+#define GS_TRACE_END(event, arg) TraceHelper::add(event, 'E', arg)
+#define GS_TRACE_INSTANT(event, arg) TraceHelper::add(event, 'i', arg)
+
+struct esp_google_sheet_trace_item_t
+{
+    uint32_t us;
+    int32_t arg;
+    uint8_t event;
+    // The Chrome trace phase, 'B' (begin), 'E' (end) or 'i' (instant)
+    char phase;
+};
+
+struct esp_google_sheet_trace_ring_t
+{
+    esp_google_sheet_trace_item_t items[ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE];
+    // The next write position and the number of items
+    uint16_t head = 0;
+    uint16_t count = 0;
+};
+
+#else
+
+#define GS_TRACE_BEGIN(event, arg)
+#define GS_TRACE_END(event, arg)
+#define GS_TRACE_INSTANT(event, arg)
+
+#endif
+
+namespace TraceHelper
+{
+#if defined(ESP_GOOGLE_SHEET_CLIENT_ENABLE_TRACE)
+
+    inline esp_google_sheet_trace_ring_t &ring()
+    {
+        static esp_google_sheet_trace_ring_t r;
+        return r;
+    }
+
+    inline void add(esp_google_sheet_trace_event event, char phase, int32_t arg)
+    {
+        esp_google_sheet_trace_ring_t &r = ring();
+        esp_google_sheet_trace_item_t &item = r.items[r.head];
+        item.us = micros();
+        item.arg = arg;
+        item.event = event;
+        item.phase = phase;
+        r.head = (r.head + 1) % ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE;
+        if (r.count < ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE)
+            r.count++;
+    }
+
+    inline const __FlashStringHelper *eventName(uint8_t event)
+    {
+        switch (event)
+        {
+        case esp_google_sheet_trace_event_request:
+            return FPSTR("request");
+        case esp_google_sheet_trace_event_connect:
+            return FPSTR("connect");
+        case esp_google_sheet_trace_event_send_chunk:
+            return FPSTR("send_chunk");
+        case esp_google_sheet_trace_event_first_byte:
+            return FPSTR("first_byte");
+        case esp_google_sheet_trace_event_read_chunk:
+            return FPSTR("read_chunk");
+        case esp_google_sheet_trace_event_chunk_header:
+            return FPSTR("chunk_header");
+        case esp_google_sheet_trace_event_response_timeout:
+            return FPSTR("response_timeout");
+        case esp_google_sheet_trace_event_token_step:
+            return FPSTR("token_step");
+        case esp_google_sheet_trace_event_token_status:
+            return FPSTR("token_status");
+        default:
+            return FPSTR("unknown");
+        }
+    }
+
+#endif
+
+    inline void clear()
+    {
+#if defined(ESP_GOOGLE_SHEET_CLIENT_ENABLE_TRACE)
+        ring().head = 0;
+        ring().count = 0;
+#endif
+    }
+
+    // Print the events from the oldest in Chrome trace event format (chrome://tracing or Perfetto).
+    inline void dump(Print &out)
+    {
+        out.print(FPSTR("{\"traceEvents\":["));
+
+#if defined(ESP_GOOGLE_SHEET_CLIENT_ENABLE_TRACE)
+        esp_google_sheet_trace_ring_t &r = ring();
+        uint16_t start = (r.head + ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE - r.count) % ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE;
+
+        for (uint16_t i = 0; i < r.count; i++)
+        {
+            esp_google_sheet_trace_item_t &item = r.items[(start + i) % ESP_GOOGLE_SHEET_CLIENT_TRACE_RING_SIZE];
+            if (i > 0)
+                out.print(',');
+            out.print(FPSTR("\n{\"name\":\""));
+            out.print(eventName(item.event));
+            out.print(FPSTR("\",\"cat\":\"gsheet\",\"ph\":\""));
+            out.print(item.phase);
+            out.print(FPSTR("\",\"ts\":"));
+            out.print(item.us);
+            out.print(FPSTR(",\"pid\":1,\"tid\":1,"));
+            if (item.phase == 'i')
+                out.print(FPSTR("\"s\":\"t\","));
+            out.print(FPSTR("\"args\":{\"value\":"));
+            out.print(item.arg);
+            out.print(FPSTR("}}"));
+        }
+#endif
+
+        out.println(FPSTR("\n],\"displayTimeUnit\":\"ms\"}"));
+    }
+
+    // The Print that writes to the opened MB_FS file
+    class FileWriter : public Print
+    {
+    public:
+        FileWriter(MB_FS *mbfs, mbfs_file_type type) : mbfs(mbfs), type(type) {}
+
+        size_t write(uint8_t c) { return mbfs->write(type, c) == 1 ? 1 : 0; }
+
+        size_t write(const uint8_t *buf, size_t size)
+        {
+            int ret = mbfs->write(type, (uint8_t *)buf, size);
+            return ret > 0 ? ret : 0;
+        }
+
+    private:
+        MB_FS *mbfs = nullptr;
+        mbfs_file_type type;
+    };
+
+    inline bool dump(MB_FS *mbfs, const char *filename, mbfs_file_type type)
+    {
+        if (mbfs->open(filename, type, mb_fs_open_mode_write) < 0)
+            return false;
+
+        FileWriter writer(mbfs, type);
+        dump(writer);
+        mbfs->close(type);
+        return true;
+    }
+};
+
+#endif
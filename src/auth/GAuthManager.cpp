@@ -31,15 +31,30 @@ void GAuthManager::begin(esp_google_sheet_auth_cfg_t *cfg, MB_FS *mbfs, uint32_t
 void GAuthManager::end()
 {
     freeJson();
+    if (config)
+        freeDER();
 #if defined(ESP_GOOGLE_SHEET_CLIENT_HAS_WIFIMULTI)
     if (multi)
         delete multi;
     multi = nullptr;
 #endif
+    freeTokenClient();
     if (tcpClient)
         freeClient(&tcpClient);
 }
 
+GS_TCP_Client *GAuthManager::authClient()
+{
+    return tokenClient ? tokenClient : tcpClient;
+}
+
+void GAuthManager::freeTokenClient()
+{
+    if (tokenClient)
+        delete tokenClient;
+    tokenClient = nullptr;
+}
+
 void GAuthManager::newClient(GS_TCP_Client **client)
 {
 
@@ -89,77 +104,321 @@ void GAuthManager::freeClient(GS_TCP_Client **client)
 
 bool GAuthManager::parseSAFile()
 {
-    if (config->signer.pk.length() > 0)
+    if (config->signer.pk.length() > 0 || config->signer.der)
         return false;
 
-    int res = mbfs->open(config->service_account.json.path,
-                         mbfs_type config->service_account.json.storage_type,
-                         mb_fs_open_mode_read);
+    struct gauth_sa_file_reader_t reader;
+    bool useCache = config->service_account.key_cache.path.length() > 0;
+
+    // The key cache is valid when the key file checksum matches, the JSON, PEM and base64 parsing are skipped
+    if (useCache)
+    {
+        if (!readSAFile(reader, false))
+            return false;
+
+        if (loadKeyCache(reader.size, ~reader.crc))
+            return true;
+
+        reader = gauth_sa_file_reader_t();
+    }
+
+    clearServiceAccountCreds();
 
-    if (res >= 0)
+    if (!readSAFile(reader, true))
     {
         clearServiceAccountCreds();
-        initJson();
+        return false;
+    }
+
+    if (useCache && Base64Helper::decodePEM(mbfs, config->signer.pk.c_str(), &config->signer.der, config->signer.derLen))
+    {
+        // Sign with the DER key from now on
+        config->signer.pk.clear();
+        saveKeyCache(reader.size, ~reader.crc);
+    }
+
+    return true;
+}
+
+bool GAuthManager::readSAFile(struct gauth_sa_file_reader_t &reader, bool parse)
+{
+    reader.type = mbfs_type config->service_account.json.storage_type;
 
-        size_t len = res;
-        char *buf = MemoryHelper::createBuffer<char *>(mbfs, len + 10);
-        if (mbfs->available(mbfs_type config->service_account.json.storage_type))
+    if (mbfs->open(config->service_account.json.path, reader.type, mb_fs_open_mode_read) < 0)
+        return false;
+
+    bool ret = true;
+
+    if (parse)
+    {
+        MB_String key, type;
+        int c = saSkipSpace(reader);
+        ret = c == '{';
+
+        while (ret)
         {
-            if ((int)len == mbfs->read(mbfs_type config->service_account.json.storage_type, (uint8_t *)buf, len))
-                jsonPtr->setJsonData(buf);
+            c = saSkipSpace(reader);
+            if (c == ',')
+                continue;
+            if (c != '"')
+                break;
+
+            key.clear();
+            ret = saReadString(reader, &key) && saSkipSpace(reader) == ':';
+            if (ret)
+            {
+                c = saSkipSpace(reader);
+                // Only the string values of the top level keys are kept, the others are skipped
+                ret = c == '"' ? saReadString(reader, saField(key, type)) : saSkipValue(reader, c);
+            }
         }
 
-        mbfs->close(mbfs_type config->service_account.json.storage_type);
+        ret = ret && c == '}' && type.find(pgm2Str(gauth_pgm_str_2 /* service_account */), 0) != MB_String::npos;
+    }
+
+    // Read to the end for the checksum of the whole file
+    while (saRead(reader) >= 0)
+        ;
+
+    mbfs->close(reader.type);
+
+    return ret;
+}
 
-        if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_1)) // type
+int GAuthManager::saRead(struct gauth_sa_file_reader_t &reader)
+{
+    if (reader.back >= 0)
+    {
+        int c = reader.back;
+        reader.back = -1;
+        return c;
+    }
+
+    if (reader.pos == reader.len)
+    {
+        Utils::idle();
+        reader.len = mbfs->available(reader.type) ? mbfs->read(reader.type, reader.buf, sizeof(reader.buf)) : 0;
+        reader.pos = 0;
+        if (reader.len <= 0)
         {
-            if (resultPtr->to<MB_String>().find(pgm2Str(gauth_pgm_str_2 /* service_account */), 0) != MB_String::npos)
-            {
-                if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_3)) // project_id
-                    config->service_account.data.project_id = resultPtr->to<const char *>();
+            reader.len = 0;
+            return -1;
+        }
+        reader.size += reader.len;
+        reader.crc = Utils::crc32(reader.crc, reader.buf, reader.len);
+    }
 
-                if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_4)) // private_key_id
-                    config->service_account.data.private_key_id = resultPtr->to<const char *>();
+    return reader.buf[reader.pos++];
+}
 
-                if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_5)) // private_key
+int GAuthManager::saSkipSpace(struct gauth_sa_file_reader_t &reader)
+{
+    int c = saRead(reader);
+    while (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        c = saRead(reader);
+    return c;
+}
+
+bool GAuthManager::saReadString(struct gauth_sa_file_reader_t &reader, MB_String *out)
+{
+    int c = 0;
+    while ((c = saRead(reader)) >= 0)
+    {
+        if (c == '"')
+            return true;
+
+        if (c == '\\')
+        {
+            c = saRead(reader);
+            if (c == 'n')
+                c = '\n';
+            else if (c == 'r')
+                c = '\r';
+            else if (c == 't')
+                c = '\t';
+            else if (c == 'b')
+                c = '\b';
+            else if (c == 'f')
+                c = '\f';
+            else if (c == 'u')
+            {
+                uint32_t cp = 0;
+                for (int i = 0; i < 4; i++)
                 {
-                    char *temp = MemoryHelper::createBuffer<char *>(mbfs, strlen(resultPtr->to<const char *>()));
-                    size_t c = 0;
-                    for (size_t i = 0; i < strlen(resultPtr->to<const char *>()); i++)
-                    {
-                        if (resultPtr->to<const char *>()[i] == '\\')
-                        {
-                            Utils::idle();
-                            temp[c++] = '\n';
-                            i++;
-                        }
-                        else
-                            temp[c++] = resultPtr->to<const char *>()[i];
-                    }
-                    config->signer.pk = temp;
-                    resultPtr->clear();
-                    MemoryHelper::freeBuffer(mbfs, temp);
+                    c = saRead(reader);
+                    if (c >= '0' && c <= '9')
+                        cp = (cp << 4) | (c - '0');
+                    else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                        cp = (cp << 4) | ((c | 0x20) - 'a' + 10);
+                    else
+                        return false;
                 }
 
-                if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_6)) // client_email
-                    config->service_account.data.client_email = resultPtr->to<const char *>();
-                if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_7)) // client_id
-                    config->service_account.data.client_id = resultPtr->to<const char *>();
+                // UTF-8 of the basic multilingual plane
+                if (out && cp < 0x80)
+                    *out += (char)cp;
+                else if (out && cp < 0x800)
+                {
+                    *out += (char)(0xC0 | (cp >> 6));
+                    *out += (char)(0x80 | (cp & 0x3F));
+                }
+                else if (out)
+                {
+                    *out += (char)(0xE0 | (cp >> 12));
+                    *out += (char)(0x80 | ((cp >> 6) & 0x3F));
+                    *out += (char)(0x80 | (cp & 0x3F));
+                }
+                continue;
+            }
+            else if (c < 0)
+                return false;
+        }
 
-                freeJson();
+        if (out)
+            *out += (char)c;
+    }
 
-                MemoryHelper::freeBuffer(mbfs, buf);
+    return false;
+}
 
-                return true;
-            }
+bool GAuthManager::saSkipValue(struct gauth_sa_file_reader_t &reader, int c)
+{
+    if (c == '{' || c == '[')
+    {
+        int depth = 1;
+        while (depth > 0 && (c = saRead(reader)) >= 0)
+        {
+            if (c == '"' && !saReadString(reader, nullptr))
+                return false;
+            else if (c == '{' || c == '[')
+                depth++;
+            else if (c == '}' || c == ']')
+                depth--;
         }
+        return depth == 0;
+    }
+
+    // The number, boolean and null end at the delimiter which is read again by the caller
+    while (c >= 0 && c != ',' && c != '}' && c != ']' && c != ' ' && c != '\t' && c != '\r' && c != '\n')
+        c = saRead(reader);
+    reader.back = c;
+
+    return c >= 0;
+}
+
+MB_String *GAuthManager::saField(const MB_String &key, MB_String &type)
+{
+    if (strcmp(key.c_str(), pgm2Str(gauth_pgm_str_1 /* type */)) == 0)
+        return &type;
+    else if (strcmp(key.c_str(), pgm2Str(gauth_pgm_str_3 /* project_id */)) == 0)
+        return &config->service_account.data.project_id;
+    else if (strcmp(key.c_str(), pgm2Str(gauth_pgm_str_4 /* private_key_id */)) == 0)
+        return &config->service_account.data.private_key_id;
+    else if (strcmp(key.c_str(), pgm2Str(gauth_pgm_str_5 /* private_key */)) == 0)
+        return &config->signer.pk;
+    else if (strcmp(key.c_str(), pgm2Str(gauth_pgm_str_6 /* client_email */)) == 0)
+        return &config->service_account.data.client_email;
+    else if (strcmp(key.c_str(), pgm2Str(gauth_pgm_str_7 /* client_id */)) == 0)
+        return &config->service_account.data.client_id;
+    return nullptr;
+}
+
+bool GAuthManager::loadKeyCache(uint32_t size, uint32_t crc)
+{
+    mbfs_file_type type = mbfs_type config->service_account.key_cache.storage_type;
+
+    if (mbfs->open(config->service_account.key_cache.path, type, mb_fs_open_mode_read) < 0)
+        return false;
 
-        freeJson();
+    clearServiceAccountCreds();
+
+    // "GSK1", key file size and CRC-32 (little endian), then the length prefixed strings and DER key
+    uint8_t head[12];
+    uint8_t len[2];
+    bool ret = mbfs->read(type, head, sizeof(head)) == (int)sizeof(head) &&
+               memcmp(head, pgm2Str(gauth_pgm_str_48 /* "GSK1" */), 4) == 0 &&
+               (head[4] | head[5] << 8 | (uint32_t)head[6] << 16 | (uint32_t)head[7] << 24) == size &&
+               (head[8] | head[9] << 8 | (uint32_t)head[10] << 16 | (uint32_t)head[11] << 24) == crc &&
+               readKeyCacheString(type, config->service_account.data.client_email) &&
+               readKeyCacheString(type, config->service_account.data.project_id) &&
+               readKeyCacheString(type, config->service_account.data.private_key_id) &&
+               readKeyCacheString(type, config->service_account.data.client_id) &&
+               mbfs->read(type, len, 2) == 2;
+
+    if (ret)
+    {
+        config->signer.derLen = len[0] | len[1] << 8;
+        config->signer.der = config->signer.derLen > 0 ? MemoryHelper::createBuffer<uint8_t *>(mbfs, config->signer.derLen, false) : nullptr;
+        ret = config->signer.der &&
+              mbfs->read(type, config->signer.der, config->signer.derLen) == (int)config->signer.derLen;
+    }
+
+    mbfs->close(type);
+
+    if (!ret)
+        clearServiceAccountCreds();
+
+    return ret;
+}
+
+bool GAuthManager::readKeyCacheString(mbfs_file_type type, MB_String &out)
+{
+    uint8_t len[2];
+    if (mbfs->read(type, len, 2) != 2)
+        return false;
 
-        MemoryHelper::freeBuffer(mbfs, buf);
+    char buf[33];
+    size_t remaining = len[0] | len[1] << 8;
+    while (remaining > 0)
+    {
+        int n = remaining < sizeof(buf) - 1 ? remaining : sizeof(buf) - 1;
+        if (mbfs->read(type, (uint8_t *)buf, n) != n)
+            return false;
+        buf[n] = '\0';
+        out += buf;
+        remaining -= n;
     }
 
-    return false;
+    return true;
+}
+
+void GAuthManager::saveKeyCache(uint32_t size, uint32_t crc)
+{
+    mbfs_file_type type = mbfs_type config->service_account.key_cache.storage_type;
+
+    if (mbfs->open(config->service_account.key_cache.path, type, mb_fs_open_mode_write) < 0)
+        return;
+
+    uint8_t head[12];
+    memcpy(head, pgm2Str(gauth_pgm_str_48 /* "GSK1" */), 4);
+    for (int i = 0; i < 4; i++)
+    {
+        head[4 + i] = (size >> (8 * i)) & 0xFF;
+        head[8 + i] = (crc >> (8 * i)) & 0xFF;
+    }
+
+    uint8_t len[2] = {(uint8_t)(config->signer.derLen & 0xFF), (uint8_t)(config->signer.derLen >> 8)};
+
+    bool ret = mbfs->write(type, head, sizeof(head)) == (int)sizeof(head) &&
+               writeKeyCacheString(type, config->service_account.data.client_email) &&
+               writeKeyCacheString(type, config->service_account.data.project_id) &&
+               writeKeyCacheString(type, config->service_account.data.private_key_id) &&
+               writeKeyCacheString(type, config->service_account.data.client_id) &&
+               mbfs->write(type, len, 2) == 2 &&
+               mbfs->write(type, config->signer.der, config->signer.derLen) == (int)config->signer.derLen;
+
+    mbfs->close(type);
+
+    // The incomplete cache is never used
+    if (!ret)
+        mbfs->remove(config->service_account.key_cache.path, type);
+}
+
+bool GAuthManager::writeKeyCacheString(mbfs_file_type type, const MB_String &str)
+{
+    uint8_t len[2] = {(uint8_t)(str.length() & 0xFF), (uint8_t)(str.length() >> 8)};
+    return mbfs->write(type, len, 2) == 2 &&
+           (str.length() == 0 || mbfs->write(type, (uint8_t *)str.c_str(), str.length()) == (int)str.length());
 }
 
 void GAuthManager::clearServiceAccountCreds()
@@ -168,12 +427,22 @@ void GAuthManager::clearServiceAccountCreds()
     config->service_account.data.project_id.clear();
     config->service_account.data.private_key_id.clear();
     config->service_account.data.client_email.clear();
+    config->service_account.data.client_id.clear();
     config->signer.pk.clear();
+    freeDER();
+}
+
+void GAuthManager::freeDER()
+{
+    if (config->signer.der)
+        MemoryHelper::freeBuffer(mbfs, config->signer.der);
+    config->signer.der = nullptr;
+    config->signer.derLen = 0;
 }
 
 bool GAuthManager::serviceAccountCredsReady()
 {
-    return (strlen_P(config->service_account.data.private_key) > 0 || config->signer.pk.length() > 0) &&
+    return (strlen_P(config->service_account.data.private_key) > 0 || config->signer.pk.length() > 0 || config->signer.der) &&
            config->service_account.data.client_email.length() > 0 &&
            config->service_account.data.project_id.length() > 0;
 }
@@ -230,7 +499,21 @@ bool GAuthManager::isExpired()
     adjustTime(now);
 
     // time is up or expiry time was reset or unset?
-    return (now > (int)(config->signer.tokens.expires - config->signer.preRefreshSeconds) || config->signer.tokens.expires == 0);
+    return (now > (int)(config->signer.tokens.expires - config->signer.preRefreshSeconds - config->signer.tokens.jitter) ||
+            config->signer.tokens.expires == 0);
+}
+
+bool GAuthManager::tokenValid()
+{
+    if (!config || config->internal.auth_token.length() == 0 || config->signer.tokens.expires == 0)
+        return false;
+
+    time_t now = 0;
+
+    adjustTime(now);
+
+    // The token can be used until one minute before it expires
+    return now + 60 < (int)config->signer.tokens.expires;
 }
 
 void GAuthManager::adjustTime(time_t &now)
@@ -335,7 +618,7 @@ bool GAuthManager::handleToken()
             {
                 bool use_sa_key_file = false, valid_key_file = false;
                 // If service account key json file assigned and no private key parsing data
-                if (config->service_account.json.path.length() > 0 && config->signer.pk.length() == 0)
+                if (config->service_account.json.path.length() > 0 && config->signer.pk.length() == 0 && !config->signer.der)
                 {
                     use_sa_key_file = true;
                     // Parse the private key from service account json file
@@ -416,7 +699,47 @@ void GAuthManager::tryGetTime()
         }
     }
     else
+    {
         TimeHelper::syncClock(mb_ts, mb_ts_offset, config->time_zone, config);
+
+        // NTP runs in background, get the time from the token server instead of waiting
+        if (!config->internal.clock_rdy && config->internal.http_date_time &&
+            (millis() - config->internal.last_http_date_millis > ESP_GOOGLE_SHEET_CLIENT_TIME_SYNC_INTERVAL ||
+             config->internal.last_http_date_millis == 0))
+        {
+            config->internal.last_http_date_millis = millis();
+            requestTime();
+        }
+    }
+}
+
+bool GAuthManager::requestTime()
+{
+    // The token server connection does not verify the server certificate, the valid time is not required
+    if (!initClient(gauth_pgm_str_41 /* "oauth2" */))
+        return false;
+
+    MB_String req;
+    HttpHelper::addRequestHeaderFirst(req, http_get);
+    req += gauth_pgm_str_28; // "/"
+    HttpHelper::addRequestHeaderLast(req);
+    HttpHelper::addGAPIsHostHeader(req, gauth_pgm_str_41 /* "oauth2" */);
+    HttpHelper::addUAHeader(req);
+    HttpHelper::addNewLine(req);
+
+    authClient()->send(req.c_str());
+
+    req.clear();
+
+    if (response_code < 0)
+        return false;
+
+    // The clock is set from the Date header in handleResponse
+    int httpCode = ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_REQUEST_TIMEOUT;
+    MB_String payload;
+    handleResponse(authClient(), httpCode, payload);
+
+    return config->internal.clock_rdy;
 }
 
 void GAuthManager::tokenProcessingTask()
@@ -432,6 +755,10 @@ void GAuthManager::tokenProcessingTask()
 
     config->signer.tokenTaskRunning = true;
 
+#if defined(ESP_GOOGLE_SHEET_CLIENT_ENABLE_TRACE)
+    int step = config->signer.step;
+#endif
+
     time_t now = getTime();
 
     Utils::idle();
@@ -492,8 +819,13 @@ void GAuthManager::tokenProcessingTask()
     // sign the JWT token
     else if (config->signer.step == gauth_jwt_generation_step_sign)
     {
+        unsigned long ms = millis();
+
         if (createJWT())
             config->signer.step = gauth_jwt_generation_step_exchange;
+
+        if (config->metrics)
+            MetricsHelper::observe(config->metrics->jwtSign, millis() - ms);
     }
     // sending JWT token requst for auth token
     else if (config->signer.step == gauth_jwt_generation_step_exchange)
@@ -504,6 +836,13 @@ void GAuthManager::tokenProcessingTask()
             // sending a new request
             ret = requestTokens(false);
 
+            if (config->metrics)
+            {
+                config->metrics->tokenRefreshes++;
+                if (!ret)
+                    config->metrics->tokenErrors++;
+            }
+
             // send error cb
             if (!reconnect())
                 handleTaskError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_CONNECTION_LOST);
@@ -516,6 +855,11 @@ void GAuthManager::tokenProcessingTask()
         }
     }
 
+#if defined(ESP_GOOGLE_SHEET_CLIENT_ENABLE_TRACE)
+    if (step != config->signer.step)
+        GS_TRACE_INSTANT(esp_google_sheet_trace_event_token_step, config->signer.step);
+#endif
+
     // reset task running status
     config->signer.tokenTaskRunning = false;
 }
@@ -555,7 +899,7 @@ bool GAuthManager::refreshToken()
 
     req += jsonPtr->raw(); // {"grantType":"refresh_token","refreshToken":"<refresh token>"}
 
-    tcpClient->send(req.c_str());
+    authClient()->send(req.c_str());
 
     req.clear();
     if (response_code < 0)
@@ -565,7 +909,7 @@ bool GAuthManager::refreshToken()
 
     int httpCode = ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_REQUEST_TIMEOUT;
     MB_String payload;
-    if (handleResponse(tcpClient, httpCode, payload))
+    if (handleResponse(authClient(), httpCode, payload))
     {
         if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_14 /* "error/code" */))
         {
@@ -610,7 +954,7 @@ void GAuthManager::setTokenError(int code)
 bool GAuthManager::handleTaskError(int code, int httpCode)
 {
     // Close TCP connection and unlock used flag
-    tcpClient->stop();
+    authClient()->stop();
     config->internal.processing = false;
 
     switch (code)
@@ -649,7 +993,8 @@ bool GAuthManager::handleTaskError(int code, int httpCode)
     }
 
     // Free memory
-    tcpClient->stop();
+    authClient()->stop();
+    freeTokenClient();
     freeJson();
 
     // reset token processing state
@@ -674,6 +1019,8 @@ void GAuthManager::sendTokenStatusCB()
     tokenInfo.type = config->signer.tokens.token_type;
     tokenInfo.error = config->signer.tokens.error;
 
+    GS_TRACE_INSTANT(esp_google_sheet_trace_event_token_status, tokenInfo.status);
+
     if (config->token_status_callback && isErrorCBTimeOut())
         config->token_status_callback(tokenInfo);
 }
@@ -683,6 +1030,8 @@ bool GAuthManager::handleResponse(GS_TCP_Client *client, int &httpCode, MB_Strin
     if (!reconnect(client))
         return false;
 
+    unsigned long us = micros();
+
     MB_String header;
 
     struct esp_google_sheet_server_response_data_t response;
@@ -690,13 +1039,36 @@ bool GAuthManager::handleResponse(GS_TCP_Client *client, int &httpCode, MB_Strin
 
     HttpHelper::intTCPHandler(client, tcpHandler, 2048, 2048, nullptr);
 
+    // The first byte and the next data timeouts are estimated from the previous responses of this host
+    esp_google_sheet_host_timing_t *ht = client->hostTiming();
+    unsigned long firstByteTimeout = ht ? TimeoutHelper::timeout(config->adaptive, ht->firstByte, config->timeout.serverResponse) : 0;
+
     while (client->connected() && client->available() == 0)
     {
         Utils::idle();
-        if (!reconnect(client, tcpHandler.dataTime))
+        if (!reconnect(client, tcpHandler.dataTime, firstByteTimeout))
+        {
+            if (ht && response_code == ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT)
+                TimeoutHelper::backoff(ht->firstByte);
+            config->timing.firstByte += micros() - us;
             return false;
+        }
     }
 
+    config->timing.firstByte += micros() - us;
+    us = micros();
+
+    if (ht && client->available() > 0)
+        TimeoutHelper::update(ht->firstByte, millis() - tcpHandler.dataTime);
+
+    // The data timeout is counted from the last data
+    unsigned long firstByteMillis = millis(), maxGap = 0;
+    tcpHandler.dataTime = firstByteMillis;
+    if (ht)
+        tcpHandler.dataTimeout = TimeoutHelper::chunkTimeout(config->adaptive, *ht, config->timeout.serverResponse, tcpHandler.defaultChunkSize);
+
+    GS_TRACE_INSTANT(esp_google_sheet_trace_event_first_byte, client->available());
+
     bool complete = false;
 
     tcpHandler.chunkBufSize = tcpHandler.defaultChunkSize;
@@ -707,8 +1079,19 @@ bool GAuthManager::handleResponse(GS_TCP_Client *client, int &httpCode, MB_Strin
     {
         Utils::idle();
 
-        if (!reconnect(client, tcpHandler.dataTime))
+        if (tcpHandler.available() > 0)
+        {
+            if (millis() - tcpHandler.dataTime > maxGap)
+                maxGap = millis() - tcpHandler.dataTime;
+            tcpHandler.dataTime = millis();
+        }
+
+        if (!reconnect(client, tcpHandler.dataTime, ht ? tcpHandler.dataTimeout : 0))
+        {
+            if (ht && response_code == ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT)
+                TimeoutHelper::backoff(ht->gap);
             break;
+        }
 
         if (!HttpHelper::readStatusLine(mbfs, client, tcpHandler, response))
         {
@@ -718,6 +1101,17 @@ bool GAuthManager::handleResponse(GS_TCP_Client *client, int &httpCode, MB_Strin
                 // Read header, complete?
                 if (HttpHelper::readHeader(mbfs, client, tcpHandler, response))
                 {
+                    config->timing.header += micros() - us;
+                    us = micros();
+
+                    // Set the clock from the Date header when NTP time is not ready yet
+                    if (config->internal.http_date_time && !config->internal.clock_rdy &&
+                        response.date > ESP_GOOGLE_SHEET_CLIENT_DEFAULT_TS)
+                    {
+                        setTime(response.date);
+                        config->internal.clock_rdy = TimeHelper::clockReady(mb_ts, mb_ts_offset);
+                    }
+
                     if (response.httpCode == ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_NO_CONTENT)
                         tcpHandler.error.code = 0;
 
@@ -738,6 +1132,8 @@ bool GAuthManager::handleResponse(GS_TCP_Client *client, int &httpCode, MB_Strin
                     tcpHandler.bufferAvailable = HttpHelper::readLine(client,
                                                                       pChunk, tcpHandler.chunkBufSize);
 
+                GS_TRACE_INSTANT(esp_google_sheet_trace_event_read_chunk, tcpHandler.bufferAvailable);
+
                 if (tcpHandler.bufferAvailable > 0)
                 {
                     tcpHandler.payloadRead += tcpHandler.bufferAvailable;
@@ -760,10 +1156,24 @@ bool GAuthManager::handleResponse(GS_TCP_Client *client, int &httpCode, MB_Strin
 
     MemoryHelper::freeBuffer(mbfs, pChunk);
 
+    if (tcpHandler.headerEnded)
+        config->timing.body += micros() - us;
+    else
+        config->timing.header += micros() - us;
+
+    config->timing.bytesReceived += tcpHandler.header.length() + tcpHandler.payloadRead;
+
+    if (ht && complete)
+    {
+        TimeoutHelper::update(ht->gap, maxGap);
+        TimeoutHelper::updateThroughput(*ht, tcpHandler.header.length() + tcpHandler.payloadRead, millis() - firstByteMillis);
+    }
+
     if (stopSession && client->connected())
         client->stop();
 
     httpCode = response.httpCode;
+    retry_after = response.retryAfter;
 
     if (jsonPtr && payload.length() > 0 && !response.noContent)
     {
@@ -786,69 +1196,63 @@ bool GAuthManager::createJWT()
         sendTokenStatusCB();
 
         time_t now = getTime();
+        time_t exp = now + (config->signer.expiredSeconds > 3600 ? 3600 : config->signer.expiredSeconds);
 
-        initJson();
+        char iat[12], expStr[12];
+        snprintf(iat, sizeof(iat), "%lu", (unsigned long)now);
+        snprintf(expStr, sizeof(expStr), "%lu", (unsigned long)exp);
 
-        config->signer.tokens.jwt.clear();
+        const char *email = config->service_account.data.client_email.c_str();
+        size_t emailLen = strlen(email);
 
-        // header
-        // {"alg":"RS256","typ":"JWT"}
-        jsonPtr->add(pgm2Str(gauth_pgm_str_20 /* "alg" */), pgm2Str(gauth_pgm_str_21 /* "RS256" */));
-        jsonPtr->add(pgm2Str(gauth_pgm_str_22 /* "typ" */), pgm2Str(gauth_pgm_str_23 /* "JWT" */));
-
-        size_t len = Base64Helper::encodedLength(strlen(jsonPtr->raw()));
-        char *buf = MemoryHelper::createBuffer<char *>(mbfs, len);
-        Base64Helper::encodeUrl(mbfs, buf, (unsigned char *)jsonPtr->raw(), strlen(jsonPtr->raw()));
-        config->signer.encHeader = buf;
-        MemoryHelper::freeBuffer(mbfs, buf);
-        config->signer.encHeadPayload = config->signer.encHeader;
-
-        // payload
+        // The header is constant and the claims are templated, the JWT length is known before encoding
         // {"iss":"<email>","sub":"<email>","aud":"<audience>","iat":<timstamp>,"exp":<expire>,"scope":"<scope>"}
-        // {"iss":"<email>","sub":"<email>","aud":"<audience>","iat":<timstamp>,"exp":<expire>,"uid":"<uid>","claims":"<claims>"}
-        jsonPtr->clear();
-        jsonPtr->add(pgm2Str(gauth_pgm_str_24 /* "iss" */), config->service_account.data.client_email.c_str());
-        jsonPtr->add(pgm2Str(gauth_pgm_str_25 /* "sub" */), config->service_account.data.client_email.c_str());
-
-        MB_String t = gauth_pgm_str_26; // "https://"
-        HttpHelper::addGAPIsHost(t, gauth_pgm_str_27 /* "oauth2" */);
-        t += gauth_pgm_str_28; // "/"
-        t += gauth_pgm_str_29; // "token"
+        size_t headerLen = strlen_P(gauth_pgm_str_49);
+        size_t payloadLen = strlen_P(gauth_pgm_str_50) + emailLen + strlen_P(gauth_pgm_str_51) + emailLen +
+                            strlen_P(gauth_pgm_str_52) + strlen(iat) + strlen_P(gauth_pgm_str_53) + strlen(expStr) +
+                            strlen_P(gauth_pgm_str_54);
+        size_t len = headerLen + 1 + (payloadLen * 4 + 2) / 3 + 1 + Base64Helper::encodedLength(config->signer.signatureSize);
 
-        jsonPtr->add(pgm2Str(gauth_pgm_str_30 /* "aud" */), t.c_str());
-        jsonPtr->add(pgm2Str(gauth_pgm_str_31 /* "iat" */), (int)now);
+        // The header, payload and signature are encoded into the token buffer
+        config->signer.tokens.jwt.clear();
+        config->signer.tokens.jwt.reserve(len);
+        if (config->signer.tokens.jwt.bufferLength() < len)
+        {
+            setTokenError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_TOO_LESS_RAM);
+            sendTokenStatusCB();
+            return false;
+        }
 
-        if (config->signer.expiredSeconds > 3600)
-            jsonPtr->add(pgm2Str(gauth_pgm_str_32 /* "exp" */), (int)(now + 3600));
-        else
-            jsonPtr->add(pgm2Str(gauth_pgm_str_32 /* "exp" */), (int)(now + config->signer.expiredSeconds));
+        Base64Helper::UrlEncoder enc;
+        enc.out = &config->signer.tokens.jwt[0];
 
-        jsonPtr->add(pgm2Str(gauth_pgm_str_33 /* "scope" */), pgm2Str(gauth_pgm_str_34));
+        // create message digest from encoded header and payload while encoding
+        br_sha256_context mc;
+        br_sha256_init(&mc);
 
-        len = Base64Helper::encodedLength(strlen(jsonPtr->raw()));
-        buf = MemoryHelper::createBuffer<char *>(mbfs, len);
-        Base64Helper::encodeUrl(mbfs, buf, (unsigned char *)jsonPtr->raw(), strlen(jsonPtr->raw()));
-        config->signer.encPayload = buf;
-        MemoryHelper::freeBuffer(mbfs, buf);
+        memcpy_P(enc.out, gauth_pgm_str_49, headerLen);
+        enc.out[headerLen] = '.';
+        enc.pos = headerLen + 1;
+        br_sha256_update(&mc, enc.out, enc.pos);
 
-        config->signer.encHeadPayload += gauth_pgm_str_35; // "."
-        config->signer.encHeadPayload += config->signer.encPayload;
+        jwtAppendP(enc, mc, gauth_pgm_str_50); // {"iss":"
+        jwtAppend(enc, mc, email, emailLen);
+        jwtAppendP(enc, mc, gauth_pgm_str_51); // ","sub":"
+        jwtAppend(enc, mc, email, emailLen);
+        jwtAppendP(enc, mc, gauth_pgm_str_52); // ","aud":"https://oauth2.googleapis.com/token","iat":
+        jwtAppend(enc, mc, iat, strlen(iat));
+        jwtAppendP(enc, mc, gauth_pgm_str_53); // ,"exp":
+        jwtAppend(enc, mc, expStr, strlen(expStr));
+        jwtAppendP(enc, mc, gauth_pgm_str_54); // ,"scope":"<scope>"}
 
-        config->signer.encHeader.clear();
-        config->signer.encPayload.clear();
+        size_t n = enc.end();
+        br_sha256_update(&mc, enc.out + enc.pos - n, n);
 
-        // create message digest from encoded header and payload
         config->signer.hash = MemoryHelper::createBuffer<char *>(mbfs, config->signer.hashSize);
-        br_sha256_context mc;
-        br_sha256_init(&mc);
-        br_sha256_update(&mc, config->signer.encHeadPayload.c_str(), config->signer.encHeadPayload.length());
         br_sha256_out(&mc, config->signer.hash);
 
-        config->signer.tokens.jwt = config->signer.encHeadPayload;
-        config->signer.tokens.jwt += gauth_pgm_str_35; // "."
-        config->signer.encHeadPayload.clear();
-
-        freeJson();
+        enc.out[enc.pos++] = '.';
+        enc.out[enc.pos] = '\0';
     }
     else if (config->signer.step == gauth_jwt_generation_step_sign)
     {
@@ -858,7 +1262,9 @@ bool GAuthManager::createJWT()
         PrivateKey *pk = nullptr;
         Utils::idle();
         // parse priv key
-        if (config->signer.pk.length() > 0)
+        if (config->signer.der)
+            pk = new PrivateKey(config->signer.der, config->signer.derLen);
+        else if (config->signer.pk.length() > 0)
             pk = new PrivateKey((const char *)config->signer.pk.c_str());
         else if (strlen_P(config->service_account.data.private_key) > 0)
             pk = new PrivateKey((const char *)config->service_account.data.private_key);
@@ -884,7 +1290,7 @@ bool GAuthManager::createJWT()
         const br_rsa_private_key *br_rsa_key = pk->getRSA();
 
         // generate RSA signature from private key and message digest
-        config->signer.signature = new unsigned char[config->signer.signatureSize];
+        config->signer.signature = MemoryHelper::createBuffer<unsigned char *>(mbfs, config->signer.signatureSize);
 
         Utils::idle();
         int ret = br_rsa_i15_pkcs1_sign(BR_HASH_OID_SHA256, (const unsigned char *)config->signer.hash,
@@ -892,24 +1298,22 @@ bool GAuthManager::createJWT()
         Utils::idle();
         MemoryHelper::freeBuffer(mbfs, config->signer.hash);
 
-        size_t len = Base64Helper::encodedLength(config->signer.signatureSize);
-        char *buf = MemoryHelper::createBuffer<char *>(mbfs, len);
-        Base64Helper::encodeUrl(mbfs, buf, config->signer.signature, config->signer.signatureSize);
-        config->signer.encSignature = buf;
-        MemoryHelper::freeBuffer(mbfs, buf);
-        MemoryHelper::freeBuffer(mbfs, config->signer.signature);
         delete pk;
         pk = nullptr;
 
-        // get the signed JWT
+        // get the signed JWT, the signature is encoded into the space that was reserved with the header and payload
         if (ret > 0)
         {
-            config->signer.tokens.jwt += config->signer.encSignature;
+            size_t len = config->signer.tokens.jwt.length();
+            config->signer.tokens.jwt.reserve(len + Base64Helper::encodedLength(config->signer.signatureSize));
+            Base64Helper::encodeUrl(mbfs, &config->signer.tokens.jwt[len], config->signer.signature, config->signer.signatureSize);
+            MemoryHelper::freeBuffer(mbfs, config->signer.signature);
             config->signer.pk.clear();
-            config->signer.encSignature.clear();
+            freeDER();
         }
         else
         {
+            MemoryHelper::freeBuffer(mbfs, config->signer.signature);
             setTokenError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TOKEN_SIGN);
             config->signer.tokens.error.message.insert(0, (const char *)FPSTR("BearSSL, br_rsa_i15_pkcs1_sign: "));
             sendTokenStatusCB();
@@ -920,6 +1324,27 @@ bool GAuthManager::createJWT()
     return true;
 }
 
+void GAuthManager::jwtAppend(Base64Helper::UrlEncoder &enc, br_sha256_context &mc, const char *data, size_t len)
+{
+    size_t n = enc.write((const uint8_t *)data, len);
+    br_sha256_update(&mc, enc.out + enc.pos - n, n);
+}
+
+void GAuthManager::jwtAppendP(Base64Helper::UrlEncoder &enc, br_sha256_context &mc, PGM_P data)
+{
+    // Copy the flash string in small chunks, the flash may not be byte accessible
+    char buf[32];
+    size_t len = strlen_P(data);
+    while (len > 0)
+    {
+        size_t n = len < sizeof(buf) ? len : sizeof(buf);
+        memcpy_P(buf, data, n);
+        jwtAppend(enc, mc, buf, n);
+        data += n;
+        len -= n;
+    }
+}
+
 bool GAuthManager::initClient(PGM_P subDomain, gauth_auth_token_status status)
 {
 
@@ -936,15 +1361,28 @@ bool GAuthManager::initClient(PGM_P subDomain, gauth_auth_token_status status)
         sendTokenStatusCB();
     }
 
+    // When the current token is still valid, the new token is requested on its own connection
+    // to keep the Sheets API connection alive, the external clients can't be shared.
+    freeTokenClient();
+    if (tokenValid() && tcpClient->type() != esp_google_sheet_client_type_external_basic_client &&
+        tcpClient->type() != esp_google_sheet_client_type_external_gsm_client)
+    {
+        tokenClient = new GS_TCP_Client();
+        tokenClient->setConfig(config, mbfs);
+        tokenClient->setClock(mb_ts, mb_ts_offset);
+    }
+
+    GS_TCP_Client *client = authClient();
+
     // stop the TCP session
-    tcpClient->stop();
+    client->stop();
 
-    tcpClient->setCACert(nullptr);
+    client->setCACert(nullptr);
 
-    if (!reconnect(tcpClient))
+    if (!reconnect(client))
         return false;
 
-    tcpClient->setBufferSizes(2048, 1024);
+    client->setBufferSizes(2048, 1024);
 
     initJson();
 
@@ -952,11 +1390,11 @@ bool GAuthManager::initClient(PGM_P subDomain, gauth_auth_token_status status)
     HttpHelper::addGAPIsHost(host, subDomain);
 
     Utils::idle();
-    tcpClient->begin(host.c_str(), 443, &response_code);
+    client->begin(host.c_str(), 443, &response_code);
 
     time_t now = getTime();
 
-    tcpClient->setX509Time(now);
+    client->setX509Time(now);
 
     return true;
 }
@@ -1010,7 +1448,7 @@ bool GAuthManager::requestTokens(bool refresh)
 
     req += jsonPtr->raw();
 
-    tcpClient->send(req.c_str());
+    authClient()->send(req.c_str());
 
     req.clear();
 
@@ -1021,7 +1459,7 @@ bool GAuthManager::requestTokens(bool refresh)
 
     int httpCode = ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_REQUEST_TIMEOUT;
     MB_String payload;
-    if (handleResponse(tcpClient, httpCode, payload))
+    if (handleResponse(authClient(), httpCode, payload))
     {
 
         config->signer.tokens.jwt.clear();
@@ -1060,7 +1498,10 @@ bool GAuthManager::requestTokens(bool refresh)
         {
 
             if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_44 /* "access_token" */))
+            {
                 config->internal.auth_token = resultPtr->to<const char *>();
+                config->internal.auth_token_version++;
+            }
 
             if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_19 /* "expires_in" */))
                 getExpiration(resultPtr->to<const char *>());
@@ -1079,6 +1520,10 @@ void GAuthManager::getExpiration(const char *exp)
     unsigned long ms = millis();
     config->signer.tokens.expires = now + atoi(exp);
     config->signer.tokens.last_millis = ms;
+
+    // Start the next refresh at random time (up to half of pre-refresh seconds) earlier
+    // to spread the token requests from many devices.
+    config->signer.tokens.jitter = random(config->signer.preRefreshSeconds / 2 + 1);
 }
 
 void GAuthManager::checkToken()
@@ -1090,18 +1535,21 @@ void GAuthManager::checkToken()
         handleToken();
 }
 
-bool GAuthManager::tokenReady()
+bool GAuthManager::tokenReady(bool background)
 {
     if (!config)
         return false;
 
-    checkToken();
+    // The token is refreshed in background (from ready() in loop) before it expires,
+    // the requests keep using the current token until the new token was received.
+    if (background || !tokenValid())
+        checkToken();
 
     // call checkToken to send callback before checking connection.
     if (!reconnect())
         return false;
 
-    return config->signer.tokens.status == token_status_ready;
+    return config->signer.tokens.status == token_status_ready || tokenValid();
 };
 
 String GAuthManager::getTokenType(TokenInfo info)
@@ -1189,6 +1637,7 @@ void GAuthManager::reset()
         config->internal.client_id.clear();
         config->internal.client_secret.clear();
         config->internal.auth_token.clear();
+        config->internal.auth_token_version++;
         config->internal.refresh_token.clear();
         config->signer.lastReqMillis = 0;
         config->internal.last_jwt_generation_error_cb_millis = 0;
@@ -1235,7 +1684,7 @@ unsigned long GAuthManager::getExpiredTimestamp()
     return config->signer.tokens.expires;
 }
 
-bool GAuthManager::reconnect(GS_TCP_Client *client, unsigned long dataTime)
+bool GAuthManager::reconnect(GS_TCP_Client *client, unsigned long dataTime, unsigned long timeout)
 {
     if (!client)
         return false;
@@ -1247,10 +1696,12 @@ bool GAuthManager::reconnect(GS_TCP_Client *client, unsigned long dataTime)
             config->timeout.serverResponse > ESP_GOOGLE_SHEET_CLIENT_MAX_SERVER_RESPONSE_TIMEOUT)
             config->timeout.serverResponse = ESP_GOOGLE_SHEET_CLIENT_DEFAULT_SERVER_RESPONSE_TIMEOUT;
 
-        tmo = config->timeout.serverResponse;
+        // The adaptive timeout was already clamped to the user floor and ceiling
+        tmo = timeout > 0 ? timeout : config->timeout.serverResponse;
 
         if (millis() - dataTime > tmo)
         {
+            GS_TRACE_INSTANT(esp_google_sheet_trace_event_response_timeout, millis() - dataTime);
             response_code = ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
             return false;
         }
@@ -1280,6 +1731,9 @@ bool GAuthManager::reconnect(GS_TCP_Client *client, unsigned long dataTime)
                 }
                 client->networkReconnect();
                 config->internal.last_reconnect_millis = millis();
+
+                if (config->metrics)
+                    config->metrics->reconnects++;
             }
         }
 
@@ -1463,6 +1917,9 @@ void GAuthManager::errorToString(int httpCode, MB_String &buff)
     case ESP_GOOGLE_SHEET_CLIENT_ERROR_SERVICE_ACCOUNT_JSON_FILE_PARSING_ERROR:
         buff += F("Unable to parse Service Account JSON file. Please check file name, storage type and its content.");
         return;
+    case ESP_GOOGLE_SHEET_CLIENT_ERROR_RATE_LIMIT_EXCEEDED:
+        buff += F("request dropped by rate limiter");
+        return;
     default:
         buff += F("unknown error");
         return;
@@ -32,6 +32,8 @@ public:
 
 private:
     GS_TCP_Client *tcpClient = nullptr;
+    /* the client that used for token request while the current token is still valid */
+    GS_TCP_Client *tokenClient = nullptr;
     bool localTCPClient = false;
     esp_google_sheet_auth_cfg_t *config = nullptr;
     MB_FS *mbfs = nullptr;
@@ -46,6 +48,8 @@ private:
     FirebaseJson *jsonPtr = nullptr;
     FirebaseJsonData *resultPtr = nullptr;
     int response_code = 0;
+    /* the Retry-After seconds of the last response */
+    int retry_after = 0;
     time_t ts = 0;
     bool autoReconnectWiFi = true;
     unsigned long last_reconnect_millis = 0;
@@ -66,14 +70,34 @@ private:
     void end();
     void newClient(GS_TCP_Client **client);
     void freeClient(GS_TCP_Client **client);
+    /* get the client for token request */
+    GS_TCP_Client *authClient();
+    void freeTokenClient();
     /* parse service account json file for private key */
     bool parseSAFile();
+    /* read the service account json file, collect the credentials when parse is true */
+    bool readSAFile(struct gauth_sa_file_reader_t &reader, bool parse);
+    /* the streaming tokenizer of the service account json file */
+    int saRead(struct gauth_sa_file_reader_t &reader);
+    int saSkipSpace(struct gauth_sa_file_reader_t &reader);
+    bool saReadString(struct gauth_sa_file_reader_t &reader, MB_String *out);
+    bool saSkipValue(struct gauth_sa_file_reader_t &reader, int c);
+    MB_String *saField(const MB_String &key, MB_String &type);
+    /* load or save the parsed credentials and DER private key of the service account json file */
+    bool loadKeyCache(uint32_t size, uint32_t crc);
+    bool readKeyCacheString(mbfs_file_type type, MB_String &out);
+    void saveKeyCache(uint32_t size, uint32_t crc);
+    bool writeKeyCacheString(mbfs_file_type type, const MB_String &str);
     /* clear service account credentials */
     void clearServiceAccountCreds();
+    /* free the DER private key */
+    void freeDER();
     /* check for sevice account credentials */
     bool serviceAccountCredsReady();
     /* check for time is up or expiry time was reset or unset? */
     bool isExpired();
+    /* check whether the current token can be used while the new token is requesting */
+    bool tokenValid();
     /* Adjust the expiry time if system time synched or set. Adjust pre-refresh seconds to not exceed */
     void adjustTime(time_t &now);
     /* auth token was never been request or the last request was timed out */
@@ -102,10 +126,16 @@ private:
     bool handleResponse(GS_TCP_Client *client, int &httpCode, MB_String &payload, bool stopSession = true);
     /* Get time */
     void tryGetTime();
+    /* Get time from the Date header of the token server response */
+    bool requestTime();
     /* process the tokens (generation, signing, request and refresh) */
     void tokenProcessingTask();
     /* encode and sign the JWT token */
     bool createJWT();
+    /* base64url encode the JWT data into the token buffer and update the message digest */
+    void jwtAppend(Base64Helper::UrlEncoder &enc, br_sha256_context &mc, const char *data, size_t len);
+    /* base64url encode the JWT flash string into the token buffer and update the message digest */
+    void jwtAppendP(Base64Helper::UrlEncoder &enc, br_sha256_context &mc, PGM_P data);
     /* request or refresh the token */
     bool requestTokens(bool refresh);
     /* check the token ready status and process the token tasks */
@@ -115,7 +145,7 @@ private:
     /* return error string from code */
     void errorToString(int httpCode, MB_String &buff);
     /* check the token ready status and process the token tasks and returns the status */
-    bool tokenReady();
+    bool tokenReady(bool background = false);
     /* error status callback */
     void sendTokenStatusCB();
     /* prepare or initialize the external/internal TCP client */
@@ -137,7 +167,7 @@ private:
     void refresh();
     String getTokenError();
     unsigned long getExpiredTimestamp();
-    bool reconnect(GS_TCP_Client *client, unsigned long dataTime = 0);
+    bool reconnect(GS_TCP_Client *client, unsigned long dataTime = 0, unsigned long timeout = 0);
     bool reconnect();
 
 #if defined(ESP8266)
@@ -60,6 +60,9 @@ public:
     if (_tcp_client)
       delete (ESP_SSLClient *)_tcp_client;
     _tcp_client = nullptr;
+    if (_send_buf)
+      free(_send_buf);
+    _send_buf = nullptr;
   }
 
   /**
@@ -304,6 +307,10 @@ public:
 #if defined(INC_ENC28J60_LWIP) || defined(INC_W5100_LWIP) || defined(INC_W5500_LWIP)
   ex:
 #if defined(ESP_GOOGLE_SHEET_CLIENT_WIFI_IS_AVAILABLE)
+    // The lookup is not needed when the host address was cached
+    if (dnsLookup(host))
+      return;
+
     BASE_WIFICLIENT _client;
     _client.connect(host, port);
     _client.stop();
@@ -521,10 +528,36 @@ public:
       }
     }
 
+    unsigned long us = micros();
+    GS_TRACE_BEGIN(esp_google_sheet_trace_event_connect, _port);
+
+    esp_google_sheet_host_timing_t *ht = hostTiming();
+    if (ht)
+      setConnectTimeout(TimeoutHelper::timeout(_config->adaptive, ht->connect, _config->timeout.socketConnection));
+
     _tcp_client->setClient(_basic_client);
     _tcp_client->setDebugLevel(2);
-    if (!_tcp_client->connect(_host.c_str(), _port))
+
+    IPAddress ip;
+    int dns = resolveHost(ip);
+    bool ok = dns > 0 && connectIP(ip);
+
+    // The cached address may be stale, resolve it again by the host name connection
+    if (dns > 0 && !ok)
+      dnsRemove(_host.c_str());
+
+    if (!ok && dns > -1)
+      ok = _tcp_client->connect(_host.c_str(), _port);
+
+    if (!ok)
+    {
+      if (ht)
+        TimeoutHelper::backoff(ht->connect);
+      if (_config)
+        _config->timing.connect += micros() - us;
+      GS_TRACE_END(esp_google_sheet_trace_event_connect, ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_CONNECTION_REFUSED);
       return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_CONNECTION_REFUSED);
+    }
 
 #if defined(ESP_GOOGLE_SHEET_CLIENT_WIFI_IS_AVAILABLE) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
     if (_client_type == esp_google_sheet_client_type_internal_basic_client)
@@ -570,10 +603,65 @@ public:
 
     if (!ret)
       stop();
+    else
+      _last_activity_ms = millis();
+
+    if (ret && ht)
+      TimeoutHelper::update(ht->connect, (micros() - us) / 1000);
+
+    if (_config)
+      _config->timing.connect += micros() - us;
+
+    GS_TRACE_END(esp_google_sheet_trace_event_connect, ret);
 
     return ret;
   }
 
+  /**
+   * Get the adaptive timeout estimates of the current host.
+   * @return The estimates or nullptr when the adaptive timeout was disabled.
+   */
+  esp_google_sheet_host_timing_t *hostTiming()
+  {
+    return _config ? TimeoutHelper::host(_config->adaptive, _host.c_str()) : nullptr;
+  }
+
+  /**
+   * Get the time since the connection was last used.
+   * @return The idle time in ms.
+   */
+  unsigned long idleMillis() { return millis() - _last_activity_ms; }
+
+  /**
+   * Check the kept alive connection before sending the request.
+   * @return true when the connection was closed or half-closed by the server, or was idle for longer than the server idle timeout.
+   */
+  bool stale()
+  {
+    if (!connected())
+      return true;
+
+    // No data is expected between the requests, it can be the TLS close_notify alert of the server that is closing
+    if (_tcp_client->available() > 0)
+      return true;
+
+    return _config && _config->timeout.serverIdle > 0 && idleMillis() >= _config->timeout.serverIdle;
+  }
+
+  /**
+   * Reconnect to the same host before the server closes the idle connection.
+   * @return true when the connection was renewed.
+   */
+  bool renew()
+  {
+    stop();
+
+    // The failed attempt is also counted as activity, the next attempt waits for another idle period
+    _last_activity_ms = millis();
+
+    return networkReady() && connect();
+  }
+
   /**
    * Stop TCP connection.
    */
@@ -607,6 +695,9 @@ public:
     if (!_tcp_client->connected() && !connect())
       return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_CONNECTION_REFUSED);
 
+    // The connect time was counted separately
+    unsigned long us = micros();
+
     int toSend = _chunkSize;
     int sent = 0;
     while (sent < (int)size)
@@ -614,13 +705,13 @@ public:
       if (sent + toSend > (int)size)
         toSend = size - sent;
 
-      if ((int)_tcp_client->write(data + sent, toSend) != toSend)
+      if (!writeChunk(data + sent, toSend))
         return ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_SEND_REQUEST_FAILED;
 
       sent += toSend;
     }
 
-    setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_OK);
+    sendComplete(us, size);
 
     return size;
   }
@@ -639,6 +730,81 @@ public:
    */
   int send(const char *data) { return write((uint8_t *)data, strlen(data)); }
 
+  /**
+   * The TCP data scatter-gather send function.
+   * @param parts The data parts to send in order, the null or empty parts are skipped.
+   * @param count The number of parts.
+   * @return The total size of data that was successfully sent or negative value for error.
+   *
+   * The parts are gathered into the chunk size buffer and written as one stream on the same connection,
+   * the request is failed and the connection is closed when any write was short.
+   */
+  int send(const char *const parts[], size_t count)
+  {
+    if (!_tcp_client)
+      return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_CLIENT_NOT_INITIALIZED);
+
+    size_t size = 0;
+    for (size_t i = 0; i < count; i++)
+      size += parts[i] ? strlen(parts[i]) : 0;
+
+    if (size == 0)
+      return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_SEND_REQUEST_FAILED);
+
+    if (!networkReady())
+      return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_NOT_CONNECTED);
+
+    // The connection is checked once, the parts are never sent on the different connections
+    if (!_tcp_client->connected() && !connect())
+      return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_CONNECTION_REFUSED);
+
+    unsigned long us = micros();
+
+    // The buffer is kept for the next requests
+    if (!_send_buf)
+      _send_buf = (uint8_t *)malloc(_chunkSize);
+
+    uint8_t *buf = _send_buf;
+    if (!buf)
+      return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_SEND_REQUEST_FAILED);
+
+    bool ok = true;
+    int len = 0;
+    for (size_t i = 0; ok && i < count; i++)
+    {
+      const char *p = parts[i];
+      size_t n = p ? strlen(p) : 0;
+      while (ok && n > 0)
+      {
+        int toCopy = n < (size_t)(_chunkSize - len) ? (int)n : _chunkSize - len;
+        memcpy(buf + len, p, toCopy);
+        len += toCopy;
+        p += toCopy;
+        n -= toCopy;
+
+        if (len == _chunkSize)
+        {
+          ok = writeChunk(buf, len);
+          len = 0;
+        }
+      }
+    }
+
+    if (ok && len > 0)
+      ok = writeChunk(buf, len);
+
+    if (!ok)
+    {
+      // The partial request can not be completed on this or the new connection
+      _tcp_client->stop();
+      return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_SEND_REQUEST_FAILED);
+    }
+
+    sendComplete(us, size);
+
+    return size;
+  }
+
   /**
    * The TCP data print function.
    * @param data The data to print.
@@ -707,7 +873,10 @@ public:
     if (!_basic_client)
       return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_CLIENT_NOT_INITIALIZED);
 
-    return _tcp_client->read();
+    int ret = _tcp_client->read();
+    if (ret > -1)
+      _last_activity_ms = millis();
+    return ret;
   }
 
   int read(uint8_t *buf, size_t len)
@@ -726,7 +895,10 @@ public:
     if (!_basic_client)
       return setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_CLIENT_NOT_INITIALIZED);
 
-    return _tcp_client->read(buf, len);
+    int ret = _tcp_client->read(buf, len);
+    if (ret > 0)
+      _last_activity_ms = millis();
+    return ret;
   }
 
   /**
@@ -804,6 +976,13 @@ public:
     _clock_ready = status;
   }
 
+  // Share the library clock, the time base of the auth manager
+  void setClock(uint32_t *mb_ts, uint32_t *mb_ts_offset)
+  {
+    _mb_ts = mb_ts;
+    _mb_ts_offset = mb_ts_offset;
+  }
+
   void setCertType(esp_google_sheet_cert_type type) { _cert_type = type; }
 
   esp_google_sheet_cert_type getCertType() { return _cert_type; }
@@ -965,6 +1144,170 @@ public:
   }
 
 private:
+  // Write the chunk to the client, the short write is failed
+  bool writeChunk(const uint8_t *data, int len)
+  {
+    GS_TRACE_BEGIN(esp_google_sheet_trace_event_send_chunk, len);
+
+    if ((int)_tcp_client->write(data, len) != len)
+    {
+      GS_TRACE_END(esp_google_sheet_trace_event_send_chunk, ESP_GOOGLE_SHEET_CLIENT_ERROR_TCP_ERROR_SEND_REQUEST_FAILED);
+      return false;
+    }
+
+    GS_TRACE_END(esp_google_sheet_trace_event_send_chunk, len);
+    return true;
+  }
+
+  void sendComplete(unsigned long us, size_t size)
+  {
+    if (_config)
+    {
+      _config->timing.send += micros() - us;
+      _config->timing.bytesSent += size;
+    }
+
+    _last_activity_ms = millis();
+
+    setError(ESP_GOOGLE_SHEET_CLIENT_ERROR_HTTP_CODE_OK);
+  }
+
+  DNSCache *dnsCache()
+  {
+    return _config->dns.cache ? _config->dns.cache : &_config->dns.local;
+  }
+
+  // The seconds of the library clock when it was set or of the uptime
+  uint32_t dnsNow(bool &epoch)
+  {
+    uint32_t now = _mb_ts && _mb_ts_offset ? TimeHelper::getTime(_mb_ts, _mb_ts_offset) : 0;
+    epoch = now > ESP_GOOGLE_SHEET_CLIENT_DEFAULT_TS;
+    return epoch ? now : millis() / 1000;
+  }
+
+  /**
+   * Get the unexpired DNS cache entry of the host.
+   * @param host The host name.
+   * @return The entry or nullptr when it was not cached or expired.
+   */
+  esp_google_sheet_dns_entry_t *dnsLookup(const char *host)
+  {
+    if (!_config || _config->dns.ttl == 0)
+      return nullptr;
+
+    bool epoch = false;
+    uint32_t now = dnsNow(epoch);
+    DNSCache *cache = dnsCache();
+
+    for (size_t i = 0; i < ESP_GOOGLE_SHEET_CLIENT_DNS_CACHE_SIZE; i++)
+    {
+      esp_google_sheet_dns_entry_t *entry = &cache->entries[i];
+      // The entry of the other time base (before the clock was set or after reset) is expired
+      if (strcmp(entry->host, host) == 0)
+        return entry->epoch == epoch && now < entry->expires ? entry : nullptr;
+    }
+
+    return nullptr;
+  }
+
+  /**
+   * Add or update the DNS cache entry of the host.
+   * @param host The host name.
+   * @param ip The resolved address or 0 for the failed lookup.
+   */
+  void dnsStore(const char *host, uint32_t ip)
+  {
+    bool epoch = false;
+    uint32_t now = dnsNow(epoch);
+    DNSCache *cache = dnsCache();
+
+    // Reuse the entry of the same host, otherwise the empty or the earliest expiring entry
+    esp_google_sheet_dns_entry_t *entry = &cache->entries[0];
+    for (size_t i = 0; i < ESP_GOOGLE_SHEET_CLIENT_DNS_CACHE_SIZE; i++)
+    {
+      if (strcmp(cache->entries[i].host, host) == 0)
+      {
+        entry = &cache->entries[i];
+        break;
+      }
+
+      if (cache->entries[i].host[0] == 0 || cache->entries[i].expires < entry->expires)
+        entry = &cache->entries[i];
+    }
+
+    strcpy(entry->host, host);
+    entry->ip = ip;
+    entry->epoch = epoch;
+    entry->expires = now + (ip ? _config->dns.ttl : _config->dns.negativeTtl);
+  }
+
+  void dnsRemove(const char *host)
+  {
+    esp_google_sheet_dns_entry_t *entry = dnsLookup(host);
+    if (entry)
+      memset(entry, 0, sizeof(esp_google_sheet_dns_entry_t));
+  }
+
+  /**
+   * Get the host address from the DNS cache or resolve and cache it.
+   * @param ip The address result.
+   * @return 1 for the address, -1 for the failed lookup or 0 when the cache was not used.
+   */
+  int resolveHost(IPAddress &ip)
+  {
+#if defined(ESP_GOOGLE_SHEET_CLIENT_WIFI_IS_AVAILABLE)
+    // The external clients may have their own network stack and resolver
+    if (!_config || _config->dns.ttl == 0 || _client_type != esp_google_sheet_client_type_internal_basic_client ||
+        _host.length() >= ESP_GOOGLE_SHEET_CLIENT_DNS_HOST_LENGTH)
+      return 0;
+
+    esp_google_sheet_dns_entry_t *entry = dnsLookup(_host.c_str());
+    if (entry)
+    {
+      if (entry->ip == 0)
+        return -1;
+      ip = IPAddress(entry->ip);
+      return 1;
+    }
+
+    bool ok = hostByName(_host.c_str(), ip) == 1 && validIP(ip);
+    dnsStore(_host.c_str(), ok ? (uint32_t)ip : 0);
+    return ok ? 1 : -1;
+#else
+    return 0;
+#endif
+  }
+
+  // Set the TCP connect timeout of the internal client, the external clients have their own
+  void setConnectTimeout(unsigned long ms)
+  {
+#if defined(ESP_GOOGLE_SHEET_CLIENT_WIFI_IS_AVAILABLE)
+    if (_client_type != esp_google_sheet_client_type_internal_basic_client)
+      return;
+#if defined(ESP32) && (!defined(ESP_ARDUINO_VERSION_MAJOR) || ESP_ARDUINO_VERSION_MAJOR < 3)
+    // The arduino-esp32 2.x WiFiClient timeout is in seconds
+    reinterpret_cast<BASE_WIFICLIENT *>(_basic_client)->setTimeout((ms + 999) / 1000);
+#else
+    _basic_client->setTimeout(ms);
+#endif
+#endif
+  }
+
+  // Connect by the address, the host name is still used for the SNI and certificate verification
+  bool connectIP(IPAddress ip)
+  {
+    if (!_basic_client->connect(ip, _port))
+      return false;
+
+    if (!_tcp_client->connectSSL(_host.c_str(), _port))
+    {
+      _basic_client->stop();
+      return false;
+    }
+
+    return true;
+  }
+
   // lwIP TCP Keepalive idle in seconds.
   int _tcpKeepIdleSeconds = -1;
   // lwIP TCP Keepalive interval in seconds.
@@ -995,7 +1338,12 @@ private:
   void *_modem = nullptr;
 #endif
   int _chunkSize = 1024;
+  // The scatter-gather send buffer of _chunkSize bytes
+  uint8_t *_send_buf = nullptr;
+  unsigned long _last_activity_ms = 0;
   bool _clock_ready = false;
+  uint32_t *_mb_ts = nullptr;
+  uint32_t *_mb_ts_offset = nullptr;
   int _last_error = 0;
   volatile bool _network_status = false;
   int _rx_size = 1024, _tx_size = 512;
@@ -70,8 +70,11 @@ void FirebaseJsonBase::mCopy(FirebaseJsonBase &other)
     this->httpCode = other.httpCode;
     this->serData = other.serData;
     this->root_type = other.root_type;
-    this->iterator_data = other.iterator_data;
     this->buf = other.buf;
+
+    // The iterator results refer to the nodes of the other tree, collect them again from the copy
+    if (other.iterator_data.result.size() > 0)
+        mIteratorBegin(root);
 }
 
 bool FirebaseJsonBase::setRaw(const char *raw)
@@ -169,6 +172,7 @@ MB_JSON *FirebaseJsonBase::getElement(MB_JSON *parent, const char *key, struct s
 
 void FirebaseJsonBase::mAdd(MB_VECTOR<MB_String> keys, MB_JSON **parent, int beginIndex, MB_JSON *value)
 {
+    mIteratorEnd(false);
     MB_JSON *m_parent = *parent;
 
     for (size_t i = beginIndex; i < keys.size(); i++)
@@ -345,13 +349,9 @@ void FirebaseJsonBase::replace(MB_VECTOR<MB_String> &keys, struct search_result_
 size_t FirebaseJsonBase::mIteratorBegin(MB_JSON *parent)
 {
     mIteratorEnd();
-    char *p = MB_JSON_PrintUnformatted(parent);
-    if (p == NULL)
+    if (parent == NULL)
         return 0;
 
-    buf = p;
-    MB_JSON_free(p);
-    iterator_data.buf_size = buf.length();
     int index = -1;
     mIterate(parent, index);
     return iterator_data.result.size();
@@ -375,8 +375,6 @@ void FirebaseJsonBase::mIteratorEnd(bool clearBuf)
     if (clearBuf)
         buf.clear();
     iterator_data.path.clear();
-    iterator_data.buf_size = 0;
-    iterator_data.buf_offset = 0;
     iterator_data.result.clear();
     iterator_data.depth = -1;
     iterator_data._depth = 0;
@@ -403,7 +401,7 @@ void FirebaseJsonBase::mIterate(MB_JSON *parent, int &arrIndex)
         {
 
             if (isArray(e) || isObject(e))
-                mCollectIterator(e, e->string ? JSON_OBJECT : JSON_ARRAY, arrIndex);
+                mCollectIterator(e, e->string ? JSON_OBJECT : JSON_ARRAY);
 
             if (isArray(e))
             {
@@ -419,7 +417,7 @@ void FirebaseJsonBase::mIterate(MB_JSON *parent, int &arrIndex)
                         if (isArray(item) || isObject(item))
                             mIterate(item, _arrIndex);
                         else
-                            mCollectIterator(item, item->string ? JSON_OBJECT : JSON_ARRAY, _arrIndex);
+                            mCollectIterator(item, item->string ? JSON_OBJECT : JSON_ARRAY);
                         item = item->next;
                         _arrIndex++;
                     }
@@ -428,7 +426,7 @@ void FirebaseJsonBase::mIterate(MB_JSON *parent, int &arrIndex)
             else if (isObject(e))
                 mIterate(e, arrIndex);
             else
-                mCollectIterator(e, e->string ? JSON_OBJECT : JSON_ARRAY, arrIndex);
+                mCollectIterator(e, e->string ? JSON_OBJECT : JSON_ARRAY);
 
             e = e->next;
 
@@ -438,37 +436,10 @@ void FirebaseJsonBase::mIterate(MB_JSON *parent, int &arrIndex)
     }
 }
 
-void FirebaseJsonBase::mCollectIterator(MB_JSON *e, int type, int &arrIndex)
+void FirebaseJsonBase::mCollectIterator(MB_JSON *e, int type)
 {
     struct iterator_result_t result;
-
-    if (e->string)
-    {
-        size_t pos = buf.find((const char *)e->string, iterator_data.buf_offset);
-        if (pos != MB_String::npos)
-        {
-            result.ofs1 = pos;
-            result.len1 = strlen(e->string);
-            iterator_data.buf_offset = (e->type != MB_JSON_Object && e->type != MB_JSON_Array) ? pos + result.len1 : pos;
-        }
-    }
-
-    char *p = MB_JSON_PrintUnformatted(e);
-    if (p)
-    {
-        if (result.ofs1 == 0)
-            result.ofs1 = iterator_data.buf_offset;
-
-        int i = iterator_data.buf_offset;
-        size_t pos = buf.find(p, i);
-        if (pos != MB_String::npos)
-        {
-            result.ofs2 = pos - result.ofs1 - result.len1;
-            result.len2 = strlen(p);
-            MB_JSON_free(p);
-            iterator_data.buf_offset = (e->type != MB_JSON_Object && e->type != MB_JSON_Array) ? pos + result.len2 : pos;
-        }
-    }
+    result.node = e;
     result.type = type;
     result.depth = iterator_data.depth;
     iterator_data.result.push_back(result);
@@ -478,48 +449,34 @@ int FirebaseJsonBase::mIteratorGet(size_t index, int &type, String &key, String
 {
     key.remove(0, key.length());
     value.remove(0, value.length());
-    int depth = -1;
 
-    if (buf.length() == iterator_data.buf_size)
-    {
-        if (index > iterator_data.result.size() - 1)
-            return depth;
+    if (index >= iterator_data.result.size())
+        return -1;
 
-        if (iterator_data.result[index].len1 > 0)
-        {
-            char *m_key = (char *)newP(iterator_data.result[index].len1 + 1);
-            if (m_key)
-            {
-                memset(m_key, 0, iterator_data.result[index].len1 + 1);
-                strncpy(m_key, &buf[iterator_data.result[index].ofs1], iterator_data.result[index].len1);
-                key = m_key;
-                delP(&m_key);
-            }
-        }
-
-        char *m_val = (char *)newP(iterator_data.result[index].len2 + 1);
-        if (m_val)
-        {
-            memset(m_val, 0, iterator_data.result[index].len2 + 1);
-            int ofs = iterator_data.result[index].ofs1 + iterator_data.result[index].len1 + iterator_data.result[index].ofs2;
-            int len = iterator_data.result[index].len2;
+    MB_JSON *e = iterator_data.result[index].node;
 
-            if (iterator_data.result[index].type == JSON_STRING)
-            {
-                if (buf[ofs] == '"')
-                    ofs++;
-                if (buf[ofs + len - 1] == '"')
-                    len--;
-            }
+    if (e->string)
+        key = e->string;
 
-            strncpy(m_val, &buf[ofs], len);
-            value = m_val;
-            delP(&m_val);
+    if (MB_JSON_IsNumber(e))
+    {
+        // The number is short, print it without the heap buffer
+        char num[32];
+        if (MB_JSON_PrintPreallocated(e, num, sizeof(num), false))
+            value = num;
+    }
+    else
+    {
+        char *p = MB_JSON_PrintUnformatted(e);
+        if (p)
+        {
+            value = p;
+            MB_JSON_free(p);
         }
-        type = iterator_data.result[index].type;
-        depth = iterator_data.result[index].depth;
     }
-    return depth;
+
+    type = iterator_data.result[index].type;
+    return iterator_data.result[index].depth;
 }
 
 struct FirebaseJsonBase::fb_js_iterator_value_t FirebaseJsonBase::mValueAt(size_t index)
@@ -596,6 +553,7 @@ const char *FirebaseJsonBase::mRaw()
 
 bool FirebaseJsonBase::mRemove(const char *path)
 {
+    mIteratorEnd(false);
     bool ret = false;
     prepareRoot();
     MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
@@ -840,6 +798,7 @@ void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result)
 
 void FirebaseJsonBase::mSet(const char *path, MB_JSON *value)
 {
+    mIteratorEnd(false);
     prepareRoot();
     MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
     makeList(path, keys, '/');
@@ -993,6 +952,7 @@ bool FirebaseJsonArray::mGetIdx(FirebaseJsonData *result, int index, bool pretti
 
 bool FirebaseJsonArray::mSetIdx(int index, MB_JSON *value)
 {
+    mIteratorEnd(false);
     if (root_type != Root_Type_JSONArray)
         mClear();
 
@@ -1017,6 +977,7 @@ bool FirebaseJsonArray::mSetIdx(int index, MB_JSON *value)
 
 bool FirebaseJsonArray::mRemoveIdx(int index)
 {
+    mIteratorEnd(false);
     int size = MB_JSON_GetArraySize(root);
     if (index < size)
     {
@@ -1107,7 +1068,7 @@ void FirebaseJsonData::delP(void *ptr)
     void **p = (void **)ptr;
     if (*p)
     {
-        free(*p);
+        free(MB_Heap::untrack(*p));
         *p = 0;
     }
 }
@@ -1118,9 +1079,9 @@ void *FirebaseJsonData::newP(size_t len)
     size_t newLen = getReservedLen(len);
 #if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
     if (ESP.getPsramSize() > 0)
-        p = (void *)ps_malloc(newLen);
+        p = (void *)ps_malloc(newLen + MB_HEAP_HEADER_SIZE);
     else
-        p = (void *)malloc(newLen);
+        p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
     if (!p)
         return NULL;
 
@@ -1130,7 +1091,7 @@ void *FirebaseJsonData::newP(size_t len)
     ESP.setExternalHeap();
 #endif
 
-    p = (void *)malloc(newLen);
+    p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
     bool nn = p ? true : false;
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
@@ -1141,6 +1102,7 @@ void *FirebaseJsonData::newP(size_t len)
         return NULL;
 
 #endif
+    p = MB_Heap::track(p, newLen, mb_heap_scope_json);
     memset(p, 0, newLen);
     return p;
 }
@@ -219,9 +219,9 @@ static void *fb_js_malloc(size_t len)
 
 #if defined(BOARD_HAS_PSRAM) 
     if (ESP.getPsramSize() > 0)
-        p = (void *)ps_malloc(newLen);
+        p = (void *)ps_malloc(newLen + MB_HEAP_HEADER_SIZE);
     else
-        p = (void *)malloc(newLen);
+        p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
     if (!p)
         return NULL;
 #else
@@ -230,7 +230,7 @@ static void *fb_js_malloc(size_t len)
     ESP.setExternalHeap();
 #endif
 
-    p = (void *)malloc(newLen);
+    p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
     bool nn = p ? true : false;
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
@@ -240,13 +240,13 @@ static void *fb_js_malloc(size_t len)
     if (!nn)
         return NULL;
 #endif
-    return p;
+    return MB_Heap::track(p, newLen, mb_heap_scope_json);
 }
 
 static void fb_js_free(void *ptr)
 {
     if (ptr)
-        free(ptr);
+        free(MB_Heap::untrack(ptr));
 }
 
 static void *fb_js_realloc(void *ptr, size_t sz)
@@ -254,16 +254,16 @@ static void *fb_js_realloc(void *ptr, size_t sz)
     size_t newLen = getReservedLen(sz);
 #if defined(BOARD_HAS_PSRAM)
     if (ESP.getPsramSize() > 0)
-        ptr = (void *)ps_realloc(ptr, newLen);
+        ptr = MB_Heap::retrack(ptr, ps_realloc(MB_Heap::raw(ptr), newLen + MB_HEAP_HEADER_SIZE), newLen, mb_heap_scope_json);
     else
-        ptr = (void *)realloc(ptr, newLen);
+        ptr = MB_Heap::retrack(ptr, realloc(MB_Heap::raw(ptr), newLen + MB_HEAP_HEADER_SIZE), newLen, mb_heap_scope_json);
 #else
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
     ESP.setExternalHeap();
 #endif
 
-    ptr = (void *)realloc(ptr, newLen);
+    ptr = MB_Heap::retrack(ptr, realloc(MB_Heap::raw(ptr), newLen + MB_HEAP_HEADER_SIZE), newLen, mb_heap_scope_json);
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
     ESP.resetHeap();
@@ -343,7 +343,7 @@ public:
     template <typename T>
     bool getArray(T source, FirebaseJsonArray &jsonArray)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGetArray(getStr(source, addr), jsonArray);
         delAddr(addr);
         return ret;
@@ -370,7 +370,7 @@ public:
     template <typename T>
     bool getJSON(T source, FirebaseJson &json)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGetJSON(getStr(source, addr), json);
         delAddr(addr);
         return ret;
@@ -513,20 +513,20 @@ private:
     void *newP(size_t len);
 
     template <typename T>
-    auto getStr(const T &val, uint32_t &addr) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, const char *>::type
+    auto getStr(const T &val, uintptr_t &addr) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, const char *>::type
     {
         addr = 0;
         return val.c_str();
     }
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, const char *>::type
     {
         return getStr(reinterpret_cast<PGM_P>(val), addr);
     }
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_const_chars<T>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_const_chars<T>::value, const char *>::type
     {
         int len = strlen_P((PGM_P)val) + 1;
         char *out = (char *)newP(len);
@@ -537,7 +537,7 @@ private:
         return (const char *)out;
     }
 
-    void delAddr(uint32_t addr)
+    void delAddr(uintptr_t addr)
     {
         if (addr > 0)
         {
@@ -578,12 +578,10 @@ private:
         int stopIndex = 0;
     };
 
+    // The node is owned by the root tree, the iterator is reset when the tree was changed
     struct iterator_result_t
     {
-        uint16_t ofs1 = 0;
-        uint8_t len1 = 0;
-        uint8_t ofs2 = 0;
-        uint16_t len2 = 0;
+        MB_JSON *node = NULL;
         uint8_t type = 0;
         int16_t depth = -1;
     };
@@ -591,8 +589,6 @@ private:
     struct iterator_data_t
     {
         MB_VECTOR<struct iterator_result_t> result;
-        int buf_offset = 0;
-        size_t buf_size = 0;
         int depth = -1;
         int _depth = 0;
         MB_JSON *parent = NULL;
@@ -627,7 +623,7 @@ private:
     void replace(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *item);
     size_t mIteratorBegin(MB_JSON *parent);
     size_t mIteratorBegin(MB_JSON *parent, MB_VECTOR<MB_String> *keys);
-    void mCollectIterator(MB_JSON *e, int type, int &arrIndex);
+    void mCollectIterator(MB_JSON *e, int type);
     void mIterate(MB_JSON *parent, int &arrIndex);
     int mIteratorGet(size_t index, int &type, String &key, String &value);
     struct fb_js_iterator_value_t mValueAt(size_t index);
@@ -701,7 +697,7 @@ protected:
     MB_String buf;
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_bool<T>::value || is_num_int<T>::value || std::is_same<T, float>::value || std::is_same<T, double>::value || std::is_same<T, long double>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_bool<T>::value || is_num_int<T>::value || std::is_same<T, float>::value || std::is_same<T, double>::value || std::is_same<T, long double>::value, const char *>::type
     {
         MB_String t;
 
@@ -722,20 +718,20 @@ protected:
     }
 
     template <typename T>
-    auto getStr(const T &val, uint32_t &addr) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, const char *>::type
+    auto getStr(const T &val, uintptr_t &addr) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value || std::is_same<T, StringSumHelper>::value, const char *>::type
     {
         addr = 0;
         return val.c_str();
     }
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, const char *>::type
     {
         return getStr(reinterpret_cast<PGM_P>(val), addr);
     }
 
     template <typename T>
-    auto getStr(T val, uint32_t &addr) -> typename std::enable_if<is_const_chars<T>::value, const char *>::type
+    auto getStr(T val, uintptr_t &addr) -> typename std::enable_if<is_const_chars<T>::value, const char *>::type
     {
         int len = strlen_P((PGM_P)val) + 1;
         char *out = (char *)newP(len);
@@ -854,7 +850,7 @@ protected:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            free(MB_Heap::untrack(*p));
             *p = 0;
         }
     }
@@ -877,9 +873,9 @@ protected:
         size_t newLen = getReservedLen(len);
 #if defined(BOARD_HAS_PSRAM)
         if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
+            p = (void *)ps_malloc(newLen + MB_HEAP_HEADER_SIZE);
         else
-            p = (void *)malloc(newLen);
+            p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
         if (!p)
             return NULL;
 
@@ -889,7 +885,7 @@ protected:
         ESP.setExternalHeap();
 #endif
 
-        p = (void *)malloc(newLen);
+        p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
         bool nn = p ? true : false;
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
@@ -900,6 +896,7 @@ protected:
             return NULL;
 
 #endif
+        p = MB_Heap::track(p, newLen, mb_heap_scope_json);
         memset(p, 0, newLen);
         return p;
     }
@@ -1745,7 +1742,7 @@ public:
     template <typename T>
     bool setJsonArrayData(T data)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = setRaw(getStr(data, addr));
         delAddr(addr);
         return ret;
@@ -1854,7 +1851,7 @@ public:
     template <typename T>
     bool isMember(T path)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGet(root, NULL, getStr(path, addr));
         delAddr(addr);
         return ret;
@@ -1863,6 +1860,8 @@ public:
     /**
      * Parse and collect all node/array elements in FirebaseJsonArray object.
      * @return number of child/array elements in FirebaseJson object.
+     *
+     * The collected elements are reset when the array was changed.
      */
     size_t iteratorBegin(const char *data = NULL) { return mIteratorBegin(root); }
 
@@ -2012,7 +2011,7 @@ private:
     template <typename T>
     auto dataGetHandler(T arg, FirebaseJsonData &result, bool prettify) -> typename std::enable_if<is_string<T>::value, bool>::type
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGet(root, &result, getStr(arg, addr), prettify);
         delAddr(addr);
         return ret;
@@ -2027,7 +2026,7 @@ private:
     template <typename T>
     auto dataRemoveHandler(T arg) -> typename std::enable_if<is_string<T>::value, bool>::type
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mRemove(getStr(arg, addr));
         delAddr(addr);
         return ret;
@@ -2095,7 +2094,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         nAdd(MB_JSON_CreateString(getStr(arg, addr)));
         delAddr(addr);
         return *this;
@@ -2110,7 +2109,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateNull());
         delAddr(addr);
     }
@@ -2130,7 +2129,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateBool(arg2));
         delAddr(addr);
     }
@@ -2149,7 +2148,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, -1)));
         delAddr(addr);
     }
@@ -2168,7 +2167,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, floatDigits)));
         delAddr(addr);
     }
@@ -2187,7 +2186,7 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, doubleDigits)));
         delAddr(addr);
     }
@@ -2206,8 +2205,8 @@ private:
 
         root_type = Root_Type_JSONArray;
 
-        uint32_t addr1 = 0;
-        uint32_t addr2 = 0;
+        uintptr_t addr1 = 0;
+        uintptr_t addr2 = 0;
         mSet(getStr(arg1, addr1), MB_JSON_CreateString(getStr(arg2, addr2)));
         delAddr(addr1);
         delAddr(addr2);
@@ -2216,7 +2215,7 @@ private:
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename std::enable_if<(is_num_int<T1>::value || is_num_float<T1>::value || is_bool<T1>::value) && is_string<T2>::value>::type
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSetIdx(arg1, MB_JSON_CreateString(getStr(arg2, addr)));
         delAddr(addr);
     }
@@ -2230,7 +2229,7 @@ private:
         root_type = Root_Type_JSONArray;
 
         MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), e);
         delAddr(addr);
     }
@@ -2251,7 +2250,7 @@ private:
         root_type = Root_Type_JSONArray;
 
         MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(arg1, addr), e);
         delAddr(addr);
     }
@@ -2263,7 +2262,7 @@ private:
         mSetIdx(arg1, e);
     }
 
-    void delAddr(uint32_t addr)
+    void delAddr(uintptr_t addr)
     {
         if (addr > 0)
         {
@@ -2316,7 +2315,7 @@ public:
     template <typename T>
     bool setJsonData(T data)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = setRaw(getStr(data, addr));
         delAddr(addr);
         return ret;
@@ -2366,7 +2365,7 @@ public:
     template <typename T>
     FirebaseJson &add(T key)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         nAdd(getStr(key, addr), NULL);
         delAddr(addr);
         return *this;
@@ -2382,7 +2381,7 @@ public:
     template <typename T1, typename T2>
     FirebaseJson &add(T1 key, T2 value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_add);
         delAddr(addr);
         return *this;
@@ -2391,7 +2390,7 @@ public:
     template <typename T>
     FirebaseJson &add(T key, FirebaseJson &value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_add);
         delAddr(addr);
         return *this;
@@ -2400,7 +2399,7 @@ public:
     template <typename T>
     FirebaseJson &add(T key, FirebaseJsonArray &value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_add);
         delAddr(addr);
         return *this;
@@ -2461,7 +2460,7 @@ public:
     template <typename T>
     bool get(FirebaseJsonData &result, T path, bool prettify = false)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGet(root, &result, getStr(path, addr), prettify);
         delAddr(addr);
         return ret;
@@ -2476,7 +2475,7 @@ public:
     template <typename T>
     bool isMember(T path)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mGet(root, NULL, getStr(path, addr));
         delAddr(addr);
         return ret;
@@ -2486,6 +2485,8 @@ public:
      * Parse and collect all node/array elements in FirebaseJson object.
      *
      * @return number of child/array elements in FirebaseJson object.
+     *
+     * The collected elements are reset when the object was changed.
      */
     size_t iteratorBegin() { return mIteratorBegin(root); }
 
@@ -2531,7 +2532,7 @@ public:
     template <typename T>
     void set(T key)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         mSet(getStr(key, addr), NULL);
         delAddr(addr);
     }
@@ -2552,7 +2553,7 @@ public:
     template <typename T1, typename T2>
     FirebaseJson &set(T1 key, T2 value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_set);
         delAddr(addr);
         return *this;
@@ -2561,7 +2562,7 @@ public:
     template <typename T>
     FirebaseJson &set(T key, FirebaseJson &value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_set);
         delAddr(addr);
         return *this;
@@ -2570,7 +2571,7 @@ public:
     template <typename T>
     FirebaseJson &set(T key, FirebaseJsonArray &value)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         dataHandler(getStr(key, addr), value, fb_json_func_type_set);
         delAddr(addr);
         return *this;
@@ -2585,7 +2586,7 @@ public:
     template <typename T>
     bool remove(T path)
     {
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         bool ret = mRemove(getStr(path, addr));
         delAddr(addr);
         return ret;
@@ -2639,7 +2640,7 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr), MB_JSON_CreateBool(arg2));
         else if (type == fb_json_func_type_set)
@@ -2656,7 +2657,7 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, -1)));
         else if (type == fb_json_func_type_set)
@@ -2673,7 +2674,7 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, floatDigits)));
         else if (type == fb_json_func_type_set)
@@ -2690,7 +2691,7 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr), MB_JSON_CreateRaw(num2Str(arg2, doubleDigits)));
         else if (type == fb_json_func_type_set)
@@ -2707,8 +2708,8 @@ private:
 
         root_type = Root_Type_JSON;
 
-        uint32_t addr1 = 0;
-        uint32_t addr2 = 0;
+        uintptr_t addr1 = 0;
+        uintptr_t addr2 = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg1, addr1), MB_JSON_CreateString(getStr(arg2, addr2)));
         else if (type == fb_json_func_type_set)
@@ -2727,7 +2728,7 @@ private:
         root_type = Root_Type_JSON;
 
         MB_JSON *e = MB_JSON_Duplicate(json.root, true);
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg, addr), e);
         else if (type == fb_json_func_type_set)
@@ -2745,7 +2746,7 @@ private:
         root_type = Root_Type_JSON;
 
         MB_JSON *e = MB_JSON_Duplicate(arr.root, true);
-        uint32_t addr = 0;
+        uintptr_t addr = 0;
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg, addr), e);
         else if (type == fb_json_func_type_set)
@@ -2754,7 +2755,7 @@ private:
         return *this;
     }
 
-    void delAddr(uint32_t addr)
+    void delAddr(uintptr_t addr)
     {
         if (addr > 0)
         {
@@ -0,0 +1,193 @@
+
+/**
+ * Mobizt's heap accounting for the SRAM/PSRAM allocations, version 1.0.0
+ *
+ * Created October 18, 2026
+ *
+ * The allocations from MB_String, MB_FS, FirebaseJson and MB_JSON hooks are counted when MB_HEAP_ACCOUNTING
+ * was defined in the compiler build flags (it should be applied to all compilation units).
+ *
+ * Every counted block is prefixed with the header that keeps its size and scope, then the live bytes,
+ * the peak live bytes and the number of allocations can be tracked per scope.
+ * The block is owned by its allocation site, only the pointer from track is passed to untrack, raw and retrack.
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MB_Heap_H
+#define MB_Heap_H
+
+#include <Arduino.h>
+
+#if defined(MB_HEAP_ACCOUNTING)
+// Keep 8 bytes alignment of the returned block
+#define MB_HEAP_HEADER_SIZE 8
+#else
+#define MB_HEAP_HEADER_SIZE 0
+#endif
+
+enum mb_heap_scope
+{
+    mb_heap_scope_other,
+    mb_heap_scope_auth,
+    mb_heap_scope_request,
+    mb_heap_scope_response,
+    mb_heap_scope_json,
+    mb_heap_scope_total,
+    mb_heap_scope_max
+};
+
+typedef struct mb_heap_stats_t
+{
+    // The bytes that are currently allocated.
+    uint32_t live = 0;
+    // The highest live bytes since the last reset.
+    uint32_t peak = 0;
+    // The number of allocations since the last reset.
+    uint32_t count = 0;
+} MB_HeapStats;
+
+class MB_Heap
+{
+public:
+    static MB_HeapStats *stats()
+    {
+        static MB_HeapStats s[mb_heap_scope_max];
+        return s;
+    }
+
+    // The scope that the allocations are counted to, the JSON allocations are always counted to mb_heap_scope_json.
+    static uint8_t &scope()
+    {
+        static uint8_t s = mb_heap_scope_other;
+        return s;
+    }
+
+    // Reset the peaks to the current live bytes and clear the allocation counts.
+    static void reset()
+    {
+        for (int i = 0; i < mb_heap_scope_max; i++)
+        {
+            stats()[i].peak = stats()[i].live;
+            stats()[i].count = 0;
+        }
+    }
+
+    // Get the raw block (header) of the pointer that was returned from track.
+    static void *raw(void *p)
+    {
+#if defined(MB_HEAP_ACCOUNTING)
+        if (p)
+            return (uint8_t *)p - MB_HEAP_HEADER_SIZE;
+#endif
+        return p;
+    }
+
+    // Count the raw block that was allocated with len + MB_HEAP_HEADER_SIZE bytes and get the usable pointer.
+    static void *track(void *raw, size_t len, uint8_t scope)
+    {
+#if defined(MB_HEAP_ACCOUNTING)
+        if (!raw)
+            return NULL;
+
+        block_header_t *h = (block_header_t *)raw;
+        h->len = len;
+        h->scope = scope;
+        add(scope, len);
+        return (uint8_t *)raw + MB_HEAP_HEADER_SIZE;
+#else
+        return raw;
+#endif
+    }
+
+    // Uncount the pointer that was returned from track and get its raw block to free.
+    // The pointer that was not allocated with the header (e.g. new or malloc) should never be passed.
+    static void *untrack(void *p)
+    {
+#if defined(MB_HEAP_ACCOUNTING)
+        if (!p)
+            return p;
+
+        block_header_t *h = header(p);
+        sub(h->scope, h->len);
+        return (uint8_t *)p - MB_HEAP_HEADER_SIZE;
+#else
+        return p;
+#endif
+    }
+
+    // Recount the raw block that was reallocated from the raw block of old pointer (NULL for the new block).
+    static void *retrack(void *old, void *raw, size_t len, uint8_t scope)
+    {
+#if defined(MB_HEAP_ACCOUNTING)
+        if (!raw)
+            return NULL;
+
+        // The header was moved with the content
+        block_header_t *h = (block_header_t *)raw;
+        if (old)
+            sub(h->scope, h->len);
+
+        return track(raw, len, scope);
+#else
+        (void)old;
+        return raw;
+#endif
+    }
+
+private:
+#if defined(MB_HEAP_ACCOUNTING)
+    struct block_header_t
+    {
+        uint32_t len;
+        uint8_t scope;
+        uint8_t reserved[3];
+    };
+
+    static block_header_t *header(void *p) { return (block_header_t *)((uint8_t *)p - MB_HEAP_HEADER_SIZE); }
+
+    static void add(uint8_t scope, size_t len)
+    {
+        uint8_t idx[2] = {scope < mb_heap_scope_total ? scope : (uint8_t)mb_heap_scope_other, mb_heap_scope_total};
+        for (int i = 0; i < 2; i++)
+        {
+            MB_HeapStats &s = stats()[idx[i]];
+            s.live += len;
+            s.count++;
+            if (s.live > s.peak)
+                s.peak = s.live;
+        }
+    }
+
+    static void sub(uint8_t scope, size_t len)
+    {
+        uint8_t idx[2] = {scope < mb_heap_scope_total ? scope : (uint8_t)mb_heap_scope_other, mb_heap_scope_total};
+        for (int i = 0; i < 2; i++)
+        {
+            MB_HeapStats &s = stats()[idx[i]];
+            s.live = s.live > len ? s.live - len : 0;
+        }
+    }
+#endif
+};
+
+#endif
@@ -55,6 +55,16 @@
 #include <limits.h>
 #include <ctype.h>
 #include <float.h>
+#include <stdint.h>
+
+#if defined(ESP8266)
+#include <pgmspace.h>
+#define MB_JSON_PROGMEM PROGMEM
+#define MB_JSON_memcpy_P memcpy_P
+#else
+#define MB_JSON_PROGMEM
+#define MB_JSON_memcpy_P memcpy
+#endif
 
 #ifdef ENABLE_LOCALES
 #include <locale.h>
@@ -570,16 +580,297 @@ static MB_JSON_bool MB_JSON_compare_double(double a, double b)
     return (fabs(a - b) <= maxVal * DBL_EPSILON);
 }
 
+/* The shortest round-trip double to string conversion (Grisu2 by Florian Loitsch, after the Milo Yip's implementation) */
+
+typedef struct
+{
+    uint64_t f;
+    int e;
+} MB_JSON_diyfp;
+
+#define MB_JSON_DP_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define MB_JSON_DP_HIDDEN_BIT 0x0010000000000000ULL
+#define MB_JSON_DP_EXPONENT_BIAS (0x3FF + 52)
+
+/* The normalized 10^k, k = -348 + 8i */
+static const uint64_t MB_JSON_cached_powers_f[] MB_JSON_PROGMEM = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+    0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+    0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+    0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+    0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+    0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+    0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+    0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+    0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+    0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+    0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+    0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+    0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+    0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+    0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const int16_t MB_JSON_cached_powers_e[] MB_JSON_PROGMEM = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066
+};
+
+static uint64_t MB_JSON_cached_power_f(unsigned index)
+{
+    uint64_t f;
+    MB_JSON_memcpy_P(&f, &MB_JSON_cached_powers_f[index], sizeof(f));
+    return f;
+}
+
+static int MB_JSON_cached_power_e(unsigned index)
+{
+    int16_t e;
+    MB_JSON_memcpy_P(&e, &MB_JSON_cached_powers_e[index], sizeof(e));
+    return e;
+}
+
+static MB_JSON_diyfp MB_JSON_diyfp_make(uint64_t f, int e)
+{
+    MB_JSON_diyfp r;
+    r.f = f;
+    r.e = e;
+    return r;
+}
+
+static MB_JSON_diyfp MB_JSON_diyfp_mul(MB_JSON_diyfp x, MB_JSON_diyfp y)
+{
+    const uint64_t M32 = 0xFFFFFFFFULL;
+    uint64_t a = x.f >> 32, b = x.f & M32, c = y.f >> 32, d = y.f & M32;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+    tmp += 1ULL << 31; /* round */
+    return MB_JSON_diyfp_make(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+static MB_JSON_diyfp MB_JSON_diyfp_normalize(MB_JSON_diyfp x)
+{
+    while (!(x.f & 0x8000000000000000ULL))
+    {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+static void MB_JSON_grisu_round(char *buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+    {
+        buffer[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static void MB_JSON_digit_gen(MB_JSON_diyfp W, MB_JSON_diyfp Mp, uint64_t delta, char *buffer, int *len, int *K)
+{
+    static const uint64_t pow10[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+                                     10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+                                     1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL};
+    MB_JSON_diyfp one = MB_JSON_diyfp_make(1ULL << -Mp.e, Mp.e);
+    uint64_t wp_w = Mp.f - W.f;
+    uint32_t p1 = (uint32_t)(Mp.f >> -one.e);
+    uint64_t p2 = Mp.f & (one.f - 1);
+    int kappa = 1;
+    uint32_t div = 10;
+
+    while (kappa < 10 && p1 >= div)
+    {
+        kappa++;
+        div *= 10;
+    }
+
+    *len = 0;
+    while (kappa > 0)
+    {
+        uint32_t d = (uint32_t)(p1 / pow10[kappa - 1]);
+        uint64_t tmp;
+        p1 %= (uint32_t)pow10[kappa - 1];
+        if (d || *len)
+            buffer[(*len)++] = (char)('0' + d);
+        kappa--;
+        tmp = ((uint64_t)p1 << -one.e) + p2;
+        if (tmp <= delta)
+        {
+            *K += kappa;
+            MB_JSON_grisu_round(buffer, *len, delta, tmp, pow10[kappa] << -one.e, wp_w);
+            return;
+        }
+    }
+
+    for (;;)
+    {
+        char d;
+        int index;
+        p2 *= 10;
+        delta *= 10;
+        d = (char)(p2 >> -one.e);
+        if (d || *len)
+            buffer[(*len)++] = (char)('0' + d);
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta)
+        {
+            *K += kappa;
+            index = -kappa;
+            MB_JSON_grisu_round(buffer, *len, delta, p2, one.f, wp_w * (index < 20 ? pow10[index] : 0));
+            return;
+        }
+    }
+}
+
+/* Get the shortest digits of the positive value, value = digits * 10^K */
+static void MB_JSON_grisu2(double value, char *buffer, int *len, int *K)
+{
+    MB_JSON_diyfp v, w_p, w_m, c_mk, W, Wp, Wm;
+    uint64_t u;
+    int biased_e;
+    double dk;
+    int k;
+    unsigned index;
+
+    memcpy(&u, &value, sizeof(u));
+    biased_e = (int)((u >> 52) & 0x7FF);
+    if (biased_e != 0)
+        v = MB_JSON_diyfp_make((u & MB_JSON_DP_SIGNIFICAND_MASK) + MB_JSON_DP_HIDDEN_BIT, biased_e - MB_JSON_DP_EXPONENT_BIAS);
+    else
+        v = MB_JSON_diyfp_make(u & MB_JSON_DP_SIGNIFICAND_MASK, 1 - MB_JSON_DP_EXPONENT_BIAS);
+
+    /* The normalized boundaries m+ and m- */
+    w_p = MB_JSON_diyfp_make((v.f << 1) + 1, v.e - 1);
+    while (!(w_p.f & (MB_JSON_DP_HIDDEN_BIT << 1)))
+    {
+        w_p.f <<= 1;
+        w_p.e--;
+    }
+    w_p.f <<= 64 - 52 - 2;
+    w_p.e -= 64 - 52 - 2;
+
+    if (v.f == MB_JSON_DP_HIDDEN_BIT)
+        w_m = MB_JSON_diyfp_make((v.f << 2) - 1, v.e - 2);
+    else
+        w_m = MB_JSON_diyfp_make((v.f << 1) - 1, v.e - 1);
+    w_m.f <<= w_m.e - w_p.e;
+    w_m.e = w_p.e;
+
+    /* The cached power c_mk = 10^-K */
+    dk = (-61 - w_p.e) * 0.30102999566398114 + 347;
+    k = (int)dk;
+    if (dk - k > 0.0)
+        k++;
+    index = (unsigned)((k >> 3) + 1);
+    *K = -(-348 + (int)(index << 3));
+    c_mk = MB_JSON_diyfp_make(MB_JSON_cached_power_f(index), MB_JSON_cached_power_e(index));
+
+    W = MB_JSON_diyfp_mul(MB_JSON_diyfp_normalize(v), c_mk);
+    Wp = MB_JSON_diyfp_mul(w_p, c_mk);
+    Wm = MB_JSON_diyfp_mul(w_m, c_mk);
+    Wm.f++;
+    Wp.f--;
+    MB_JSON_digit_gen(W, Wp, Wp.f - Wm.f, buffer, len, K);
+}
+
+/* Print the finite number in the %.17g style notation with the shortest round-trip digits, return the length */
+static int MB_JSON_dtoa(double d, char *out)
+{
+    char digits[24];
+    int len = 0, K = 0, kk = 0, i = 0, n = 0;
+
+    if (d < 0)
+    {
+        out[n++] = '-';
+        d = -d;
+    }
+
+    /* The integers are the most common numbers */
+    if (d < 1e15 && d == (double)(uint64_t)d)
+    {
+        uint64_t v = (uint64_t)d;
+        char *p = digits + sizeof(digits);
+        do
+        {
+            *--p = (char)('0' + v % 10);
+            v /= 10;
+        } while (v);
+        while (p < digits + sizeof(digits))
+            out[n++] = *p++;
+        out[n] = '\0';
+        return n;
+    }
+
+    MB_JSON_grisu2(d, digits, &len, &K);
+    kk = len + K; /* 10^(kk-1) <= d < 10^kk */
+
+    if (kk > -4 && kk <= 15)
+    {
+        if (kk <= 0)
+        {
+            out[n++] = '0';
+            out[n++] = '.';
+            for (i = kk; i < 0; i++)
+                out[n++] = '0';
+            for (i = 0; i < len; i++)
+                out[n++] = digits[i];
+        }
+        else
+        {
+            for (i = 0; i < len || i < kk; i++)
+            {
+                if (i == kk)
+                    out[n++] = '.';
+                out[n++] = i < len ? digits[i] : '0';
+            }
+        }
+    }
+    else
+    {
+        int e = kk - 1;
+        out[n++] = digits[0];
+        if (len > 1)
+        {
+            out[n++] = '.';
+            for (i = 1; i < len; i++)
+                out[n++] = digits[i];
+        }
+        out[n++] = 'e';
+        out[n++] = e < 0 ? '-' : '+';
+        if (e < 0)
+            e = -e;
+        if (e >= 100)
+            out[n++] = (char)('0' + e / 100);
+        out[n++] = (char)('0' + e / 10 % 10);
+        out[n++] = (char)('0' + e % 10);
+    }
+
+    out[n] = '\0';
+    return n;
+}
+
 /* Render the number nicely from the given item into a string. */
 static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
 {
     unsigned char *output_pointer = NULL;
     double d = item->valuedouble;
     int length = 0;
-    size_t i = 0;
-    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
-    unsigned char decimal_point = MB_JSON_get_decimal_point();
-    double test = 0.0;
+    char number_buffer[26] = {0}; /* temporary buffer to print the number into */
 
     if (output_buffer == NULL)
     {
@@ -589,25 +880,19 @@ static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_prin
     /* This checks for NaN and Infinity */
     if (isnan(d) || isinf(d))
     {
-        length = sprintf((char *)number_buffer, "null");
+        memcpy(number_buffer, "null", 5);
+        length = 4;
     }
-    else
+    else if (d == 0)
     {
-        /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
-        length = sprintf((char *)number_buffer, "%1.15g", d);
-
-        /* Check whether the original double can be recovered */
-        if ((sscanf((char *)number_buffer, "%lg", &test) != 1) || !MB_JSON_compare_double((double)test, d))
-        {
-            /* If not, print with 17 decimal places of precision */
-            length = sprintf((char *)number_buffer, "%1.17g", d);
-        }
+        /* keep the sign of negative zero */
+        length = signbit(d) ? 2 : 1;
+        memcpy(number_buffer, signbit(d) ? "-0" : "0", (size_t)length + 1);
     }
-
-    /* sprintf failed or buffer overrun occurred */
-    if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
+    else
     {
-        return false;
+        /* the shortest digits that read back to the same double, no locale dependent decimal point */
+        length = MB_JSON_dtoa(d, number_buffer);
     }
 
     /* reserve appropriate space in the output */
@@ -617,20 +902,7 @@ static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_prin
         return false;
     }
 
-    /* copy the printed number to the output and replace locale
-     * dependent decimal point with '.' */
-    for (i = 0; i < ((size_t)length); i++)
-    {
-        if (number_buffer[i] == decimal_point)
-        {
-            output_pointer[i] = '.';
-            continue;
-        }
-
-        output_pointer[i] = number_buffer[i];
-    }
-    output_pointer[i] = '\0';
-
+    memcpy(output_pointer, number_buffer, (size_t)length + 1);
     output_buffer->offset += (size_t)length;
 
     return true;
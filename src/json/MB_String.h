@@ -81,6 +81,7 @@
 #define MB_String_H
 
 #include <Arduino.h>
+#include "MB_Heap.h"
 #if !defined(__AVR__)
 #include <string>
 #include <strings.h>
@@ -97,6 +98,24 @@
 #define ESP8266_USE_EXTERNAL_HEAP
 #endif
 
+// The inline buffer size for the short strings which need no heap allocation, 0 to disable.
+#if !defined(MB_STRING_SSO_SIZE)
+#if defined(ESP8266_USE_EXTERNAL_HEAP)
+#define MB_STRING_SSO_SIZE 0
+#else
+#define MB_STRING_SSO_SIZE 16
+#endif
+#endif
+
+// The maximum size in bytes that the buffer grows ahead of the requested length.
+#if !defined(MB_STRING_GROWTH_CAP)
+#define MB_STRING_GROWTH_CAP 1024
+#endif
+
+#if !defined(MB_STRING_PSRAM_GROWTH_CAP)
+#define MB_STRING_PSRAM_GROWTH_CAP 16384
+#endif
+
 #if defined(ESP8266) || defined(ESP32)
 #define MBSTRING_FLASH_MCR FPSTR
 #elif defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT)
@@ -140,7 +159,7 @@ namespace mb_string
     {
 
     public:
-        mb_string_ptr_t(uint32_t addr = 0, mb_string_sub_type type = mb_string_sub_type_cstring, int precision = -1, const StringSumHelper *s = nullptr)
+        mb_string_ptr_t(uintptr_t addr = 0, mb_string_sub_type type = mb_string_sub_type_cstring, int precision = -1, const StringSumHelper *s = nullptr)
         {
             _addr = addr;
             _type = type;
@@ -149,13 +168,13 @@ namespace mb_string
         }
         int precision() { return _precision; }
         mb_string_sub_type type() { return _type; }
-        uint32_t address() { return _addr; }
+        uintptr_t address() { return _addr; }
         const StringSumHelper *stringsumhelper() { return _ssh; }
 
     private:
         mb_string_sub_type _type = mb_string_sub_type_none;
         int _precision = -1;
-        uint32_t _addr = 0;
+        uintptr_t _addr = 0;
         const StringSumHelper *_ssh = nullptr;
 
     } MB_StringPtr;
@@ -382,17 +401,17 @@ namespace mb_string
     };
 
     template <typename T>
-    uint32_t toAddr(T &v) { return reinterpret_cast<uint32_t>(&v); }
+    uintptr_t toAddr(T &v) { return reinterpret_cast<uintptr_t>(&v); }
 
 #if defined(__AVR__)
     template <typename T>
-    T addrTo(int address)
+    T addrTo(uintptr_t address)
     {
         return reinterpret_cast<T>(address);
     }
 #else
     template <typename T>
-    auto addrTo(int address) -> typename std::enable_if<!std::is_same<T, nullptr_t>::value, T>::type
+    auto addrTo(uintptr_t address) -> typename std::enable_if<!std::is_same<T, nullptr_t>::value, T>::type
     {
         return reinterpret_cast<T>(address);
     }
@@ -450,25 +469,25 @@ namespace mb_string
     template <typename T>
     auto toStringPtr(const T &val) -> typename std::enable_if<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value, MB_StringPtr>::type
     {
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val));
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val));
     }
 
     template <typename T>
     auto toStringPtr(const T &val) -> typename std::enable_if<std::is_same<T, StringSumHelper>::value, MB_StringPtr>::type
     {
 #if defined(ESP8266)
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), -1);
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), -1);
 
 #else
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), -1, &val);
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), -1, &val);
 #endif
     }
 
     template <typename T>
-    auto toStringPtr(T val) -> typename std::enable_if<is_const_chars<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(val), getSubType(val)); }
+    auto toStringPtr(T val) -> typename std::enable_if<is_const_chars<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(val), getSubType(val)); }
 
     template <typename T>
-    auto toStringPtr(T &val) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(val), getSubType(val)); }
+    auto toStringPtr(T &val) -> typename std::enable_if<is_arduino_flash_string_helper<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(val), getSubType(val)); }
 
 #if !defined(__AVR__)
     template <typename T>
@@ -485,7 +504,7 @@ namespace mb_string
     }
 
     template <typename T>
-    auto toStringPtr(T &val, int precision = -1) -> typename std::enable_if<is_num_int<T>::value || is_num_float<T>::value || std::is_same<T, bool>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), precision); }
+    auto toStringPtr(T &val, int precision = -1) -> typename std::enable_if<is_num_int<T>::value || is_num_float<T>::value || std::is_same<T, bool>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), precision); }
 }
 
 using namespace mb_string;
@@ -601,45 +620,17 @@ public:
 
     MB_String(float value, unsigned char decimalPlaces = 2)
     {
-        reserve(33);
-        if (bufLen > 0)
-        {
-            char *v = toFloatStr(value, 0, decimalPlaces);
-            if (v)
-            {
-                strcpy(buf, v);
-                delP(&v);
-            }
-        }
+        appendFloat(value, 0, decimalPlaces);
     }
 
     MB_String(double value, unsigned char decimalPlaces = 3)
     {
-        reserve(33);
-
-        if (bufLen > 0)
-        {
-            char *v = toFloatStr(value, 1, decimalPlaces);
-            if (v)
-            {
-                strcpy(buf, v);
-                delP(&v);
-            }
-        }
+        appendFloat(value, 1, decimalPlaces);
     }
 
     MB_String(long double value, unsigned char decimalPlaces = 3)
     {
-        reserve(65);
-        if (bufLen > 0)
-        {
-            char *v = toFloatStr(value, 2, decimalPlaces);
-            if (v)
-            {
-                strcpy(buf, v);
-                delP(&v);
-            }
-        }
+        appendFloat(value, 2, decimalPlaces);
     }
 
 #if !defined(__AVR__)
@@ -889,31 +880,12 @@ public:
     template <typename T = int>
     auto appendNum(T value, int precision = 0) -> typename std::enable_if<is_num_int<T>::value || is_bool<T>::value, MB_String &>::type
     {
-        char *s = NULL;
-
         if (is_bool<T>::value)
-            s = boolStr(value);
-        else if (is_num_neg_int<T>::value)
-        {
-#if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT)
-            s = int32Str(value);
-#else
-            s = int64Str(value);
-#endif
-        }
-        else if (is_num_pos_int<T>::value)
-        {
-#if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT)
-            s = uint32Str(value);
-#else
-            s = uint64Str(value);
-#endif
-        }
-
-        if (s)
+            *this += value ? (const char *)MBSTRING_FLASH_MCR("true") : (const char *)MBSTRING_FLASH_MCR("false");
+        else
         {
-            *this += s;
-            delP(&s);
+            char t[24];
+            *this += intStr(t, value);
         }
 
         return (*this);
@@ -924,12 +896,7 @@ public:
         if (precision < 0)
             precision = 5;
 
-        char *s = toFloatStr(value, 0, precision);
-        if (s)
-        {
-            *this += s;
-            delP(&s);
-        }
+        appendFloat(value, 0, precision);
         return (*this);
     }
 
@@ -938,12 +905,7 @@ public:
         if (precision < 0)
             precision = 9;
 
-        char *s = toFloatStr(value, 1, precision);
-        if (s)
-        {
-            *this += s;
-            delP(&s);
-        }
+        appendFloat(value, 1, precision);
         return (*this);
     }
 
@@ -952,12 +914,7 @@ public:
         if (precision < 0)
             precision = 9;
 
-        char *s = toFloatStr(value, 2, precision);
-        if (s)
-        {
-            *this += s;
-            delP(&s);
-        }
+        appendFloat(value, 2, precision);
         return (*this);
     }
 
@@ -1096,7 +1053,38 @@ public:
 
     void swap(MB_String &rhs)
     {
-        rhs.clear();
+        if (this == &rhs)
+            return;
+
+        char *p = buf;
+        size_t len = bufLen;
+        buf = rhs.buf;
+        bufLen = rhs.bufLen;
+        rhs.buf = p;
+        rhs.bufLen = len;
+
+#if MB_STRING_SSO_SIZE > 0
+        // The inline content moves with its string and each string points to its own inline buffer
+        bool inl = rhs.buf == sso, rhsInl = buf == rhs.sso;
+
+        if (inl && rhsInl)
+        {
+            char t[MB_STRING_SSO_SIZE];
+            memcpy(t, sso, strlen(sso) + 1);
+            memcpy(sso, rhs.sso, strlen(rhs.sso) + 1);
+            memcpy(rhs.sso, t, strlen(t) + 1);
+        }
+        else if (rhsInl)
+            memcpy(sso, rhs.sso, strlen(rhs.sso) + 1);
+        else if (inl)
+            memcpy(rhs.sso, sso, strlen(sso) + 1);
+
+        if (rhsInl)
+            buf = sso;
+
+        if (inl)
+            rhs.buf = rhs.sso;
+#endif
     }
 
     void shrink_to_fit()
@@ -1211,9 +1199,9 @@ public:
             len = 4;
         ESP.setExternalHeap();
         if (buf)
-            buf = (char *)realloc(buf, len);
+            buf = (char *)MB_Heap::retrack(buf, realloc(MB_Heap::raw(buf), len + MB_HEAP_HEADER_SIZE), len, MB_Heap::scope());
         else
-            buf = (char *)malloc(len);
+            buf = (char *)MB_Heap::track(malloc(len + MB_HEAP_HEADER_SIZE), len, MB_Heap::scope());
         ESP.resetHeap();
 
         if (buf)
@@ -1470,63 +1458,114 @@ public:
     static const size_t npos = -1;
 
 private:
-#if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT)
-
-    char *int32Str(signed long value)
+    // Write the decimal digits backward into the 24 bytes buffer, return the first char
+    template <typename T>
+    char *intStr(char *t, T value)
     {
-        char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%ld"), value);
-        return t;
-    }
+        char *p = t + 23;
+        *p = '\0';
 
-    char *uint32Str(unsigned long value)
-    {
-        char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%lu"), value);
-        return t;
-    }
+        bool neg = is_num_neg_int<T>::value && (long long)value < 0;
+        unsigned long long v = neg ? 0ULL - (unsigned long long)value : (unsigned long long)value;
 
-#endif
+        // The 32-bit division is much cheaper than the 64-bit on 32-bit MCUs
+        while (v > 0xFFFFFFFFULL)
+        {
+            *--p = '0' + (char)(v % 10);
+            v /= 10;
+        }
 
-    char *int64Str(signed long long value)
-    {
-        char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%lld"), value);
-        return t;
-    }
+        uint32_t w = (uint32_t)v;
+        do
+        {
+            *--p = '0' + (char)(w % 10);
+            w /= 10;
+        } while (w);
 
-    char *uint64Str(unsigned long long value)
-    {
-        char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%llu"), value);
-        return t;
+        if (neg)
+            *--p = '-';
+
+        return p;
     }
 
-    char *boolStr(bool value)
+    // Write the value with fixed decimal places into the 48 bytes buffer without printf.
+    // Return false for the values that can't be scaled to integer exactly enough and the rounding ties
+    // which depend on the exact binary value, these are left to printf.
+    bool fixedStr(char *t, double value, int precision)
     {
-        char *t = (char *)newP(8);
-        value ? strcpy(t, (const char *)MBSTRING_FLASH_MCR("true")) : strcpy(t, (const char *)MBSTRING_FLASH_MCR("false"));
-        return t;
+        if (precision > 9 || isnan(value) || isinf(value))
+            return false;
+
+        double scale = 1;
+        for (int i = 0; i < precision; i++)
+            scale *= 10;
+
+        bool neg = signbit(value);
+        double scaled = (neg ? -value : value) * scale;
+        if (scaled >= 1e13)
+            return false;
+
+        uint64_t n = (uint64_t)scaled;
+        double frac = scaled - (double)n;
+        if (frac > 0.495 && frac < 0.505)
+            return false;
+
+        if (frac >= 0.5)
+            n++;
+
+        char *p = t + 47;
+        *p = '\0';
+        int digits = 0;
+        do
+        {
+            *--p = '0' + (char)(n % 10);
+            n /= 10;
+            if (++digits == precision)
+                *--p = '.';
+        } while (n || digits <= precision);
+
+        if (neg)
+            *--p = '-';
+
+        memmove(t, p, t + 48 - p);
+        trim(t);
+        return true;
     }
 
-    char *toFloatStr(long double value, int type, int precision)
+    void appendFloat(long double value, int type, int precision)
     {
-        int width = type == 0 ? 32 : 64;
+        char t[48];
 
-        char *t = (char *)newP(width);
+        if (type != 2 && fixedStr(t, (double)value, precision))
+        {
+            *this += t;
+            return;
+        }
 
-        if (t)
+        int len = type == 2 ? snprintf(t, sizeof(t), (const char *)MBSTRING_FLASH_MCR("%.*Lf"), precision, value)
+                            : snprintf(t, sizeof(t), (const char *)MBSTRING_FLASH_MCR("%.*f"), precision, (double)value);
+        if (len < 0)
+            return;
+
+        if (len < (int)sizeof(t))
         {
-            MB_String fmt = MBSTRING_FLASH_MCR("%.");
-            fmt += precision;
-            if (type == 2)
-                fmt += MBSTRING_FLASH_MCR("L");
-            fmt += MBSTRING_FLASH_MCR("f");
-            sprintf(t, fmt.c_str(), value);
             trim(t);
+            *this += t;
+            return;
         }
 
-        return t;
+        // The large values
+        char *s = (char *)newP(len + 1);
+        if (s)
+        {
+            if (type == 2)
+                sprintf(s, (const char *)MBSTRING_FLASH_MCR("%.*Lf"), precision, value);
+            else
+                sprintf(s, (const char *)MBSTRING_FLASH_MCR("%.*f"), precision, (double)value);
+            trim(s);
+            *this += s;
+            delP(&s);
+        }
     }
 
     char *nullStr()
@@ -1545,7 +1584,8 @@ private:
 
     void trim(char *s)
     {
-        if (!s)
+        // Only the zeros of the decimal places are removed
+        if (!s || !strchr(s, '.'))
             return;
         size_t i = strlen(s) - 1;
         while (s[i] == '0' && i > 0)
@@ -1569,9 +1609,9 @@ private:
         size_t newLen = getReservedLen(len);
 #if defined(BOARD_HAS_PSRAM)
         if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
+            p = (void *)ps_malloc(newLen + MB_HEAP_HEADER_SIZE);
         else
-            p = (void *)malloc(newLen);
+            p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
         if (!p)
             return NULL;
 
@@ -1581,7 +1621,7 @@ private:
         ESP.setExternalHeap();
 #endif
 
-        p = (void *)malloc(newLen);
+        p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
         bool nn = p ? true : false;
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
@@ -1592,6 +1632,7 @@ private:
             return NULL;
 
 #endif
+        p = MB_Heap::track(p, newLen, MB_Heap::scope());
         memset(p, 0, newLen);
         return p;
     }
@@ -1601,7 +1642,7 @@ private:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            free(MB_Heap::untrack(*p));
             *p = 0;
         }
     }
@@ -1676,6 +1717,14 @@ private:
 
     void move(MB_String &rhs)
     {
+        // The inline buffer can't be taken over
+        if (rhs.isInline())
+        {
+            copy(rhs.buf, strlen(rhs.buf));
+            rhs.clear();
+            return;
+        }
+
         if (buf)
         {
             if (bufLen >= rhs.bufLen)
@@ -1685,9 +1734,9 @@ private:
                 rhs.bufLen = 0;
                 return;
             }
-            else
+            else if (!isInline())
             {
-                free(buf);
+                free(MB_Heap::untrack(buf));
             }
         }
         buf = rhs.buf;
@@ -1700,13 +1749,34 @@ private:
 
         if (len == 0)
         {
-            if (buf)
-                free(buf);
+            if (buf && !isInline())
+                free(MB_Heap::untrack(buf));
             buf = NULL;
             bufLen = 0;
             return;
         }
 
+#if MB_STRING_SSO_SIZE > 0
+        if (len <= MB_STRING_SSO_SIZE && (!buf || shrink || isInline()))
+        {
+            if (!buf)
+                sso[0] = '\0';
+            else if (!isInline())
+            {
+                size_t slen = strlen(buf);
+                if (slen > MB_STRING_SSO_SIZE - 1)
+                    slen = MB_STRING_SSO_SIZE - 1;
+                memcpy(sso, buf, slen);
+                sso[slen] = '\0';
+                free(MB_Heap::untrack(buf));
+            }
+
+            buf = sso;
+            bufLen = MB_STRING_SSO_SIZE;
+            return;
+        }
+#endif
+
         if (len > bufLen || shrink)
         {
 
@@ -1714,17 +1784,17 @@ private:
             ESP.setExternalHeap();
 #endif
 
-            if (shrink || (bufLen > 0 && buf))
+            if (!isInline() && (shrink || (bufLen > 0 && buf)))
             {
                 int slen = length();
 
 #if defined(BOARD_HAS_PSRAM)
                 if (ESP.getPsramSize() > 0)
-                    buf = (char *)ps_realloc(buf, len);
+                    buf = (char *)MB_Heap::retrack(buf, ps_realloc(MB_Heap::raw(buf), len + MB_HEAP_HEADER_SIZE), len, MB_Heap::scope());
                 else
-                    buf = (char *)realloc(buf, len);
+                    buf = (char *)MB_Heap::retrack(buf, realloc(MB_Heap::raw(buf), len + MB_HEAP_HEADER_SIZE), len, MB_Heap::scope());
 #else
-                buf = (char *)realloc(buf, len);
+                buf = (char *)MB_Heap::retrack(buf, realloc(MB_Heap::raw(buf), len + MB_HEAP_HEADER_SIZE), len, MB_Heap::scope());
 #endif
                 if (buf)
                 {
@@ -1734,19 +1804,27 @@ private:
             }
             else
             {
+                char *p = NULL;
 #if defined(BOARD_HAS_PSRAM)
                 if (ESP.getPsramSize() > 0)
-                    buf = (char *)ps_malloc(len);
+                    p = (char *)MB_Heap::track(ps_malloc(len + MB_HEAP_HEADER_SIZE), len, MB_Heap::scope());
                 else
-                    buf = (char *)malloc(len);
+                    p = (char *)MB_Heap::track(malloc(len + MB_HEAP_HEADER_SIZE), len, MB_Heap::scope());
 #else
-                buf = (char *)malloc(len);
+                p = (char *)MB_Heap::track(malloc(len + MB_HEAP_HEADER_SIZE), len, MB_Heap::scope());
 #endif
-                if (buf)
+                if (p)
                 {
-                    buf[0] = '\0';
+                    // Move the short string out of the inline buffer
+                    if (isInline())
+                        memcpy(p, buf, strlen(buf) + 1);
+                    else
+                        p[0] = '\0';
+                    buf = p;
                     bufLen = len;
                 }
+                else if (!isInline())
+                    buf = NULL;
             }
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
@@ -1777,11 +1855,43 @@ private:
         if (shrink)
             allocate(newlen, true);
         else if (newlen > bufLen)
-            allocate(newlen, false);
+            allocate(growLen(newlen), false);
 
         return newlen <= bufLen;
     }
 
+    // The buffer length to grow to, the first allocation is exact and the later are 1.5 times
+    // of the current buffer but not more than the growth cap ahead of the requested length.
+    size_t growLen(size_t newlen) const
+    {
+        if (bufLen == 0)
+            return newlen;
+
+        size_t cap = MB_STRING_GROWTH_CAP;
+#if defined(BOARD_HAS_PSRAM)
+        if (ESP.getPsramSize() > 0)
+            cap = MB_STRING_PSRAM_GROWTH_CAP;
+#endif
+
+        size_t grow = bufLen / 2;
+        if (grow > cap)
+            grow = cap;
+
+        if (newlen >= bufLen + grow)
+            return newlen;
+
+        return (bufLen + grow + 3) / 4 * 4;
+    }
+
+    bool isInline() const
+    {
+#if MB_STRING_SSO_SIZE > 0
+        return buf == sso;
+#else
+        return false;
+#endif
+    }
+
     int strpos(const char *haystack, const char *needle, int offset) const
     {
         if (!haystack || !needle)
@@ -2023,6 +2133,9 @@ private:
 
     char *buf = NULL;
     size_t bufLen = 0;
+#if MB_STRING_SSO_SIZE > 0
+    char sso[MB_STRING_SSO_SIZE] = {0};
+#endif
 };
 
 inline MB_String operator+(const MB_String &lhs, const MB_String &rhs)
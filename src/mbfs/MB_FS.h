@@ -830,7 +830,7 @@ public:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            free(MB_Heap::untrack(*p));
             *p = 0;
         }
     }
@@ -843,9 +843,9 @@ public:
 #if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
 
         if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
+            p = (void *)ps_malloc(newLen + MB_HEAP_HEADER_SIZE);
         else
-            p = (void *)malloc(newLen);
+            p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
 
         if (!p)
             return NULL;
@@ -856,7 +856,7 @@ public:
         ESP.setExternalHeap();
 #endif
 
-        p = (void *)malloc(newLen);
+        p = (void *)malloc(newLen + MB_HEAP_HEADER_SIZE);
         bool nn = p ? true : false;
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
@@ -867,6 +867,7 @@ public:
             return NULL;
 
 #endif
+        p = MB_Heap::track(p, newLen, MB_Heap::scope());
         if (clear)
             memset(p, 0, newLen);
         return p;